@@ -1197,7 +1197,7 @@ def scf_wavefunction_factory(name, ref_wfn, reference, **kwargs):
         wfn._disp_functor = _disp_functor
 
     # Set the DF basis sets
-    if (("DF" in core.get_global_option("SCF_TYPE")) or
+    if (("DF" in core.get_global_option("SCF_TYPE")) or (core.get_global_option("SCF_TYPE") == "COSX") or
             (core.get_option("SCF", "DF_SCF_GUESS") and (core.get_global_option("SCF_TYPE") == "DIRECT"))):
         aux_basis = core.BasisSet.build(wfn.molecule(), "DF_BASIS_SCF",
                                         core.get_option("SCF", "DF_BASIS_SCF"),
@@ -2477,6 +2477,10 @@ def run_scf_gradient(name, **kwargs):
     if "dft_functional" in kwargs:
         dft_func = True
 
+    # Fail before the SCF rather than in the gradient builder
+    if core.get_global_option('SCF_TYPE') == 'COSX':
+        raise ValidationError("SCF gradients are not implemented for SCF_TYPE COSX. Use SCF_TYPE DF or DIRECT.")
+
     optstash = proc_util.scf_set_reference_local(name, is_dft=dft_func)
 
     # Bypass the scf call if a reference wavefunction is given
@@ -2555,15 +2559,19 @@ def run_scf_hessian(name, **kwargs):
     """
     optstash = proc_util.scf_set_reference_local(name)
 
+    # Fail before the SCF rather than in the Hessian builder
+    if core.get_global_option('SCF_TYPE') == 'COSX':
+        raise ValidationError("SCF Hessians are not implemented for SCF_TYPE COSX. Use SCF_TYPE DF or DIRECT.")
+
     # Bypass the scf call if a reference wavefunction is given
     ref_wfn = kwargs.get('ref_wfn', None)
     if ref_wfn is None:
         ref_wfn = run_scf(name, **kwargs)
 
-    badref = core.get_option('SCF', 'REFERENCE') in ['ROHF', 'CUHF', 'UKS']
+    badref = core.get_option('SCF', 'REFERENCE') in ['ROHF', 'CUHF']
     badint = core.get_global_option('SCF_TYPE') in [ 'CD', 'OUT_OF_CORE']
     if badref or badint:
-        raise ValidationError("Only RHF/UHF Hessians are currently implemented. SCF_TYPE either CD or OUT_OF_CORE not supported")
+        raise ValidationError("Only RHF/UHF/RKS/UKS Hessians are currently implemented. SCF_TYPE either CD or OUT_OF_CORE not supported")
 
     if hasattr(ref_wfn, "_disp_functor"):
         disp_hess = ref_wfn._disp_functor.compute_hessian(ref_wfn.molecule(), ref_wfn)
@@ -259,7 +259,10 @@ for key in functionals:
         procedures['energy']['td-' + key] = proc.run_tdscf_energy
 
     # Hessians
-    if not ssuper.is_gga(): # N.B. this eliminates both GGA and m-GGA, as the latter contains GGA terms
+    # LDA and GGA XC Hessians are analytic; m-GGA, VV10, LRC, and double hybrids fall back to finite differences.
+    # So do GGA hybrids, as the neglected grid weight derivatives are not yet validated for them on the default grid.
+    if not (ssuper.is_meta() or ssuper.is_x_lrc() or ssuper.is_c_hybrid() or ssuper.needs_vv10() or
+            (ssuper.is_gga() and ssuper.is_x_hybrid())):
         procedures['hessian'][key] = proc.run_scf_hessian
 
 # Integrate CFOUR with driver routines
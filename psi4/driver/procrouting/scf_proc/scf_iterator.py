@@ -287,6 +287,8 @@ def scf_iterate(self, e_conv=None, d_conv=None):
         self.clear_external_potentials()
 
         core.timer_on("HF: Form G")
+        if core.get_option('SCF', 'INCFOCK'):
+            self.jk().set_do_incfock_iter(True)
         self.form_G()
         core.timer_off("HF: Form G")
 
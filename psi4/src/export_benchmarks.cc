@@ -27,6 +27,7 @@
  */
 
 #include "psi4/libmints/benchmark.h"
+#include "psi4/dfocc/tensor_sort.h"
 #include "psi4/pybind11.h"
 
 namespace py = pybind11;
@@ -45,4 +46,6 @@ using namespace pybind11::literals;
           "Perform benchmark of common double floating point operations including most of cmath. For each routine run at least *min_time* [s].");
     m.def("benchmark_integrals", &psi::benchmark_integrals, "max_am"_a, "min_time"_a,
           "Perform benchmark of psi integrals (of libmints type). Benchmark integrals called from different centers. For up to *max_am* with each shell combination run at least *min_time* [s].");
+    m.def("benchmark_dfocc_sort", &psi::dfoccwave::benchmark_tensor_sort, "dim"_a, "min_time"_a,
+          "Perform benchmark of the DFOCC Tensor2d sort engine against per-element index-table sorts. Use *dim*^4 tensors with each sort run at least *min_time* [s].");
 }
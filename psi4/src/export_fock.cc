@@ -67,6 +67,8 @@ void export_fock(py::module &m) {
         .def("set_do_J", &JK::set_do_J)
         .def("set_do_K", &JK::set_do_K)
         .def("set_do_wK", &JK::set_do_wK)
+        .def("set_do_incfock_iter", &JK::set_do_incfock_iter,
+             "Mark the next compute() as an SCF iteration eligible for an incremental Fock build", "do_incfock_iter"_a)
         .def("set_omega", &JK::set_omega, "Dampening term for range separated DFT", "omega"_a)
         .def("get_omega", &JK::get_omega, "Dampening term for range separated DFT")
         .def("set_wcombine", &JK::set_wcombine, "Are Exchange terms in one Matrix", "wcombine"_a )
@@ -169,6 +171,8 @@ void export_fock(py::module &m) {
         .def("get_AO_core", &DFHelper::get_AO_core)
         .def("set_MO_core", &DFHelper::set_MO_core)
         .def("get_MO_core", &DFHelper::get_MO_core)
+        .def("set_io_backend", &DFHelper::set_io_backend, "Storage backend for disk tensors, STDIO or MMAP", "backend"_a)
+        .def("get_io_backend", &DFHelper::get_io_backend)
         .def("add_space", &DFHelper::add_space)
         .def("initialize", &DFHelper::initialize)
         .def("print_header", &DFHelper::print_header)
@@ -53,6 +53,19 @@ void export_psio(py::module &m) {
              "Delete all TOC entries after the given key. If a blank key is given, the entire TOC will be wiped",
              "unit"_a, "key"_a)
         .def("tocprint", &PSIO::tocprint, "Print the table of contents for the given unit")
+        .def("rw_bytes", &PSIO::rw_bytes, "Bytes read (wrt false) or written (wrt true) on a unit", "unit"_a,
+             "wrt"_a)
+        .def("rw_seconds", &PSIO::rw_seconds, "Seconds spent reading (wrt false) or writing (wrt true) a unit",
+             "unit"_a, "wrt"_a)
+        .def("print_rw_stats", &PSIO::print_rw_stats, "Print per-unit read/write volume and bandwidth")
+        .def("set_compression", &PSIO::set_compression,
+             "Keep a unit (-1 for all units) compressed in scratch while it is open, from its next open on",
+             "unit"_a, "compress"_a)
+        .def("set_memory_volume", &PSIO::set_memory_volume,
+             "Hold a unit (-1 for all units) in memory while it is open, from its next open on", "unit"_a, "memvol"_a)
+        .def("set_memory_volume_cap", &PSIO::set_memory_volume_cap,
+             "Bytes all memory volumes together may hold before further pages go to disk", "bytes"_a)
+        .def("get_memory_volume_cap", &PSIO::get_memory_volume_cap, "Current memory volume cap in bytes")
         .def("tocentry_exists", &PSIO::tocentry_exists,
              "Checks the TOC to see if a particular keyword exists there or not")
         .def("tocwrite", &PSIO::tocwrite, "Write the table of contents for passed file number")
@@ -44,6 +44,8 @@
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/wavefunction.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/writer_file_prefix.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -111,7 +113,8 @@ double CCEnergyWavefunction::compute_energy() {
         spaces.push_back(moinfo_.bvirtpi);
         spaces.push_back(moinfo_.bvir_sym);
         delete[] dpd_list[0];
-        dpd_list[0] = new DPD(0, moinfo_.nirreps, params_.memory, 0, cachefiles.data(), cachelist, nullptr, 4, spaces);
+        dpd_list[0] = new DPD(0, moinfo_.nirreps, params_.memory, params_.cachetype, cachefiles.data(), cachelist,
+                              nullptr, 4, spaces);
         dpd_set_default(0);
 
         if (params_.df) {
@@ -155,6 +158,10 @@ double CCEnergyWavefunction::compute_energy() {
         }
     }
 
+    /* The adaptive cache seeds its access frequencies from the previous run's trace, if any */
+    std::string cache_trace = get_writer_file_prefix(molecule_->name()) + ".dpdtrace";
+    if (params_.cachetype == 2) global_dpd_->file4_cache_trace_load(cache_trace);
+
     if ((params_.just_energy) || (params_.just_residuals)) {
         one_step();
         if (params_.ref == 2)
@@ -314,6 +321,9 @@ double CCEnergyWavefunction::compute_energy() {
     if (!done) {
         outfile->Printf("     ** Wave function not converged to %2.1e ** \n", params_.convergence);
 
+        if (params_.cachetype == 2 || params_.print > 1) global_dpd_->file4_cache_print_stats("outfile");
+        if (params_.cachetype == 2) global_dpd_->file4_cache_trace_save(cache_trace);
+
         if (params_.aobasis != "NONE" || params_.df) dpd_close(1);
         dpd_close(0);
         cleanup();
@@ -469,6 +479,9 @@ double CCEnergyWavefunction::compute_energy() {
 
     if (params_.brueckner) Process::environment.globals["BRUECKNER CONVERGED"] = rotate();
 
+    if (params_.cachetype == 2 || params_.print > 1) global_dpd_->file4_cache_print_stats("outfile");
+    if (params_.cachetype == 2) global_dpd_->file4_cache_trace_save(cache_trace);
+
     if (params_.aobasis != "NONE" || params_.df) dpd_close(1);
     dpd_close(0);
 
@@ -308,6 +308,7 @@ double CCLambdaWavefunction::compute_energy() {
 
     if (params.local) local_done();
 
+    if (params.print > 1) global_dpd_->file4_cache_print_stats("outfile");
     dpd_close(0);
 
     if (params.ref == 2)
@@ -49,6 +49,10 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
 #include "psi4/pybind11.h"
 
 #include "psi4/libciomr/libciomr.h"
@@ -82,6 +86,106 @@ extern int calc_orb_diff(int cnt, unsigned char *I, unsigned char *J, int *I_alp
 #define MIN0(a, b) (((a) < (b)) ? (a) : (b))
 #define MAX0(a, b) (((a) > (b)) ? (a) : (b))
 
+/*
+** In-core vector arena
+**
+** When enabled for a set of units (see CIvect::incore_init()), read()
+** and write() keep the buffers of those units in RAM instead of going
+** through PSIO.  The arena is shared by all CIvect objects because
+** several logical vectors live on one unit (e.g. Cvec and Cvec2 in
+** sem_iter).  When the arena is full, the least recently used buffers
+** -- the oldest Davidson subspace vectors -- are written to disk and
+** dropped, and later reads of them go back to the file.
+*/
+namespace {
+
+struct InCoreBuffer {
+    std::vector<double> data;
+    size_t stamp; /* last access, for LRU eviction */
+    bool dirty;   /* newer than the copy on disk */
+};
+
+struct InCoreArena {
+    std::set<int> units;
+    size_t max_bytes = 0;
+    size_t used_bytes = 0;
+    size_t clock = 0;
+    size_t nspilled = 0;
+    std::map<std::pair<int, int>, InCoreBuffer> bufs; /* keyed by (unit, buffer number) */
+};
+
+InCoreArena incore_arena;
+
+void incore_key(int buf, char *key) { sprintf(key, "buffer_ %d", buf); }
+
+/* write a buffer back to its unit if needed and drop it */
+std::map<std::pair<int, int>, InCoreBuffer>::iterator incore_drop(
+    std::map<std::pair<int, int>, InCoreBuffer>::iterator it, bool keep) {
+    char key[20];
+    InCoreBuffer &b = it->second;
+    if (keep && b.dirty && psio_open_check((size_t)it->first.first)) {
+        incore_key(it->first.second, key);
+        psio_write_entry((size_t)it->first.first, key, (char *)b.data.data(), b.data.size() * sizeof(double));
+    }
+    incore_arena.used_bytes -= b.data.size() * sizeof(double);
+    return incore_arena.bufs.erase(it);
+}
+
+/* the resident copy of (unit, buf), making room for it if necessary;
+   nullptr if the buffer cannot be held in core */
+InCoreBuffer *incore_slot(int unit, int buf, size_t len) {
+    auto it = incore_arena.bufs.find(std::make_pair(unit, buf));
+    if (it != incore_arena.bufs.end()) {
+        if (it->second.data.size() == len) return &(it->second);
+        incore_drop(it, true);
+    }
+
+    size_t bytes = len * sizeof(double);
+    if (bytes > incore_arena.max_bytes) return nullptr;
+    while (incore_arena.used_bytes + bytes > incore_arena.max_bytes) {
+        auto lru = incore_arena.bufs.begin();
+        for (auto b = incore_arena.bufs.begin(); b != incore_arena.bufs.end(); ++b)
+            if (b->second.stamp < lru->second.stamp) lru = b;
+        if (lru->second.dirty) incore_arena.nspilled++;
+        incore_drop(lru, true);
+    }
+
+    InCoreBuffer &b = incore_arena.bufs[std::make_pair(unit, buf)];
+    b.data.resize(len);
+    b.dirty = false;
+    incore_arena.used_bytes += bytes;
+    return &b;
+}
+
+}  // namespace
+
+/*
+** CIvect::incore_init(): Hold the buffers of the given units in core,
+**    using at most max_bytes of memory.
+*/
+void CIvect::incore_init(const std::vector<int> &units, size_t max_bytes) {
+    incore_release();
+    incore_arena.units.insert(units.begin(), units.end());
+    incore_arena.max_bytes = max_bytes;
+}
+
+/*
+** CIvect::incore_release(): Write all modified in-core buffers to their
+**    units and free the arena.  The units must still be open.
+*/
+void CIvect::incore_release() {
+    for (auto it = incore_arena.bufs.begin(); it != incore_arena.bufs.end();) it = incore_drop(it, true);
+    incore_arena.units.clear();
+    incore_arena.max_bytes = 0;
+    incore_arena.nspilled = 0;
+}
+
+/*
+** CIvect::incore_spilled(): Number of modified buffers that had to be
+**    written to disk because the arena was full.
+*/
+size_t CIvect::incore_spilled() { return incore_arena.nspilled; }
+
 CIvect::CIvect()  // Default constructor
 {
     common_init();
@@ -1723,6 +1827,13 @@ void CIvect::init_io_files(bool open_old) {
                 psio_open((size_t)units_[i], PSIO_OPEN_OLD);
             } else {
                 psio_open((size_t)units_[i], PSIO_OPEN_NEW);
+                /* anything still in core for this unit belongs to an old file */
+                for (auto it = incore_arena.bufs.begin(); it != incore_arena.bufs.end();) {
+                    if (it->first.first == units_[i])
+                        it = incore_drop(it, false);
+                    else
+                        ++it;
+                }
             }
         }
     }
@@ -1744,6 +1855,12 @@ void CIvect::close_io_files(int keep) {
     }
 
     for (size_t i = 0; i < nunits_; i++) {
+        for (auto it = incore_arena.bufs.begin(); it != incore_arena.bufs.end();) {
+            if (it->first.first == units_[i])
+                it = incore_drop(it, keep);
+            else
+                ++it;
+        }
         psio_close(units_[i], keep);
     }
     fopen_ = false;
@@ -1791,7 +1908,24 @@ int CIvect::read(int ivect, int ibuf) {
     sprintf(key, "buffer_ %d", buf);
     unit = file_number_[buf];
 
-    psio_read_entry((size_t)unit, key, (char *)buffer_, size);
+    if (incore_arena.units.count(unit)) {
+        auto it = incore_arena.bufs.find(std::make_pair(unit, buf));
+        if (it != incore_arena.bufs.end() && it->second.data.size() == buf_size_[ibuf]) {
+            memcpy(buffer_, it->second.data.data(), size);
+            it->second.stamp = ++incore_arena.clock;
+        } else {
+            /* a resident copy of another length may be newer than the disk */
+            if (it != incore_arena.bufs.end()) incore_drop(it, true);
+            psio_read_entry((size_t)unit, key, (char *)buffer_, size);
+            InCoreBuffer *b = incore_slot(unit, buf, buf_size_[ibuf]);
+            if (b != nullptr) {
+                memcpy(b->data.data(), buffer_, size);
+                b->stamp = ++incore_arena.clock;
+            }
+        }
+    } else {
+        psio_read_entry((size_t)unit, key, (char *)buffer_, size);
+    }
 
     cur_vect_ = ivect;
     cur_buf_ = ibuf;
@@ -1841,7 +1975,15 @@ int CIvect::write(int ivect, int ibuf) {
     sprintf(key, "buffer_ %d", buf);
     unit = file_number_[buf];
 
-    psio_write_entry((size_t)unit, key, (char *)buffer_, size);
+    InCoreBuffer *b = nullptr;
+    if (incore_arena.units.count(unit)) b = incore_slot(unit, buf, buf_size_[ibuf]);
+    if (b != nullptr) {
+        memcpy(b->data.data(), buffer_, size);
+        b->stamp = ++incore_arena.clock;
+        b->dirty = true;
+    } else {
+        psio_write_entry((size_t)unit, key, (char *)buffer_, size);
+    }
 
     if (ivect >= nvect_) nvect_ = ivect + 1;
     cur_vect_ = ivect;
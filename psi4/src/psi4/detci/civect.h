@@ -167,6 +167,13 @@ class CIvect {
     double *buf_malloc();
     void set_nvect(int i);
 
+    /// Keep the buffers of these units in core (shared by all CIvects), using at most max_bytes
+    static void incore_init(const std::vector<int> &units, size_t max_bytes);
+    /// Write modified in-core buffers back to their units and free the arena
+    static void incore_release();
+    /// Number of modified buffers written to disk because the arena was full
+    static size_t incore_spilled();
+
     // Questionable functions and/or should be private
     void set(int incor, int maxvect, int nunits, int funit, struct ci_blks *CIblks);
     void set(size_t vl, int nb, int incor, int ms0, int *iac, int *ibc, int *ias, int *ibs, size_t *offs, int nac,
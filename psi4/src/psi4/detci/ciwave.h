@@ -423,6 +423,7 @@ class CIWavefunction : public Wavefunction {
     struct sigma_data *SigmaData_;
     void sigma_init(CIvect &C, CIvect &S);
     void sigma_free();
+    void print_sigma_timings();
     void sigma(CIvect &C, CIvect &S, double *oei, double *tei, int ivec);
 
     void sigma_a(struct stringwr **alplist, struct stringwr **betlist, CIvect &C, CIvect &S, double *oei, double *tei,
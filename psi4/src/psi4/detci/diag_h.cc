@@ -41,6 +41,7 @@
 #include "psi4/detci/civect.h"
 #include "psi4/detci/ciwave.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cmath>
 #include <cstring>
@@ -432,6 +433,21 @@ int CIWavefunction::diag_h(double conv_e, double conv_rms) {
             print_mat(H0block_->H0b, H0block_->size, H0block_->size, "outfile");
         }
 
+        /* keep the subspace vectors in core if there is room */
+        if (Parameters_->incore_vecs) {
+            size_t vec_bytes = CIblks_->vectlen * sizeof(double);
+            size_t need = (2 * (size_t)Parameters_->maxnvect + nroots + 1) * vec_bytes;
+            size_t arena = std::min(need, (size_t)(Process::environment.get_memory() / 2));
+            CIvect::incore_init(
+                {Parameters_->hd_filenum, Parameters_->c_filenum, Parameters_->s_filenum, Parameters_->d_filenum},
+                arena);
+            if (print_) {
+                outfile->Printf("\n    In-core CI vectors: %.1f of %.1f MiB (%d vectors of %.1f MiB)\n",
+                                arena / 1048576.0, need / 1048576.0, 2 * Parameters_->maxnvect + nroots + 1,
+                                vec_bytes / 1048576.0);
+            }
+        }
+
         /* Davidson/Liu Simultaneous Expansion Method */
         if (Parameters_->diag_method == METHOD_DAVIDSON_LIU_SEM) {
             if (print_) {
@@ -459,6 +475,14 @@ int CIWavefunction::diag_h(double conv_e, double conv_rms) {
                          Parameters_->maxnvect);
         }
 
+        if (Parameters_->incore_vecs) {
+            if (print_ && CIvect::incore_spilled()) {
+                outfile->Printf("    %zu CI vector buffers did not fit in core and were written to disk\n",
+                                CIvect::incore_spilled());
+            }
+            CIvect::incore_release();
+        }
+
     } /* end the Davidson-Liu/Mitrushenkov-Olsen-Davidson section */
 
     // Check convergence
@@ -389,6 +389,7 @@ void CIWavefunction::get_parameters(Options &options) {
     Parameters_->lse_tolerance = options.get_double("LSE_TOLERANCE");
 
     Parameters_->maxnvect = options.get_int("MAX_NUM_VECS");
+    Parameters_->incore_vecs = options.get_bool("CI_INCORE_VECS");
 
     if (Parameters_->maxnvect == 0 && Parameters_->diag_method == METHOD_DAVIDSON_LIU_SEM) {
         Parameters_->maxnvect = Parameters_->maxiter * Parameters_->num_roots + Parameters_->num_init_vecs;
@@ -56,6 +56,10 @@
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/detci/structs.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 namespace detci {
 
@@ -95,8 +99,21 @@ void s1_block_vfci(struct stringwr **alplist, struct stringwr **betlist, double
     double Kb_sgn, Jb_sgn;
     double tval;
 
-    /* loop over I_b */
-    for (Ib = betlist[Ib_list], Ib_idx = 0; Ib_idx < nbs; Ib_idx++, Ib++) {
+    /* loop over I_b; each thread has its own F and updates only column I_b of S */
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    double **Fthread = init_matrix(nthreads, Jb_list_nbs);
+
+#pragma omp parallel for schedule(dynamic, 16) private(F, Ib, Kb, Kb_idx, Jb_idx, Ia_idx, Ibcnt, Kbcnt, Kb_list, Ib_ex, Kb_ex, Ibridx, Kbridx, Ibij, Kbij, Ibsgn, Kbsgn, ij, kl, ijkl, Kb_sgn, Jb_sgn, tval)
+    for (Ib_idx = 0; Ib_idx < nbs; Ib_idx++) {
+        Ib = betlist[Ib_list] + Ib_idx;
+#ifdef _OPENMP
+        F = Fthread[omp_get_thread_num()];
+#else
+        F = Fthread[0];
+#endif
         zero_arr(F, Jb_list_nbs);
 
         /* loop over excitations E^b_{kl} from |B(I_b)> */
@@ -155,6 +172,8 @@ void s1_block_vfci(struct stringwr **alplist, struct stringwr **betlist, double
         }
 
     } /* end loop over Ib */
+
+    free_matrix(Fthread, nthreads);
 }
 
 /*
@@ -189,8 +208,21 @@ void s1_block_vras(struct stringwr **alplist, struct stringwr **betlist, double
     double Kb_sgn, Jb_sgn;
     double tval;
 
-    /* loop over I_b */
-    for (Ib = betlist[Ib_list], Ib_idx = 0; Ib_idx < nbs; Ib_idx++, Ib++) {
+    /* loop over I_b; each thread has its own F and updates only column I_b of S */
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    double **Fthread = init_matrix(nthreads, Jb_list_nbs);
+
+#pragma omp parallel for schedule(dynamic, 16) private(F, Ib, Kb, Kb_idx, Jb_idx, Ia_idx, Ibcnt, Kbcnt, Kb_list, Ib_ex, Kb_ex, Ibridx, Kbridx, Ibij, Kbij, Ibsgn, Kbsgn, ij, kl, ijkl, Kb_sgn, Jb_sgn, tval, Iboij, Kboij, oij, okl)
+    for (Ib_idx = 0; Ib_idx < nbs; Ib_idx++) {
+        Ib = betlist[Ib_list] + Ib_idx;
+#ifdef _OPENMP
+        F = Fthread[omp_get_thread_num()];
+#else
+        F = Fthread[0];
+#endif
         zero_arr(F, Jb_list_nbs);
 
         /* loop over excitations E^b_{kl} from |B(I_b)> */
@@ -257,6 +289,8 @@ void s1_block_vras(struct stringwr **alplist, struct stringwr **betlist, double
         }
 
     } /* end loop over Ib */
+
+    free_matrix(Fthread, nthreads);
 }
 
 /*
@@ -44,6 +44,10 @@
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/detci/structs.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 namespace detci {
 
@@ -79,8 +83,21 @@ void s2_block_vfci(struct stringwr **alplist, struct stringwr **betlist, double
     double *Sptr, *Cptr;
 
     /* loop over all alpha strings Ia that belong to list Ia_list (irrep, block
-     * of alpha strings) */
-    for (Ia = alplist[Ia_list], Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
+     * of alpha strings); each thread has its own F and updates only row Ia of S */
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    double **Fthread = init_matrix(nthreads, Ja_list_nas);
+
+#pragma omp parallel for schedule(dynamic, 16) private(F, Ia, Ka, Ka_idx, Ja_idx, Ib_idx, Iacnt, Kacnt, Ka_list, Ia_ex, Ka_ex, Iaridx, Karidx, Iaij, Kaij, Iasgn, Kasgn, ij, kl, ijkl, Ka_sgn, Ja_sgn, tval, Sptr, Cptr)
+    for (Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+        Ia = alplist[Ia_list] + Ia_idx;
+#ifdef _OPENMP
+        F = Fthread[omp_get_thread_num()];
+#else
+        F = Fthread[0];
+#endif
         Sptr = S[Ia_idx];
         zero_arr(F, Ja_list_nas);
 
@@ -144,6 +161,8 @@ void s2_block_vfci(struct stringwr **alplist, struct stringwr **betlist, double
         }
 
     } /* end loop over Ia */
+
+    free_matrix(Fthread, nthreads);
 }
 
 /*
@@ -178,8 +197,21 @@ void s2_block_vras(struct stringwr **alplist, struct stringwr **betlist, double
     double tval;
     double *Sptr, *Cptr;
 
-    /* loop over I_a */
-    for (Ia = alplist[Ia_list], Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
+    /* loop over I_a; each thread has its own F and updates only row I_a of S */
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    double **Fthread = init_matrix(nthreads, Ja_list_nas);
+
+#pragma omp parallel for schedule(dynamic, 16) private(F, Ia, Ka, Ka_idx, Ja_idx, Ib_idx, Iacnt, Kacnt, Ka_list, Ia_ex, Ka_ex, Iaridx, Karidx, Iaij, Kaij, Iasgn, Kasgn, ij, kl, ijkl, Ka_sgn, Ja_sgn, tval, Sptr, Cptr, Iaoij, Kaoij, oij, okl)
+    for (Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+        Ia = alplist[Ia_list] + Ia_idx;
+#ifdef _OPENMP
+        F = Fthread[omp_get_thread_num()];
+#else
+        F = Fthread[0];
+#endif
         Sptr = S[Ia_idx];
         zero_arr(F, Ja_list_nas);
 
@@ -245,6 +277,8 @@ void s2_block_vras(struct stringwr **alplist, struct stringwr **betlist, double
         }
 
     } /* end loop over Ia */
+
+    free_matrix(Fthread, nthreads);
 }
 
 /*
@@ -37,6 +37,10 @@
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/detci/structs.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 namespace detci {
 
@@ -197,17 +201,10 @@ void s3_block_bz(int Ialist, int Iblist, int Jalist, int Jblist, int nas, int nb
                  double **S, double **Cprime, double **Sprime, struct calcinfo *CInfo, int ***OV) {
     int Iasym, Jasym, Ibsym, Jbsym;
     int norbs, *orbsym;
-    int i, j, k, l, ij, fullij, fullji, kl, fullkl, fulllk, tmpi, tmpj;
-    int I, J, I1, I2, J1, J2, S2; /* also try S2 as double */
-    int ilen, jlen;
-    double V, VS;
+    int i, j, ij, fullij, fullji;
+    int jlen;
     double *Tptr;
-    int *OVptr, *OVptr2;
     int signmask, nsignmask;
-    double *SprimeI, *CprimeI;
-    double *SprimeI0, *SprimeI1, *SprimeI2, *SprimeI3;
-    double *SprimeI4, *SprimeI5, *SprimeI6, *SprimeI7;
-    double *SI0, *SI1, *SI2, *SI3, *SI4, *SI5, *SI6, *SI7;
 
     orbsym = CInfo->orbsym + CInfo->num_drc_orbs;
     Iasym = Ialist;
@@ -234,137 +231,75 @@ void s3_block_bz(int Ialist, int Iblist, int Jalist, int Jblist, int nas, int nb
 
             if (jlen == 0) continue;
 
-            for (J = 0, OVptr = OV[Jblist][fullji] + 1; J < jlen; J++) {
-                tmpi = *OVptr++;
-                J2 = tmpi & nsignmask;
-                S2 = (tmpi & signmask) ? -1 : 1;
-                for (I = 0; I < cnas % 8; I++) {
-                    Cprime[I][J] = C[I][J2] * S2;
-                }
-            }
-
-            OVptr = OV[Jblist][fullji] + 1;
-            for (; I < cnas; I += 8) {
-                SprimeI0 = Cprime[I];
-                SI0 = C[I];
-                SprimeI1 = Cprime[I + 1];
-                SI1 = C[I + 1];
-                SprimeI2 = Cprime[I + 2];
-                SI2 = C[I + 2];
-                SprimeI3 = Cprime[I + 3];
-                SI3 = C[I + 3];
-                SprimeI4 = Cprime[I + 4];
-                SI4 = C[I + 4];
-                SprimeI5 = Cprime[I + 5];
-                SI5 = C[I + 5];
-                SprimeI6 = Cprime[I + 6];
-                SI6 = C[I + 6];
-                SprimeI7 = Cprime[I + 7];
-                SI7 = C[I + 7];
-
-                for (J = 0; J < jlen; J++) {
-                    tmpi = OVptr[J];
-                    J2 = tmpi & nsignmask;
-                    S2 = (tmpi & signmask) ? -1 : 1;
+#pragma omp parallel
+            {
+                /* every thread owns a contiguous range of Sprime (and S) rows,
+                 * so the accumulation order per row is the same as serial */
+                int nthread = 1, thread = 0;
+#ifdef _OPENMP
+                nthread = omp_get_num_threads();
+                thread = omp_get_thread_num();
+#endif
+                int Ibeg = (int)(((long int)nas * thread) / nthread);
+                int Iend = (int)(((long int)nas * (thread + 1)) / nthread);
+                int *OVptr, *OVptr2;
 
-                    SprimeI0[J] = SI0[J2] * S2;
-                    SprimeI1[J] = SI1[J2] * S2;
-                    SprimeI2[J] = SI2[J2] * S2;
-                    SprimeI3[J] = SI3[J2] * S2;
-                    SprimeI4[J] = SI4[J2] * S2;
-                    SprimeI5[J] = SI5[J2] * S2;
-                    SprimeI6[J] = SI6[J2] * S2;
-                    SprimeI7[J] = SI7[J2] * S2;
+                /* gather operation */
+                OVptr = OV[Jblist][fullji] + 1;
+#pragma omp for
+                for (int I = 0; I < cnas; I++) {
+                    double *CprimeI = Cprime[I];
+                    double *CI = C[I];
+                    for (int J = 0; J < jlen; J++) {
+                        int tmpi = OVptr[J];
+                        CprimeI[J] = (tmpi & signmask) ? -CI[tmpi & nsignmask] : CI[tmpi & nsignmask];
+                    }
                 }
-            }
 
-            zero_mat(Sprime, nas, nbs);
+                for (int I = Ibeg; I < Iend; I++) zero_arr(Sprime[I], nbs);
 
-            for (k = 0; k < norbs; k++) {
-                for (l = 0; l < norbs; l++) {
-                    if ((orbsym[k] ^ orbsym[l] ^ Jasym ^ Iasym) != 0) continue;
-                    kl = INDEX(k, l);
-                    if (kl > ij) continue;
-                    V = Tptr[kl];
-                    if (ij == kl) V = V / 2.0;
-                    fullkl = k * norbs + l;
-                    fulllk = l * norbs + k;
-                    ilen = OV[Jalist][fulllk][0];
-                    OVptr = OV[Jalist][fulllk] + 1;
-                    OVptr2 = OV[Ialist][fullkl] + 1;
+                for (int k = 0; k < norbs; k++) {
+                    for (int l = 0; l < norbs; l++) {
+                        if ((orbsym[k] ^ orbsym[l] ^ Jasym ^ Iasym) != 0) continue;
+                        int kl = INDEX(k, l);
+                        if (kl > ij) continue;
+                        double V = Tptr[kl];
+                        if (ij == kl) V = V / 2.0;
+                        int fullkl = k * norbs + l;
+                        int fulllk = l * norbs + k;
+                        int ilen = OV[Jalist][fulllk][0];
+                        OVptr = OV[Jalist][fulllk] + 1;
+                        OVptr2 = OV[Ialist][fullkl] + 1;
 
-                    for (I = 0; I < ilen; I++) {
-                        tmpi = *OVptr++;
-                        tmpj = *OVptr2++;
-                        I1 = tmpi & nsignmask;
-                        I2 = tmpj & nsignmask;
-                        VS = (tmpj & signmask) ? -V : V;
+                        for (int I = 0; I < ilen; I++) {
+                            int tmpj = OVptr2[I];
+                            int I2 = tmpj & nsignmask;
+                            if (I2 < Ibeg || I2 >= Iend) continue;
+                            int I1 = OVptr[I] & nsignmask;
+                            double VS = (tmpj & signmask) ? -V : V;
 
 #ifdef USE_BLAS
-                        C_DAXPY(jlen, VS, Cprime[I1], 1, Sprime[I2], 1);
+                            C_DAXPY(jlen, VS, Cprime[I1], 1, Sprime[I2], 1);
 #else
-                        SprimeI = Sprime[I2];
-                        CprimeI = Cprime[I1];
-
-                        for (J = 0; J < jlen % 8; J++) {
-                            SprimeI[J] += CprimeI[J] * VS;
-                        }
-
-                        for (; J < jlen; J += 8) {
-                            SprimeI[J] += CprimeI[J] * VS;
-                            SprimeI[J + 1] += CprimeI[J + 1] * VS;
-                            SprimeI[J + 2] += CprimeI[J + 2] * VS;
-                            SprimeI[J + 3] += CprimeI[J + 3] * VS;
-                            SprimeI[J + 4] += CprimeI[J + 4] * VS;
-                            SprimeI[J + 5] += CprimeI[J + 5] * VS;
-                            SprimeI[J + 6] += CprimeI[J + 6] * VS;
-                            SprimeI[J + 7] += CprimeI[J + 7] * VS;
-                        }
+                            double *SprimeI = Sprime[I2];
+                            double *CprimeI = Cprime[I1];
+                            for (int J = 0; J < jlen; J++) {
+                                SprimeI[J] += CprimeI[J] * VS;
+                            }
 #endif
 
-                    } /* end loop over I */
-                }     /* end loop over l */
-            }         /* end loop over k */
-
-            for (J = 0, OVptr = OV[Iblist][fullij] + 1; J < jlen; J++) {
-                tmpi = *OVptr++;
-                J1 = tmpi & nsignmask;
-                for (I = 0; I < nas % 8; I++) {
-                    S[I][J1] += Sprime[I][J];
-                }
-            }
-
-            OVptr = OV[Iblist][fullij] + 1;
-
-            for (; I < nas; I += 8) {
-                SI0 = S[I];
-                SprimeI0 = Sprime[I];
-                SI1 = S[I + 1];
-                SprimeI1 = Sprime[I + 1];
-                SI2 = S[I + 2];
-                SprimeI2 = Sprime[I + 2];
-                SI3 = S[I + 3];
-                SprimeI3 = Sprime[I + 3];
-                SI4 = S[I + 4];
-                SprimeI4 = Sprime[I + 4];
-                SI5 = S[I + 5];
-                SprimeI5 = Sprime[I + 5];
-                SI6 = S[I + 6];
-                SprimeI6 = Sprime[I + 6];
-                SI7 = S[I + 7];
-                SprimeI7 = Sprime[I + 7];
+                        } /* end loop over I */
+                    }     /* end loop over l */
+                }         /* end loop over k */
 
-                for (J = 0; J < jlen; J++) {
-                    tmpi = OVptr[J];
-                    J1 = tmpi & nsignmask;
-                    SI0[J1] += SprimeI0[J];
-                    SI1[J1] += SprimeI1[J];
-                    SI2[J1] += SprimeI2[J];
-                    SI3[J1] += SprimeI3[J];
-                    SI4[J1] += SprimeI4[J];
-                    SI5[J1] += SprimeI5[J];
-                    SI6[J1] += SprimeI6[J];
-                    SI7[J1] += SprimeI7[J];
+                /* scatter */
+                OVptr = OV[Iblist][fullij] + 1;
+                for (int I = Ibeg; I < Iend; I++) {
+                    double *SI = S[I];
+                    double *SprimeI = Sprime[I];
+                    for (int J = 0; J < jlen; J++) {
+                        SI[OVptr[J] & nsignmask] += SprimeI[J];
+                    }
                 }
             }
 
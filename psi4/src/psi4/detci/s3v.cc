@@ -41,6 +41,10 @@
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/detci/structs.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 namespace detci {
 
@@ -65,15 +69,17 @@ int form_ilist_rotf(int *Cnt, int **Ridx, signed char **Sn, int **Ij, int nas, i
 void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist, double **C, double **S, double *tei, int nas,
                     int nbs, int cnas, int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym, double **Cprime,
                     double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym) {
-    struct stringwr *Ia;
-    size_t Ia_ex;
-    int ij, i, j, t, kl, I, J, RJ;
-    double tval, VS, *CprimeI0, *CI0;
-    int jlen, Jacnt, *Iaij, Ia_idx;
-    size_t *Iaridx;
-    signed char *Iasgn;
+    int ij, i, j, I, jlen;
     double *Tptr;
-    int npthreads, rc, status;
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    /* private V for every thread; the caller's V is used by thread 0 */
+    double **Vthread = (double **)malloc(nthreads * sizeof(double *));
+    Vthread[0] = V;
+    for (int t = 1; t < nthreads; t++) Vthread[t] = init_array(nbs);
 
     /* loop over i, j */
     for (i = 0; i < norbs; i++) {
@@ -83,54 +89,70 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist, double *
             jlen = form_ilist(betlist, Jb_list, nbs, ij, L, R, Sgn);
 
             if (!jlen) continue;
-            /*  outfile->Printf("S3_BLOCK_VDIAG: ij = %d\t jlen = %d\n", ij, jlen);
-             */
+
             Tptr = tei + ioff[ij];
 
-            /* gather operation */
-            for (I = 0; I < cnas; I++) {
-                CprimeI0 = Cprime[I];
-                CI0 = C[I];
-                for (J = 0; J < jlen; J++) {
-                    tval = Sgn[J];
-                    CprimeI0[J] = CI0[L[J]] * tval;
+#pragma omp parallel num_threads(nthreads)
+            {
+                /* gather operation */
+#pragma omp for
+                for (I = 0; I < cnas; I++) {
+                    double *CprimeI0 = Cprime[I];
+                    double *CI0 = C[I];
+                    for (int J = 0; J < jlen; J++) {
+                        CprimeI0[J] = CI0[L[J]] * Sgn[J];
+                    }
                 }
-            }
 
-            for (Ia = alplist, Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
-                /* loop over excitations E^a_{kl} from |A(I_a)> */
-                Jacnt = Ia->cnt[Ja_list];
-                Iaridx = Ia->ridx[Ja_list];
-                Iasgn = Ia->sgn[Ja_list];
-                Iaij = Ia->ij[Ja_list];
+#ifdef _OPENMP
+                double *Vt = Vthread[omp_get_thread_num()];
+#else
+                double *Vt = Vthread[0];
+#endif
 
-                zero_arr(V, jlen);
-                for (Ia_ex = 0; Ia_ex < Jacnt && (kl = *Iaij++) <= ij; Ia_ex++) {
-                    I = *Iaridx++;
-                    tval = *Iasgn++;
-                    if (ij == kl) tval *= 0.5;
-                    VS = Tptr[kl] * tval;
-                    CprimeI0 = Cprime[I];
+                /* each Ia updates only row Ia of S, so the rows can be
+                 * distributed over threads without changing the result */
+#pragma omp for schedule(dynamic, 16)
+                for (int Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+                    struct stringwr *Ia = alplist + Ia_idx;
+                    /* loop over excitations E^a_{kl} from |A(I_a)> */
+                    size_t Jacnt = Ia->cnt[Ja_list];
+                    size_t *Iaridx = Ia->ridx[Ja_list];
+                    signed char *Iasgn = Ia->sgn[Ja_list];
+                    int *Iaij = Ia->ij[Ja_list];
+                    int kl;
+
+                    zero_arr(Vt, jlen);
+                    for (size_t Ia_ex = 0; Ia_ex < Jacnt && (kl = *Iaij++) <= ij; Ia_ex++) {
+                        int Irow = *Iaridx++;
+                        double tval = *Iasgn++;
+                        if (ij == kl) tval *= 0.5;
+                        double VS = Tptr[kl] * tval;
+                        double *CprimeI0 = Cprime[Irow];
 
 #ifdef USE_BS
-                    C_DAXPY(jlen, VS, CprimeI0, 1, V, 1);
+                        C_DAXPY(jlen, VS, CprimeI0, 1, Vt, 1);
 #else
-                    for (J = 0; J < jlen; J++) {
-                        V[J] += VS * CprimeI0[J];
-                    }
+                        for (int J = 0; J < jlen; J++) {
+                            Vt[J] += VS * CprimeI0[J];
+                        }
 #endif
-                }
+                    }
 
-                /* scatter */
-                for (J = 0; J < jlen; J++) {
-                    RJ = R[J];
-                    S[Ia_idx][RJ] += V[J];
-                }
+                    /* scatter */
+                    double *SIa = S[Ia_idx];
+                    for (int J = 0; J < jlen; J++) {
+                        SIa[R[J]] += Vt[J];
+                    }
 
-            } /* end loop over Ia */
+                } /* end loop over Ia */
+            }
 
         } /* end loop over j */
     }     /* end loop over i */
+
+    for (int t = 1; t < nthreads; t++) free(Vthread[t]);
+    free(Vthread);
 }
 
 /*
@@ -143,15 +165,18 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist, double *
 void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C, double **S, double *tei, int nas,
                 int nbs, int cnas, int Ib_list, int Ja_list, int Jb_list, int Ib_sym, int Jb_sym, double **Cprime,
                 double *F, double *V, double *Sgn, int *L, int *R, int norbs, int *orbsym) {
-    struct stringwr *Ia;
-    size_t Ia_ex;
-    int ij, i, j, kl, ijkl, I, J, RJ;
-    double tval, VS, *CprimeI0, *CI0;
-    int jlen, Ia_idx, Jacnt, *Iaij;
-    size_t *Iaridx;
-    signed char *Iasgn;
+    int ij, i, j, I, jlen;
     double *Tptr;
 
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    /* private V for every thread; the caller's V is used by thread 0 */
+    double **Vthread = (double **)malloc(nthreads * sizeof(double *));
+    Vthread[0] = V;
+    for (int t = 1; t < nthreads; t++) Vthread[t] = init_array(nbs);
+
     /* loop over i, j */
     for (i = 0; i < norbs; i++) {
         for (j = 0; j <= i; j++) {
@@ -163,54 +188,70 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
 
             Tptr = tei + ioff[ij];
 
-            /* gather operation */
-            for (I = 0; I < cnas; I++) {
-                CprimeI0 = Cprime[I];
-                CI0 = C[I];
-                for (J = 0; J < jlen; J++) {
-                    tval = Sgn[J];
-                    CprimeI0[J] = CI0[L[J]] * tval;
-                }
-            }
-
             timer_on("CIWave: s3_mt");
-            for (Ia = alplist, Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
-                /* loop over excitations E^a_{kl} from |A(I_a)> */
-                Jacnt = Ia->cnt[Ja_list];
-                Iaridx = Ia->ridx[Ja_list];
-                Iasgn = Ia->sgn[Ja_list];
-                Iaij = Ia->ij[Ja_list];
+#pragma omp parallel num_threads(nthreads)
+            {
+                /* gather operation */
+#pragma omp for
+                for (I = 0; I < cnas; I++) {
+                    double *CprimeI0 = Cprime[I];
+                    double *CI0 = C[I];
+                    for (int J = 0; J < jlen; J++) {
+                        CprimeI0[J] = CI0[L[J]] * Sgn[J];
+                    }
+                }
 
-                zero_arr(V, jlen);
+#ifdef _OPENMP
+                double *Vt = Vthread[omp_get_thread_num()];
+#else
+                double *Vt = Vthread[0];
+#endif
 
-                for (Ia_ex = 0; Ia_ex < Jacnt; Ia_ex++) {
-                    kl = *Iaij++;
-                    I = *Iaridx++;
-                    tval = *Iasgn++;
-                    ijkl = INDEX(ij, kl);
-                    VS = tval * tei[ijkl];
-                    CprimeI0 = Cprime[I];
+                /* each Ia updates only row Ia of S, so the rows can be
+                 * distributed over threads without changing the result */
+#pragma omp for schedule(dynamic, 16)
+                for (int Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+                    struct stringwr *Ia = alplist + Ia_idx;
+                    /* loop over excitations E^a_{kl} from |A(I_a)> */
+                    size_t Jacnt = Ia->cnt[Ja_list];
+                    size_t *Iaridx = Ia->ridx[Ja_list];
+                    signed char *Iasgn = Ia->sgn[Ja_list];
+                    int *Iaij = Ia->ij[Ja_list];
+                    int kl;
+
+                    zero_arr(Vt, jlen);
+                    for (size_t Ia_ex = 0; Ia_ex < Jacnt; Ia_ex++) {
+                        kl = *Iaij++;
+                        int Irow = *Iaridx++;
+                        double tval = *Iasgn++;
+                        int ijkl = INDEX(ij, kl);
+                        double VS = tval * tei[ijkl];
+                        double *CprimeI0 = Cprime[Irow];
 
 #ifdef UBLAS
-                    C_DAXPY(jlen, VS, CprimeI0, 1, V, 1);
+                        C_DAXPY(jlen, VS, CprimeI0, 1, Vt, 1);
 #else
-                    for (J = 0; J < jlen; J++) {
-                        V[J] += VS * CprimeI0[J];
-                    }
+                        for (int J = 0; J < jlen; J++) {
+                            Vt[J] += VS * CprimeI0[J];
+                        }
 #endif
-                }
+                    }
 
-                /* scatter */
-                for (J = 0; J < jlen; J++) {
-                    RJ = R[J];
-                    S[Ia_idx][RJ] += V[J];
-                }
+                    /* scatter */
+                    double *SIa = S[Ia_idx];
+                    for (int J = 0; J < jlen; J++) {
+                        SIa[R[J]] += Vt[J];
+                    }
 
-            } /* end loop over Ia */
+                } /* end loop over Ia */
+            }
             timer_off("CIWave: s3_mt");
 
         } /* end loop over j */
     }     /* end loop over i */
+
+    for (int t = 1; t < nthreads; t++) free(Vthread[t]);
+    free(Vthread);
 }
 
 int form_ilist(struct stringwr *alplist, int Ja_list, int nas, int kl, int *L, int *R, double *Sgn) {
@@ -45,6 +45,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
+#include <chrono>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/vector.h"
@@ -129,6 +130,19 @@ void CIWavefunction::sigma_init(CIvect &C, CIvect &S) {
     SigmaData_->max_dim = max_dim;
     SigmaData_->F = init_array(max_dim);
 
+    /* per sigma block wall times, to judge the load balance of the threaded
+       s1/s2/s3 routines */
+    SigmaData_->num_sblocks = S.num_blocks_;
+    SigmaData_->sblock_info = init_int_matrix(S.num_blocks_, 4);
+    SigmaData_->sblock_time = init_matrix(S.num_blocks_, 3);
+    SigmaData_->sblock_calls = init_int_array(S.num_blocks_);
+    for (i = 0; i < S.num_blocks_; i++) {
+        SigmaData_->sblock_info[i][0] = S.Ia_code_[i];
+        SigmaData_->sblock_info[i][1] = S.Ib_code_[i];
+        SigmaData_->sblock_info[i][2] = S.Ia_size_[i];
+        SigmaData_->sblock_info[i][3] = S.Ib_size_[i];
+    }
+
     SigmaData_->Sgn = init_array(max_dim);
     SigmaData_->V = init_array(max_dim);
     SigmaData_->L = init_int_array(max_dim);
@@ -226,6 +240,11 @@ void CIWavefunction::sigma_init(CIvect &C, CIvect &S) {
 }
 
 void CIWavefunction::sigma_free() {
+    if (print_ > 1) print_sigma_timings();
+    free_int_matrix(SigmaData_->sblock_info);
+    free_matrix(SigmaData_->sblock_time, SigmaData_->num_sblocks);
+    free(SigmaData_->sblock_calls);
+
     free(SigmaData_->F);
     free(SigmaData_->Sgn);
     free(SigmaData_->V);
@@ -250,6 +269,27 @@ void CIWavefunction::sigma_free() {
     // double **SigmaData_->transp_tmp, **SigmaData_->cprime, **SigmaData_->sprime;
 }
 
+/*
+** print_sigma_timings()
+**
+** Print the accumulated s1/s2/s3 wall time for every sigma block
+**
+*/
+void CIWavefunction::print_sigma_timings() {
+    double tot[3] = {0.0, 0.0, 0.0};
+
+    outfile->Printf("\n   ==> DETCI: Sigma Block Timings <==\n\n");
+    outfile->Printf("    Block  Ia  Ib      nas      nbs  Calls       s1 [s]       s2 [s]       s3 [s]\n");
+    for (int blk = 0; blk < SigmaData_->num_sblocks; blk++) {
+        int *info = SigmaData_->sblock_info[blk];
+        double *t = SigmaData_->sblock_time[blk];
+        outfile->Printf("    %5d %3d %3d %8d %8d %6d %12.3f %12.3f %12.3f\n", blk, info[0], info[1], info[2], info[3],
+                        SigmaData_->sblock_calls[blk], t[0], t[1], t[2]);
+        for (int n = 0; n < 3; n++) tot[n] += t[n];
+    }
+    outfile->Printf("    %-44s %12.3f %12.3f %12.3f\n\n", "Total", tot[0], tot[1], tot[2]);
+}
+
 /*
 ** sigma()
 **
@@ -613,9 +653,17 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
                                  double *oei, double *tei, int fci, int cblock, int sblock, int nas, int nbs, int sac,
                                  int sbc, int cac, int cbc, int cnas, int cnbs, int cnac, int cnbc, int sbirr,
                                  int cbirr, int Ms0) {
+    using clock = std::chrono::steady_clock;
+    double *blk_time = (sblock < SigmaData_->num_sblocks) ? SigmaData_->sblock_time[sblock] : nullptr;
+    auto elapsed = [](clock::time_point t0) { return std::chrono::duration<double>(clock::now() - t0).count(); };
+    clock::time_point t0;
+
+    if (blk_time != nullptr) SigmaData_->sblock_calls[sblock]++;
+
     /* SIGMA2 CONTRIBUTION */
     if (s2_contrib_[sblock][cblock]) {
         timer_on("CIWave: s2");
+        t0 = clock::now();
 
         if (fci) {
             s2_block_vfci(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnac, nas, nbs, sac, cac, cnas);
@@ -628,6 +676,7 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
                 s2_block_vras(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnac, nas, nbs, sac, cac, cnas);
             }
         }
+        if (blk_time != nullptr) blk_time[1] += elapsed(t0);
         timer_off("CIWave: s2");
 
     } /* end sigma2 */
@@ -640,6 +689,7 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
     /* SIGMA1 CONTRIBUTION */
     if (!Ms0 || (sac != sbc)) {
         timer_on("CIWave: s1");
+        t0 = clock::now();
 
         if (s1_contrib_[sblock][cblock]) {
             if (fci) {
@@ -656,6 +706,7 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
             }
         }
 
+        if (blk_time != nullptr) blk_time[0] += elapsed(t0);
         timer_off("CIWave: s1");
     } /* end sigma1 */
 
@@ -667,6 +718,7 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
     /* SIGMA3 CONTRIBUTION */
     if (s3_contrib_[sblock][cblock]) {
         timer_on("CIWave: s3");
+        t0 = clock::now();
 
         /* zero_mat(smat, nas, nbs); */
 
@@ -714,6 +766,7 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
             print_mat(smat, nas, nbs, "outfile");
         }
 
+        if (blk_time != nullptr) blk_time[2] += elapsed(t0);
         timer_off("CIWave: s3");
 
     } /* end sigma3 */
@@ -511,6 +511,7 @@ struct params {
     int wigner;                          /* 1(0) if wigner formulas used in Empn series */
     int diag_iters_taken;                /* Number of diagonalization iterations taken */
     int maxnvect;                        /* maximum number of b vectors for SEM method */
+    int incore_vecs;                     /* 1(0) if Davidson vectors are kept in core */
     int nunits;                          /* num of tmp files to use for CI vects and such */
     int collapse_size;                   /* how many vectors to collapse to in SEM */
     int lse_collapse;                    /* iterations between lst sqr ext */
@@ -642,6 +643,10 @@ struct sigma_data {
     double *V, *Sgn;
     int *L, *R;
     int max_dim;
+    int num_sblocks;      /* number of sigma blocks timed below */
+    int **sblock_info;    /* Ia code, Ib code, nas, nbs for each sigma block */
+    double **sblock_time; /* wall time (s) spent in s1, s2, s3 per sigma block */
+    int *sblock_calls;    /* number of sigma_block() calls for each sigma block */
 };
 }
 }  // namespace psi
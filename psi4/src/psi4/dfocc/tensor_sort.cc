@@ -0,0 +1,364 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "tensor_sort.h"
+
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/psi4-dec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace psi {
+namespace dfoccwave {
+
+namespace {
+
+// Edge of the square tiles used when the source- and target-contiguous indices differ
+constexpr size_t sort_tile = 32;
+
+constexpr int pow10i(int k) { return k == 0 ? 1 : 10 * pow10i(k - 1); }
+
+// Source index (1-based) held by target slot j of an nd-digit sort code
+constexpr int sort_digit(int code, int nd, int j) { return (code / pow10i(nd - 1 - j)) % 10; }
+
+// Target slot that receives source index k (0-based)
+constexpr int sort_slot(int code, int nd, int k) {
+    for (int j = 0; j < nd; j++) {
+        if (sort_digit(code, nd, j) == k + 1) return j;
+    }
+    return -1;
+}
+
+template <bool Accumulate>
+inline void sort_assign(double &b, double a, double alpha, double beta) {
+    b = Accumulate ? alpha * a + beta * b : alpha * a;
+}
+
+template <int Code, bool Accumulate>
+void permute4_kernel(const double *A, const size_t *n, const size_t *ss, double *B, const size_t *tslot,
+                     double alpha, double beta) {
+    // Source index that is contiguous in the target, and the two that are neither it nor s
+    constexpr int f = sort_digit(Code, 4, 3) - 1;
+    constexpr int o0 = (f == 0) ? 1 : 0;
+    constexpr int o1 = (f == 2) ? 1 : 2;
+    const size_t ts[4] = {tslot[sort_slot(Code, 4, 0)], tslot[sort_slot(Code, 4, 1)], tslot[sort_slot(Code, 4, 2)],
+                          tslot[sort_slot(Code, 4, 3)]};
+
+    if (f == 3) {
+        // s stays last: every (p,q,r) is a contiguous row in both tensors
+#pragma omp parallel for collapse(3) schedule(static)
+        for (size_t p = 0; p < n[0]; p++) {
+            for (size_t q = 0; q < n[1]; q++) {
+                for (size_t r = 0; r < n[2]; r++) {
+                    const double *a = A + p * ss[0] + q * ss[1] + r * ss[2];
+                    double *b = B + p * ts[0] + q * ts[1] + r * ts[2];
+                    for (size_t s = 0; s < n[3]; s++) {
+                        sort_assign<Accumulate>(b[s], a[s], alpha, beta);
+                    }
+                }
+            }
+        }
+    } else {
+        // Transpose (f,s) tiles so the strided side of each tile stays in cache
+#pragma omp parallel for collapse(2) schedule(static)
+        for (size_t i = 0; i < n[o0]; i++) {
+            for (size_t j = 0; j < n[o1]; j++) {
+                const double *a0 = A + i * ss[o0] + j * ss[o1];
+                double *b0 = B + i * ts[o0] + j * ts[o1];
+                for (size_t ft = 0; ft < n[f]; ft += sort_tile) {
+                    size_t fe = std::min(ft + sort_tile, n[f]);
+                    for (size_t st = 0; st < n[3]; st += sort_tile) {
+                        size_t se = std::min(st + sort_tile, n[3]);
+                        for (size_t s = st; s < se; s++) {
+                            const double *a = a0 + s * ss[3];
+                            double *b = b0 + s * ts[3];
+                            for (size_t x = ft; x < fe; x++) {
+                                sort_assign<Accumulate>(b[x * ts[f]], a[x * ss[f]], alpha, beta);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <int Code, bool Accumulate>
+void permute3_kernel(const double *A, const size_t *n, const size_t *ss, double *B, const size_t *tslot,
+                     double alpha, double beta) {
+    constexpr int f = sort_digit(Code, 3, 2) - 1;
+    constexpr int o = (f == 0) ? 1 : 0;
+    const size_t ts[3] = {tslot[sort_slot(Code, 3, 0)], tslot[sort_slot(Code, 3, 1)], tslot[sort_slot(Code, 3, 2)]};
+
+    if (f == 2) {
+#pragma omp parallel for collapse(2) schedule(static)
+        for (size_t p = 0; p < n[0]; p++) {
+            for (size_t q = 0; q < n[1]; q++) {
+                const double *a = A + p * ss[0] + q * ss[1];
+                double *b = B + p * ts[0] + q * ts[1];
+                for (size_t r = 0; r < n[2]; r++) {
+                    sort_assign<Accumulate>(b[r], a[r], alpha, beta);
+                }
+            }
+        }
+    } else {
+        size_t ntile = (n[f] + sort_tile - 1) / sort_tile;
+#pragma omp parallel for collapse(2) schedule(static)
+        for (size_t i = 0; i < n[o]; i++) {
+            for (size_t t = 0; t < ntile; t++) {
+                const double *a0 = A + i * ss[o];
+                double *b0 = B + i * ts[o];
+                size_t ft = t * sort_tile;
+                size_t fe = std::min(ft + sort_tile, n[f]);
+                for (size_t st = 0; st < n[2]; st += sort_tile) {
+                    size_t se = std::min(st + sort_tile, n[2]);
+                    for (size_t s = st; s < se; s++) {
+                        const double *a = a0 + s * ss[2];
+                        double *b = b0 + s * ts[2];
+                        for (size_t x = ft; x < fe; x++) {
+                            sort_assign<Accumulate>(b[x * ts[f]], a[x * ss[f]], alpha, beta);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <int Code>
+void permute4_code(const double *A, const size_t *n, const size_t *ss, double *B, const size_t *ts, double alpha,
+                   double beta) {
+    if (beta == 0.0)
+        permute4_kernel<Code, false>(A, n, ss, B, ts, alpha, beta);
+    else
+        permute4_kernel<Code, true>(A, n, ss, B, ts, alpha, beta);
+}
+
+template <int Code>
+void permute3_code(const double *A, const size_t *n, const size_t *ss, double *B, const size_t *ts, double alpha,
+                   double beta) {
+    if (beta == 0.0)
+        permute3_kernel<Code, false>(A, n, ss, B, ts, alpha, beta);
+    else
+        permute3_kernel<Code, true>(A, n, ss, B, ts, alpha, beta);
+}
+
+// The loops the engine replaced: int pair-index tables looked up per element, outer index threaded
+template <int Code>
+void sort_reference(int d, double **A, double **B, int **idx, double alpha, double beta) {
+    constexpr int t0 = sort_digit(Code, 4, 0) - 1;
+    constexpr int t1 = sort_digit(Code, 4, 1) - 1;
+    constexpr int t2 = sort_digit(Code, 4, 2) - 1;
+    constexpr int t3 = sort_digit(Code, 4, 3) - 1;
+#pragma omp parallel for
+    for (int p = 0; p < d; p++) {
+        int v[4];
+        v[0] = p;
+        for (int q = 0; q < d; q++) {
+            v[1] = q;
+            int pq = idx[p][q];
+            for (int r = 0; r < d; r++) {
+                v[2] = r;
+                for (int s = 0; s < d; s++) {
+                    v[3] = s;
+                    int rs = idx[r][s];
+                    int row = idx[v[t0]][v[t1]];
+                    int col = idx[v[t2]][v[t3]];
+                    B[row][col] = (alpha * A[pq][rs]) + (beta * B[row][col]);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+#define PERMUTE4_CASE(code)                                \
+    case code:                                             \
+        permute4_code<code>(A, n, ss, B, ts, alpha, beta); \
+        return true;
+
+bool permute4(int sort_type, const double *A, const size_t *n, const size_t *ss, double *B, const size_t *ts,
+              double alpha, double beta) {
+    switch (sort_type) {
+        PERMUTE4_CASE(1234)
+        PERMUTE4_CASE(1243)
+        PERMUTE4_CASE(1324)
+        PERMUTE4_CASE(1342)
+        PERMUTE4_CASE(1423)
+        PERMUTE4_CASE(1432)
+        PERMUTE4_CASE(2134)
+        PERMUTE4_CASE(2143)
+        PERMUTE4_CASE(2314)
+        PERMUTE4_CASE(2341)
+        PERMUTE4_CASE(2413)
+        PERMUTE4_CASE(2431)
+        PERMUTE4_CASE(3124)
+        PERMUTE4_CASE(3142)
+        PERMUTE4_CASE(3214)
+        PERMUTE4_CASE(3241)
+        PERMUTE4_CASE(3412)
+        PERMUTE4_CASE(3421)
+        PERMUTE4_CASE(4123)
+        PERMUTE4_CASE(4132)
+        PERMUTE4_CASE(4213)
+        PERMUTE4_CASE(4231)
+        PERMUTE4_CASE(4312)
+        PERMUTE4_CASE(4321)
+        default:
+            return false;
+    }
+}
+
+#undef PERMUTE4_CASE
+
+#define PERMUTE3_CASE(code)                                \
+    case code:                                             \
+        permute3_code<code>(A, n, ss, B, ts, alpha, beta); \
+        return true;
+
+bool permute3(int sort_type, const double *A, const size_t *n, const size_t *ss, double *B, const size_t *ts,
+              double alpha, double beta) {
+    switch (sort_type) {
+        PERMUTE3_CASE(123)
+        PERMUTE3_CASE(132)
+        PERMUTE3_CASE(213)
+        PERMUTE3_CASE(231)
+        PERMUTE3_CASE(312)
+        PERMUTE3_CASE(321)
+        default:
+            return false;
+    }
+}
+
+#undef PERMUTE3_CASE
+
+#define SORT_REFERENCE_CASE(code)                         \
+    case code:                                            \
+        sort_reference<code>(dim, A, Bref, idx, 1.0, 0.0); \
+        break;
+
+void benchmark_tensor_sort(int dim, double min_time) {
+    outfile->Printf("\n");
+    outfile->Printf("                              ------------------------------- \n");
+    outfile->Printf("                              ====> DFOCC SORT BENCHMARKS <== \n");
+    outfile->Printf("                              ------------------------------- \n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  Parameters:\n");
+    outfile->Printf("   -Minimum runtime (per sort): %14.10f [s].\n", min_time);
+    outfile->Printf("   -Tensors are D x D x D x D doubles with D = %d.\n", dim);
+    outfile->Printf("\n");
+
+    outfile->Printf("  Notes:\n");
+    outfile->Printf("   -Table: per-element row_idx_/col_idx_ lookups, outer index threaded.\n");
+    outfile->Printf("   -Engine: tiled permute4 kernel specialized for the sort code.\n");
+    outfile->Printf("   -Max Diff: largest |Table - Engine| element.\n");
+    outfile->Printf("\n");
+
+    const int codes[] = {1243, 1324, 1342, 1423, 1432, 2134, 2143, 2314, 2413,
+                         2431, 3124, 3142, 3214, 3241, 4123, 4132, 4213};
+
+    size_t d = dim;
+    size_t pair = d * d;
+    double **A = block_matrix(pair, pair);
+    double **Bref = block_matrix(pair, pair);
+    double **Bnew = block_matrix(pair, pair);
+    int **idx = init_int_matrix(dim, dim);
+    for (int p = 0; p < dim; p++) {
+        for (int q = 0; q < dim; q++) {
+            idx[p][q] = q + p * dim;
+        }
+    }
+    for (size_t x = 0; x < pair * pair; x++) A[0][x] = std::rand() / (double)RAND_MAX;
+
+    size_t n[4] = {d, d, d, d};
+    size_t ss[4] = {d * pair, pair, d, 1};
+
+    outfile->Printf("  %-6s %14s %14s %9s %12s\n", "Code", "Table [s]", "Engine [s]", "Speedup", "Max Diff");
+    for (int code : codes) {
+        double T = 0.0;
+        size_t rounds = 0L;
+        Timer qq;
+        while (T < min_time) {
+            switch (code) {
+                SORT_REFERENCE_CASE(1243)
+                SORT_REFERENCE_CASE(1324)
+                SORT_REFERENCE_CASE(1342)
+                SORT_REFERENCE_CASE(1423)
+                SORT_REFERENCE_CASE(1432)
+                SORT_REFERENCE_CASE(2134)
+                SORT_REFERENCE_CASE(2143)
+                SORT_REFERENCE_CASE(2314)
+                SORT_REFERENCE_CASE(2413)
+                SORT_REFERENCE_CASE(2431)
+                SORT_REFERENCE_CASE(3124)
+                SORT_REFERENCE_CASE(3142)
+                SORT_REFERENCE_CASE(3214)
+                SORT_REFERENCE_CASE(3241)
+                SORT_REFERENCE_CASE(4123)
+                SORT_REFERENCE_CASE(4132)
+                SORT_REFERENCE_CASE(4213)
+            }
+            T = qq.get();
+            rounds++;
+        }
+        double t_ref = T / (double)rounds;
+
+        T = 0.0;
+        rounds = 0L;
+        Timer qq2;
+        while (T < min_time) {
+            permute4(code, A[0], n, ss, Bnew[0], ss, 1.0, 0.0);
+            T = qq2.get();
+            rounds++;
+        }
+        double t_new = T / (double)rounds;
+
+        double max_diff = 0.0;
+        for (size_t x = 0; x < pair * pair; x++) max_diff = std::max(max_diff, std::fabs(Bref[0][x] - Bnew[0][x]));
+
+        outfile->Printf("  %-6d %14.6E %14.6E %9.2f %12.3E\n", code, t_ref, t_new, t_ref / t_new, max_diff);
+    }
+    outfile->Printf("\n");
+
+    free_block(A);
+    free_block(Bref);
+    free_block(Bnew);
+    free_int_matrix(idx);
+}
+
+#undef SORT_REFERENCE_CASE
+
+}  // namespace dfoccwave
+}  // namespace psi
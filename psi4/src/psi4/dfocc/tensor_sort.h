@@ -0,0 +1,61 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _dfocc_tensor_sort_h_
+#define _dfocc_tensor_sort_h_
+
+#include <cstddef>
+
+namespace psi {
+namespace dfoccwave {
+
+/*
+ * Tiled permutation engine behind Tensor2d::sort, sort3a, and sort3b.
+ *
+ * The sort code names, for each target slot, the source index stored there
+ * (1432: B(p,s,r,q) = A(p,q,r,s)). n[k] and ss[k] are the extent and stride of
+ * source index k; ts[j] is the stride of target slot j. All offsets are 64-bit.
+ * On return B = alpha * perm(A) + beta * B. Returns false for an unknown code.
+ */
+bool permute4(int sort_type, const double *A, const size_t *n, const size_t *ss, double *B, const size_t *ts,
+              double alpha, double beta);
+bool permute3(int sort_type, const double *A, const size_t *n, const size_t *ss, double *B, const size_t *ts,
+              double alpha, double beta);
+
+/*
+ * Time every 4-index sort code used in dfocc on a D^4 tensor, against the
+ * per-element index-table loops that the engine replaced
+ * \param dim extent D of each index
+ * \param min_time minimum amount of time to run each sort [s]
+ */
+void benchmark_tensor_sort(int dim, double min_time);
+
+}  // namespace dfoccwave
+}  // namespace psi
+
+#endif  // _dfocc_tensor_sort_h_
@@ -36,6 +36,7 @@
 #include "psi4/libpsio/psio.h"
 #include "psi4/libiwl/iwl.hpp"
 #include "tensors.h"
+#include "tensor_sort.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
@@ -2481,397 +2482,12 @@ double *Tensor2d::column_vector(int n) {
 }  //
 
 void Tensor2d::sort(int sort_type, const SharedTensor2d &A, double alpha, double beta) {
-    int d1 = A->d1_;
-    int d2 = A->d2_;
-    int d3 = A->d3_;
-    int d4 = A->d4_;
-
-    if (sort_type == 1243) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = col_idx_[s][r];
-                        A2d_[pq][sr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pq][sr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1324) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int pr = row_idx_[p][r];
-                        int qs = col_idx_[q][s];
-                        A2d_[pr][qs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pr][qs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1342) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int pr = row_idx_[p][r];
-                        int sq = col_idx_[s][q];
-                        A2d_[pr][sq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pr][sq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1423) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = row_idx_[p][s];
-                        int qr = col_idx_[q][r];
-                        A2d_[ps][qr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[ps][qr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1432) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    int rq = col_idx_[r][q];
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = row_idx_[p][s];
-                        A2d_[ps][rq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[ps][rq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2134) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = row_idx_[q][p];
-                        A2d_[qp][rs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qp][rs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2143) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = row_idx_[q][p];
-                        int sr = col_idx_[s][r];
-                        A2d_[qp][sr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qp][sr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2314) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qr = row_idx_[q][r];
-                        int ps = col_idx_[p][s];
-                        A2d_[qr][ps] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qr][ps]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2341) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qr = row_idx_[q][r];
-                        int sp = col_idx_[s][p];
-                        A2d_[qr][sp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qr][sp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2413) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qs = row_idx_[q][s];
-                        int pr = col_idx_[p][r];
-                        A2d_[qs][pr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qs][pr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2431) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qs = row_idx_[q][s];
-                        int rp = col_idx_[r][p];
-                        A2d_[qs][rp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qs][rp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3124) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rp = row_idx_[r][p];
-                        int qs = col_idx_[q][s];
-                        A2d_[rp][qs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rp][qs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3142) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rp = row_idx_[r][p];
-                        int sq = col_idx_[s][q];
-                        A2d_[rp][sq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rp][sq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3214) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    int rq = row_idx_[r][q];
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = col_idx_[p][s];
-                        A2d_[rq][ps] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rq][ps]);
-                    }
-                }
-            }
-        }
-    }
+    // Strides follow row_idx_/col_idx_: (pq|rs) -> (p * d2 + q) * dim2 + r * d4 + s
+    size_t n[4] = {(size_t)A->d1_, (size_t)A->d2_, (size_t)A->d3_, (size_t)A->d4_};
+    size_t ss[4] = {(size_t)A->d2_ * A->dim2_, (size_t)A->dim2_, (size_t)A->d4_, 1};
+    size_t ts[4] = {(size_t)d2_ * dim2_, (size_t)dim2_, (size_t)d4_, 1};
 
-    else if (sort_type == 3241) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rq = row_idx_[r][q];
-                        int sp = col_idx_[s][p];
-                        A2d_[rq][sp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rq][sp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3412) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        A2d_[rs][pq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rs][pq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3421) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = col_idx_[q][p];
-                        A2d_[rs][qp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rs][qp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4123) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sp = row_idx_[s][p];
-                        int qr = col_idx_[q][r];
-                        A2d_[sp][qr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sp][qr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sp = row_idx_[s][p];
-                        int rq = col_idx_[r][q];
-                        A2d_[sp][rq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sp][rq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4213) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sq = row_idx_[s][q];
-                        int pr = col_idx_[p][r];
-                        A2d_[sq][pr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sq][pr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4231) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sq = row_idx_[s][q];
-                        int rp = col_idx_[r][p];
-                        A2d_[sq][rp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sq][rp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4312) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = row_idx_[s][r];
-                        A2d_[sr][pq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sr][pq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4321) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = row_idx_[s][r];
-                        int qp = col_idx_[q][p];
-                        A2d_[sr][qp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sr][qp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else {
+    if (!permute4(sort_type, A->A2d_ ? A->A2d_[0] : nullptr, n, ss, A2d_ ? A2d_[0] : nullptr, ts, alpha, beta)) {
         outfile->Printf("\tUnrecognized sort type!\n");
         throw PSIEXCEPTION("Unrecognized sort type!");
     }
@@ -2879,20 +2495,12 @@ void Tensor2d::sort(int sort_type, const SharedTensor2d &A, double alpha, double
 }  //
 
 void Tensor2d::sort3a(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta) {
-    if (sort_type == 132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                for (int r = 0; r < d3; r++) {
-                    int rq = q + (r * d2);
-                    int qr = r + (q * d3);
-                    A2d_[p][rq] = (alpha * A->A2d_[p][qr]) + (beta * A2d_[p][rq]);
-                }
-            }
-        }
-    }
+    // A(p,qr) -> A2d_(t0, t1 t2), with the column pair packed by the extent of t2
+    size_t n[3] = {(size_t)d1, (size_t)d2, (size_t)d3};
+    size_t ss[3] = {(size_t)A->dim2_, (size_t)d3, 1};
+    size_t ts[3] = {(size_t)dim2_, n[(sort_type % 10) - 1], 1};
 
-    else {
+    if (!permute3(sort_type, A->A2d_ ? A->A2d_[0] : nullptr, n, ss, A2d_ ? A2d_[0] : nullptr, ts, alpha, beta)) {
         outfile->Printf("\tUnrecognized sort type!\n");
         throw PSIEXCEPTION("Unrecognized sort type!");
     }
@@ -2900,72 +2508,12 @@ void Tensor2d::sort3a(int sort_type, int d1, int d2, int d3, const SharedTensor2
 }  //
 
 void Tensor2d::sort3b(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta) {
-    if (sort_type == 132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int pr = r + (p * d3);
-                    A2d_[pr][q] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[pr][q]);
-                }
-            }
-        }
-    }
+    // A(pq,r) -> A2d_(t0 t1, t2), with the row pair packed by the extent of t1
+    size_t n[3] = {(size_t)d1, (size_t)d2, (size_t)d3};
+    size_t ss[3] = {(size_t)d2 * A->dim2_, (size_t)A->dim2_, 1};
+    size_t ts[3] = {n[((sort_type / 10) % 10) - 1] * dim2_, (size_t)dim2_, 1};
 
-    else if (sort_type == 213) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                int qp = p + (q * d1);
-                for (int r = 0; r < d3; r++) {
-                    A2d_[qp][r] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[qp][r]);
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 312) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int rp = p + (r * d1);
-                    A2d_[rp][q] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[rp][q]);
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 231) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int qr = r + (q * d3);
-                    A2d_[qr][p] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[qr][p]);
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 321) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int rq = q + (r * d2);
-                    A2d_[rq][p] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[rq][p]);
-                }
-            }
-        }
-    }
-
-    else {
+    if (!permute3(sort_type, A->A2d_ ? A->A2d_[0] : nullptr, n, ss, A2d_ ? A2d_[0] : nullptr, ts, alpha, beta)) {
         outfile->Printf("\tUnrecognized sort type!\n");
         throw PSIEXCEPTION("Unrecognized sort type!");
     }
@@ -0,0 +1,272 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*
+ *  Integral-direct particle-particle ladder for conventional QCISD/CCSD/CEPA:
+ *
+ *      R(ab,ij) += sum_cd (ac|bd) tau(cd,ij)
+ *
+ *  tau is back-transformed to the AO basis, contracted with AO integrals
+ *  generated on the fly over unique, screened shell quartets, and the result
+ *  is transformed forward to the virtual space. The work is batched over ij
+ *  so that the two nbf^2 x nij intermediates fit in the integrals buffer.
+ */
+
+#include "ccsd.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+
+namespace psi {
+namespace fnocc {
+
+/**
+ *  size the ij batches of the AO ladder and grow the integrals buffer to hold them.
+ *  leaves dim = 0 if there is no room so AllocateMemory can retry with t2 on disk.
+ */
+void CoupledCluster::DefineTilingAOLadder(long int &dim) {
+    long int o = ndoccact;
+    long int v = nvirt;
+    long int oovv = o * o * v * v;
+    long int nbf = basisset_->nbf();
+
+    // same bookkeeping as DefineTilingCPU
+    long int ndoubles = memory / 8L;
+    ndoubles -= 2L * (oovv + o * v) + 2L * o * v + 2 * v * v + (o + v);
+    if (!t2_on_disk) ndoubles -= oovv;
+
+    // X(lambda,sigma,ij) and Y(mu,nu,ij) for one batch of ij
+    ladder_nij = ndoubles / (2L * nbf * nbf);
+    if (ladder_nij > o * o) ladder_nij = o * o;
+    if (ladder_nij < 1) {
+        if (t2_on_disk) throw PsiException("out of memory: AO ladder", __FILE__, __LINE__);
+        dim = 0;
+        return;
+    }
+    if (2L * nbf * nbf * ladder_nij > dim) dim = 2L * nbf * nbf * ladder_nij;
+
+    long int nbatch = (o * o + ladder_nij - 1) / ladder_nij;
+    outfile->Printf("        v(ab,cd) diagrams will be evaluated AO-direct in %3li blocks over ij.\n", nbatch);
+}
+
+/**
+ *  out(ab,ij) += sum_cd (ac|bd) tau(cd,ij); both v x v x o x o.
+ *  uses the integrals buffer as scratch.
+ */
+void CoupledCluster::AOLadder(double *tau, double *out) {
+    long int o = ndoccact;
+    long int v = nvirt;
+    long int o2 = o * o;
+    long int nbf = basisset_->nbf();
+    int nthreads = Process::environment.get_n_threads();
+
+    // active virtuals in the AO basis, in the same order as eps
+    SharedMatrix aotoso = reference_wavefunction_->aotoso();
+    auto Cvir = std::make_shared<Matrix>("AO virtuals", nbf, v);
+    double **Cvp = Cvir->pointer();
+    long int voff = 0;
+    for (int h = 0; h < nirrep_; h++) {
+        int nvirh = nmopi_[h] - frzvpi_[h] - doccpi_[h];
+        if (nsopi_[h] == 0 || nvirh == 0) continue;
+        C_DGEMM('n', 'n', nbf, nvirh, nsopi_[h], 1.0, aotoso->pointer(h)[0], nsopi_[h],
+                Ca_->pointer(h)[0] + doccpi_[h], nmopi_[h], 0.0, Cvp[0] + voff, v);
+        voff += nvirh;
+    }
+
+    // integral objects and significant shell pairs are set up once
+    if (ladder_eri.empty()) {
+        auto factory = std::make_shared<IntegralFactory>(basisset_);
+        ladder_eri.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+        for (int thread = 1; thread < nthreads; thread++) {
+            ladder_eri.push_back(std::shared_ptr<TwoBodyAOInt>(ladder_eri[0]->clone()));
+        }
+        for (int M = 0; M < basisset_->nshell(); M++) {
+            for (int N = 0; N <= M; N++) {
+                if (ladder_eri[0]->shell_pair_significant(M, N)) ladder_pairs.push_back(std::make_pair(M, N));
+            }
+        }
+    }
+    size_t npair = ladder_pairs.size();
+
+    // (pq|mn) ordering of each quartet for the bra-ket transposed terms
+    long int maxf = basisset_->max_function_per_shell();
+    std::vector<std::vector<double>> gT(nthreads, std::vector<double>(maxf * maxf * maxf * maxf));
+
+    // rows of Y belonging to one shell are updated under that shell's lock
+    int nshell = basisset_->nshell();
+#ifdef _OPENMP
+    std::vector<omp_lock_t> locks(nshell);
+    for (int M = 0; M < nshell; M++) omp_init_lock(&locks[M]);
+#endif
+
+    for (long int ij0 = 0; ij0 < o2; ij0 += ladder_nij) {
+        long int nij = (ij0 + ladder_nij > o2) ? o2 - ij0 : ladder_nij;
+        double *X = integrals;
+        double *Y = integrals + nbf * nbf * nij;
+
+        // X(lambda,sigma,ij) = sum_cd C(lambda,c) C(sigma,d) tau(cd,ij), via (c,sigma,ij) in Y
+        for (long int c = 0; c < v; c++) {
+            C_DGEMM('n', 'n', nbf, nij, v, 1.0, Cvp[0], v, tau + c * v * o2 + ij0, o2, 0.0, Y + c * nbf * nij, nij);
+        }
+        C_DGEMM('n', 'n', nbf, nbf * nij, v, 1.0, Cvp[0], v, Y, nbf * nij, 0.0, X, nbf * nij);
+
+        // Y(mu,nu,ij) = sum_lambda,sigma (mu lambda|nu sigma) X(lambda,sigma,ij)
+        memset((void *)Y, '\0', nbf * nbf * nij * sizeof(double));
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+        for (size_t MN = 0; MN < npair; MN++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            int M = ladder_pairs[MN].first;
+            int N = ladder_pairs[MN].second;
+            int Msize = basisset_->shell(M).nfunction();
+            int Nsize = basisset_->shell(N).nfunction();
+            long int Moff = basisset_->shell(M).function_index();
+            long int Noff = basisset_->shell(N).function_index();
+            double *gt = gT[thread].data();
+
+            for (size_t PQ = 0; PQ <= MN; PQ++) {
+                int P = ladder_pairs[PQ].first;
+                int Q = ladder_pairs[PQ].second;
+                if (!ladder_eri[thread]->shell_significant(M, N, P, Q)) continue;
+                if (ladder_eri[thread]->compute_shell(M, N, P, Q) == 0) continue;
+                auto *g = const_cast<double *>(ladder_eri[thread]->buffer());
+
+                int Psize = basisset_->shell(P).nfunction();
+                int Qsize = basisset_->shell(Q).nfunction();
+                long int Poff = basisset_->shell(P).function_index();
+                long int Qoff = basisset_->shell(Q).function_index();
+                int MNsize = Msize * Nsize;
+                int PQsize = Psize * Qsize;
+
+                // each unique quartet stands in for all eight permutations
+                double f = 1.0;
+                if (M == N) f *= 0.5;
+                if (P == Q) f *= 0.5;
+                if (MN == PQ) f *= 0.5;
+
+                for (int mn = 0; mn < MNsize; mn++) {
+                    for (int pq = 0; pq < PQsize; pq++) {
+                        gt[pq * MNsize + mn] = g[mn * PQsize + pq];
+                    }
+                }
+
+                // Y(m,p) += (mn|pq) X(n,q), Y(m,q) += (mn|pq) X(n,p)
+#ifdef _OPENMP
+                omp_set_lock(&locks[M]);
+#endif
+                for (int m = 0; m < Msize; m++) {
+                    for (int n = 0; n < Nsize; n++) {
+                        double *gmn = g + (m * Nsize + n) * PQsize;
+                        C_DGEMM('n', 'n', Psize, nij, Qsize, f, gmn, Qsize, X + ((Noff + n) * nbf + Qoff) * nij, nij,
+                                1.0, Y + ((Moff + m) * nbf + Poff) * nij, nij);
+                        C_DGEMM('t', 'n', Qsize, nij, Psize, f, gmn, Qsize, X + ((Noff + n) * nbf + Poff) * nij, nij,
+                                1.0, Y + ((Moff + m) * nbf + Qoff) * nij, nij);
+                    }
+                }
+#ifdef _OPENMP
+                omp_unset_lock(&locks[M]);
+#endif
+
+                // Y(n,p) += (mn|pq) X(m,q), Y(n,q) += (mn|pq) X(m,p)
+#ifdef _OPENMP
+                omp_set_lock(&locks[N]);
+#endif
+                for (int m = 0; m < Msize; m++) {
+                    for (int n = 0; n < Nsize; n++) {
+                        double *gmn = g + (m * Nsize + n) * PQsize;
+                        C_DGEMM('n', 'n', Psize, nij, Qsize, f, gmn, Qsize, X + ((Moff + m) * nbf + Qoff) * nij, nij,
+                                1.0, Y + ((Noff + n) * nbf + Poff) * nij, nij);
+                        C_DGEMM('t', 'n', Qsize, nij, Psize, f, gmn, Qsize, X + ((Moff + m) * nbf + Poff) * nij, nij,
+                                1.0, Y + ((Noff + n) * nbf + Qoff) * nij, nij);
+                    }
+                }
+#ifdef _OPENMP
+                omp_unset_lock(&locks[N]);
+#endif
+
+                // Y(p,m) += (pq|mn) X(q,n), Y(p,n) += (pq|mn) X(q,m)
+#ifdef _OPENMP
+                omp_set_lock(&locks[P]);
+#endif
+                for (int p = 0; p < Psize; p++) {
+                    for (int q = 0; q < Qsize; q++) {
+                        double *gpq = gt + (p * Qsize + q) * MNsize;
+                        C_DGEMM('n', 'n', Msize, nij, Nsize, f, gpq, Nsize, X + ((Qoff + q) * nbf + Noff) * nij, nij,
+                                1.0, Y + ((Poff + p) * nbf + Moff) * nij, nij);
+                        C_DGEMM('t', 'n', Nsize, nij, Msize, f, gpq, Nsize, X + ((Qoff + q) * nbf + Moff) * nij, nij,
+                                1.0, Y + ((Poff + p) * nbf + Noff) * nij, nij);
+                    }
+                }
+#ifdef _OPENMP
+                omp_unset_lock(&locks[P]);
+#endif
+
+                // Y(q,m) += (pq|mn) X(p,n), Y(q,n) += (pq|mn) X(p,m)
+#ifdef _OPENMP
+                omp_set_lock(&locks[Q]);
+#endif
+                for (int p = 0; p < Psize; p++) {
+                    for (int q = 0; q < Qsize; q++) {
+                        double *gpq = gt + (p * Qsize + q) * MNsize;
+                        C_DGEMM('n', 'n', Msize, nij, Nsize, f, gpq, Nsize, X + ((Poff + p) * nbf + Noff) * nij, nij,
+                                1.0, Y + ((Qoff + q) * nbf + Moff) * nij, nij);
+                        C_DGEMM('t', 'n', Nsize, nij, Msize, f, gpq, Nsize, X + ((Poff + p) * nbf + Moff) * nij, nij,
+                                1.0, Y + ((Qoff + q) * nbf + Noff) * nij, nij);
+                    }
+                }
+#ifdef _OPENMP
+                omp_unset_lock(&locks[Q]);
+#endif
+            }
+        }
+
+        // out(ab,ij) += sum_mu,nu C(mu,a) C(nu,b) Y(mu,nu,ij), via (a,nu,ij) in X
+        C_DGEMM('t', 'n', v, nbf * nij, nbf, 1.0, Cvp[0], v, Y, nbf * nij, 0.0, X, nbf * nij);
+        for (long int a = 0; a < v; a++) {
+            C_DGEMM('t', 'n', v, nij, nbf, 1.0, Cvp[0], v, X + a * nbf * nij, nij, 1.0, out + a * v * o2 + ij0, o2);
+        }
+    }
+
+#ifdef _OPENMP
+    for (int M = 0; M < nshell; M++) omp_destroy_lock(&locks[M]);
+#endif
+}
+
+}  // namespace fnocc
+}  // namespace psi
@@ -147,6 +147,10 @@ void CoupledCluster::common_init() {
     // by default, t2 will be held in core
     t2_on_disk = false;
 
+    // (ac|bd) from the sorted MO file or AO-direct
+    ao_ladder = (options_.get_str("AO_BASIS") == "DIRECT");
+    ladder_nij = 0;
+
     // for df-bccd
     brueckner_iter = 0;
 }
@@ -705,19 +709,24 @@ void CoupledCluster::DefineTilingCPU() {
     tilesize = v * (v + 1L) / 2L;
     ntiles = 1L;
 
-    // tiling for vabcd diagram
+    // tiling for vabcd diagram (no v^4 buffer for the AO-direct ladder; see DefineTilingAOLadder)
     long int fulltile = v * (v + 1L) / 2L;
-    ntiles = 1L;
-    tilesize = fulltile / 1L;
-    if (ntiles * tilesize < fulltile) tilesize++;
-    while (fulltile * tilesize > ndoubles) {
-        ntiles++;
-        tilesize = fulltile / ntiles;
+    if (ao_ladder) {
+        ntiles = 0L;
+        tilesize = lasttile = 0L;
+    } else {
+        ntiles = 1L;
+        tilesize = fulltile / 1L;
         if (ntiles * tilesize < fulltile) tilesize++;
-    }
-    lasttile = fulltile - (ntiles - 1L) * tilesize;
+        while (fulltile * tilesize > ndoubles) {
+            ntiles++;
+            tilesize = fulltile / ntiles;
+            if (ntiles * tilesize < fulltile) tilesize++;
+        }
+        lasttile = fulltile - (ntiles - 1L) * tilesize;
 
-    outfile->Printf("        v(ab,cd) diagrams will be evaluated in %3li blocks.\n", ntiles);
+        outfile->Printf("        v(ab,cd) diagrams will be evaluated in %3li blocks.\n", ntiles);
+    }
 
     // ov^3 type 1:
     if (v > ndoubles) {
@@ -813,6 +822,7 @@ void CoupledCluster::AllocateMemory() {
     if (tilesize * fulltile > dim) dim = tilesize * fulltile;
     if (ovtilesize * v * v > dim) dim = ovtilesize * v * v;
     if (ov2tilesize * v > dim) dim = ov2tilesize * v;
+    if (ao_ladder) DefineTilingAOLadder(dim);
 
     // if integrals buffer isn't at least o^2v^2, try tiling again assuming t2 is on disk.
     if (dim < o * o * v * v) {
@@ -826,6 +836,7 @@ void CoupledCluster::AllocateMemory() {
         if (tilesize * fulltile > dim) dim = tilesize * fulltile;
         if (ovtilesize * v * v > dim) dim = ovtilesize * v * v;
         if (ov2tilesize * v > dim) dim = ov2tilesize * v;
+        if (ao_ladder) DefineTilingAOLadder(dim);
 
         if (dim < o * o * v * v) {
             throw PsiException("out of memory: general buffer cannot accommodate T2", __FILE__, __LINE__);
@@ -1563,6 +1574,42 @@ void CoupledCluster::Vabcd2(CCTaskParams params) {
     psio.reset();
 }
 
+/**
+ *  (ac|bd) ladder, integral-direct in the AO basis
+ */
+void CoupledCluster::Vabcd_direct(CCTaskParams params) {
+    long int id, i, j, a, b, o, v;
+    o = ndoccact;
+    v = nvirt;
+    auto psio = std::make_shared<PSIO>();
+    if (t2_on_disk) {
+        psio->open(PSIF_DCC_T2, PSIO_OPEN_OLD);
+        psio->read_entry(PSIF_DCC_T2, "t2", (char *)&tempt[0], o * o * v * v * sizeof(double));
+        psio->close(PSIF_DCC_T2, 1);
+    } else {
+        C_DCOPY(o * o * v * v, tb, 1, tempt, 1);
+    }
+    if (isccsd) {
+        for (a = 0, id = 0; a < v; a++) {
+            for (b = 0; b < v; b++) {
+                for (i = 0; i < o; i++) {
+                    for (j = 0; j < o; j++) {
+                        tempt[id++] += t1[a * o + i] * t1[b * o + j];
+                    }
+                }
+            }
+        }
+    }
+
+    // this is the last diagram that contributes to the residual, so leave it in tempv
+    psio->open(PSIF_DCC_R2, PSIO_OPEN_OLD);
+    psio->read_entry(PSIF_DCC_R2, "residual", (char *)&tempv[0], o * o * v * v * sizeof(double));
+    psio->close(PSIF_DCC_R2, 1);
+    psio.reset();
+
+    AOLadder(tempt, tempv);
+}
+
 /**
  *  K from the SJS paper
  */
@@ -2126,6 +2173,14 @@ void CoupledCluster::DefineTasks() {
     CCTasklist[ncctasks].name = (char *)malloc(100 * sizeof(char));
     sprintf(CCTasklist[ncctasks++].name, "I'(i,j), I(i,j), I(i,a)");
 
+    if (ao_ladder) {
+        // ao basis, integral-direct. also the last diagram; the residual stays in memory
+        CCTasklist[ncctasks].func = &psi::fnocc::CoupledCluster::Vabcd_direct;
+        CCTasklist[ncctasks].name = (char *)malloc(100 * sizeof(char));
+        sprintf(CCTasklist[ncctasks++].name, "t2 <-- (ac|bd) ao      ");
+        return;
+    }
+
     // mo basis, sjs packing
     CCTasklist[ncctasks].func = &psi::fnocc::CoupledCluster::Vabcd1;
     CCTasklist[ncctasks].name = (char *)malloc(100 * sizeof(char));
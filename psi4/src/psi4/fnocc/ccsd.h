@@ -40,6 +40,8 @@
 PSI_API long int Position(long int i, long int j);
 
 namespace psi {
+class TwoBodyAOInt;
+
 namespace fnocc {
 
 class CoupledCluster : public Wavefunction {
@@ -132,6 +134,7 @@ class CoupledCluster : public Wavefunction {
     void CPU_t1_vmeai_linear(CCTaskParams params);
     void Vabcd1_linear(CCTaskParams params);
     void Vabcd2_linear(CCTaskParams params);
+    void Vabcd_direct_linear(CCTaskParams params);
 
     /// linear diagrams for mp4
     void I2iabj_quadratic(CCTaskParams params);
@@ -167,6 +170,7 @@ class CoupledCluster : public Wavefunction {
     void Vabcd1(CCTaskParams params);
     void Vabcd2(CCTaskParams params);
     void Vabcd(CCTaskParams params);
+    void Vabcd_direct(CCTaskParams params);
     void K(CCTaskParams params);
     void TwoJminusK(CCTaskParams params);
 
@@ -213,6 +217,16 @@ class CoupledCluster : public Wavefunction {
     long int ovtilesize, lastovtile, lastov2tile, ov2tilesize;
     long int tilesize, lasttile, maxelem;
     long int ntiles, novtiles, nov2tiles;
+
+    /// AO-direct (ac|bd) ladder: out(ab,ij) += sum_cd (ac|bd) tau(cd,ij)
+    bool ao_ladder;
+    void AOLadder(double *tau, double *out);
+    void DefineTilingAOLadder(long int &dim);
+    /// number of ij pairs per AO ladder batch
+    long int ladder_nij;
+    /// one integral object per thread and the significant shell pairs
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ladder_eri;
+    std::vector<std::pair<int, int>> ladder_pairs;
 };
 
 // DF CC class
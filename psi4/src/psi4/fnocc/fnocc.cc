@@ -56,8 +56,11 @@ SharedWavefunction fnocc(SharedWavefunction ref_wfn, Options &options) {
         outfile->Printf("        ==> Transform all two-electron integrals <==\n");
         outfile->Printf("\n");
 
+        // the AO-direct ladder never needs (ab|cd) in the MO basis
+        bool ao_ladder = (options.get_str("AO_BASIS") == "DIRECT");
         std::vector<std::shared_ptr<MOSpace> > spaces;
         spaces.push_back(MOSpace::all);
+        if (ao_ladder) spaces.push_back(MOSpace::occ);
         std::shared_ptr<IntegralTransform> ints = std::make_shared<IntegralTransform>(
             wfn, spaces, IntegralTransform::TransformationType::Restricted, IntegralTransform::OutputType::IWLOnly,
             IntegralTransform::MOOrdering::QTOrder, IntegralTransform::FrozenOrbitals::OccAndVir, false);
@@ -68,7 +71,14 @@ SharedWavefunction fnocc(SharedWavefunction ref_wfn, Options &options) {
         ints->initialize();
         timer_off("FNOCC: Initializing Integrals");
         timer_on("FNOCC: Two Elec Int Trans.");
-        ints->transform_tei(MOSpace::all, MOSpace::all, MOSpace::all, MOSpace::all);
+        if (ao_ladder) {
+            // every other class has an occupied index that can be brought to the front, so (ip|qr) is
+            // enough.  the sort does not care about index order and simply overwrites the classes with
+            // several occupied indices, which show up more than once.
+            ints->transform_tei(MOSpace::occ, MOSpace::all, MOSpace::all, MOSpace::all);
+        } else {
+            ints->transform_tei(MOSpace::all, MOSpace::all, MOSpace::all, MOSpace::all);
+        }
         timer_off("FNOCC: Two Elec Int Trans.");
         tstop();
 
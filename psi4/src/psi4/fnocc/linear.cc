@@ -568,6 +568,27 @@ void CoupledCluster::Vabcd2_linear(CCTaskParams params) {
     psio->close(PSIF_DCC_R2, 1);
     psio.reset();
 }
+/**
+ *  (ac|bd) ladder, integral-direct in the AO basis
+ */
+void CoupledCluster::Vabcd_direct_linear(CCTaskParams params) {
+    long int o = ndoccact;
+    long int v = nvirt;
+    auto psio = std::make_shared<PSIO>();
+    if (t2_on_disk) {
+        psio->open(PSIF_DCC_T2, PSIO_OPEN_OLD);
+        psio->read_entry(PSIF_DCC_T2, "t2", (char*)&tempt[0], o * o * v * v * sizeof(double));
+        psio->close(PSIF_DCC_T2, 1);
+    } else {
+        C_DCOPY(o * o * v * v, tb, 1, tempt, 1);
+    }
+    psio->open(PSIF_DCC_R2, PSIO_OPEN_OLD);
+    psio->read_entry(PSIF_DCC_R2, "residual", (char*)&tempv[0], o * o * v * v * sizeof(double));
+    psio->close(PSIF_DCC_R2, 1);
+    psio.reset();
+
+    AOLadder(tempt, tempv);
+}
 /**
  *  Build and use I2iabj
  */
@@ -728,6 +749,10 @@ void CoupledCluster::DefineLinearTasks() {
     LTasklist[nltasks++].func = &psi::fnocc::CoupledCluster::CPU_t1_vmaef_linear;
     LTasklist[nltasks++].func = &psi::fnocc::CoupledCluster::CPU_I2p_abci_refactored_term1_linear;
     LTasklist[nltasks++].func = &psi::fnocc::CoupledCluster::CPU_t1_vmeai_linear;
+    if (ao_ladder) {
+        LTasklist[nltasks++].func = &psi::fnocc::CoupledCluster::Vabcd_direct_linear;
+        return;
+    }
     LTasklist[nltasks++].func = &psi::fnocc::CoupledCluster::Vabcd1_linear;
     // this is the last diagram that contributes to doubles residual,
     // so we can keep it in memory rather than writing and rereading
@@ -38,6 +38,7 @@
 
 #include "blas.h"
 #include "ccsd.h"
+#include "triples_tasks.h"
 
 namespace psi {
 namespace fnocc {
@@ -201,13 +202,6 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
     psio->read_entry(PSIF_DCC_IAJB, "E2iajb", (char *)&E2klcd[0], vvoo * sizeof(double));
     psio->close(PSIF_DCC_IAJB, 1);
 
-    double *etrip = (double *)malloc(nthreads * sizeof(double));
-    for (int i = 0; i < nthreads; i++) etrip[i] = 0.0;
-
-    std::time_t stop, start = std::time(nullptr);
-    int pct10, pct20, pct30, pct40, pct50, pct60, pct70, pct80, pct90;
-    pct10 = pct20 = pct30 = pct40 = pct50 = pct60 = pct70 = pct80 = pct90 = 0;
-
     long int nabc = 0;
     for (long int a = 0; a < v; a++) {
         for (long int b = 0; b <= a; b++) {
@@ -232,15 +226,8 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
     outfile->Printf("        Number of abc combinations: %i\n", nabc);
     outfile->Printf("\n");
 
-    for (int i = 0; i < nthreads; i++) etrip[i] = 0.0;
-
-    outfile->Printf("        Computing (T) correction...\n");
-    outfile->Printf("\n");
-    outfile->Printf("        %% complete  total time\n");
-
-    /**
-      *  if there is enough memory to explicitly thread, do so
-      */
+    // the unique abc are split into tasks that can be checkpointed and shared among processes
+    TriplesTasks tasks(options_, "abc", nabc, o, v, ccmethod, escf, ccmethod == 2 ? emp2 : eccsd);
 
     std::vector<std::shared_ptr<PSIO> > mypsio;
     for (int i = 0; i < nthreads; i++) {
@@ -248,17 +235,13 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
         mypsio[i]->open(PSIF_DCC_ABCI4, PSIO_OPEN_OLD);
     }
 
+    double myet = 0.0;
     if (threaded) {
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-        for (long int ind = 0; ind < nabc; ind++) {
+        auto abc_energy = [&](long int ind, int thread) -> double {
             long int a = abc[ind][0];
             long int b = abc[ind][1];
             long int c = abc[ind][2];
-
-            int thread = 0;
-#ifdef _OPENMP
-            thread = omp_get_thread_num();
-#endif
+            double etask = 0.0;
 
             // auto mypsio = std::make_shared<PSIO>();
             // mypsio->open(PSIF_DCC_ABCI4,PSIO_OPEN_OLD);
@@ -380,7 +363,7 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
                 }
                 tripval += dum;
             }
-            etrip[thread] += 3.0 * tripval * abcfac;
+            etask += 3.0 * tripval * abcfac;
 
             // Z3(ijk) = -2(Z(ijk) + jki + kij) + ikj + jik + kji
             for (long int i = 0; i < o; i++) {
@@ -420,7 +403,7 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
                 }
                 tripval += dum;
             }
-            etrip[thread] += tripval * abcfac;
+            etask += tripval * abcfac;
 
             // the second bit
             for (long int i = 0; i < o; i++) {
@@ -460,47 +443,13 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
                 }
                 tripval += dum;
             }
-            etrip[thread] += tripval * abcfac;
-
-            // print out update
-            if (thread == 0) {
-                int print = 0;
-                stop = std::time(nullptr);
-                if ((double)ind / nabc >= 0.1 && !pct10) {
-                    pct10 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.2 && !pct20) {
-                    pct20 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.3 && !pct30) {
-                    pct30 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.4 && !pct40) {
-                    pct40 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.5 && !pct50) {
-                    pct50 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.6 && !pct60) {
-                    pct60 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.7 && !pct70) {
-                    pct70 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.8 && !pct80) {
-                    pct80 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.9 && !pct90) {
-                    pct90 = 1;
-                    print = 1;
-                }
-                if (print) {
-                    outfile->Printf("              %3.1lf  %8d s\n", 100.0 * ind / nabc, (int)stop - (int)start);
-                }
-            }
+            etask += tripval * abcfac;
+
             // mypsio->close(PSIF_DCC_ABCI4,1);
             // mypsio.reset();
-        }
+            return etask;
+        };
+        myet = tasks.compute(nthreads, abc_energy);
     } else {
         outfile->Printf("on the to do pile!\n");
         delete[] name;
@@ -508,7 +457,6 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
         free(E2ijak);
         for (int i = 0; i < nthreads; i++) free(Z4[i]);
         free(Z4);
-        free(etrip);
         nabc = 0;
         for (long int a = 0; a < v; a++)
             for (long int b = 0; b <= a; b++)
@@ -521,9 +469,6 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
         mypsio[i]->close(PSIF_DCC_ABCI4, 1);
     }
 
-    double myet = 0.0;
-    for (int i = 0; i < nthreads; i++) myet += etrip[i];
-
     // ccsd(t) or qcisd(t)
     if (ccmethod <= 1) {
         et = myet;
@@ -562,7 +507,6 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
     free(Z3);
     free(Z4);
     free(E2abci);
-    free(etrip);
 
     nabc = 0;
     for (long int a = 0; a < v; a++)
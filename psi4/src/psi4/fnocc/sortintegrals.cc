@@ -133,6 +133,10 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
 
     lastbuf = Buf->lastbuf;
 
+    // with the AO-direct ladder, (ab|cd) is never needed in the MO basis
+    bool ao_ladder = (options.get_str("AO_BASIS") == "DIRECT");
+    size_t v4 = ao_ladder ? 0 : v * (v + 1) / 2 * v * (v + 1) / 2;
+
     // buckets for integrals:
     struct integral *ijkl, *klcd, *akjc, **abci1, **abci3;
     struct integral **abci5, **abcd1, **abcd2, *ijak, *ijak2;
@@ -148,17 +152,16 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
     if (maxblock < o * o * o * v) maxblock = o * o * o * v;
     if (maxblock < o * o * v * v) maxblock = o * o * v * v;
     if (maxblock < o * v * v * v) maxblock = o * v * v * v;
-    if (maxblock < 2 * v * (v + 1) / 2 * v * (v + 1) / 2) maxblock = 2 * v * (v + 1) / 2 * v * (v + 1) / 2;
+    if (maxblock < 2 * v4) maxblock = 2 * v4;
 
     // maxelem should be, at max, the size of the biggest block
     if (maxelem > maxblock) maxelem = maxblock;
 
     outfile->Printf("        CC integral sort will use                   %7.2lf mb\n",
                     maxelem * (sizeof(double) + sizeof(struct integral)) / 1024. / 1024.);
-    if (maxelem < 2 * v * (v + 1) / 2 * v * (v + 1) / 2) {
+    if (maxelem < 2 * v4) {
         outfile->Printf("       (for most efficient sort, increase memory by %7.2lf mb)\n",
-                        (2 * v * (v + 1) / 2 * v * (v + 1) / 2 - maxelem) * (sizeof(double) + sizeof(struct integral)) /
-                            1024. / 1024.);
+                        (2 * v4 - maxelem) * (sizeof(double) + sizeof(struct integral)) / 1024. / 1024.);
     }
     outfile->Printf("\n");
 
@@ -166,7 +169,7 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
     size_t filesize;
     size_t vtri = v * (v + 1L) / 2L;
     size_t nfiles = 0;
-    for (size_t i = 1; i <= vtri * vtri; i++) {
+    for (size_t i = 1; i <= vtri * vtri && !ao_ladder; i++) {
         if (maxelem >= vtri * vtri / i) {
             filesize = vtri * vtri / i;
             if (i * filesize < vtri * vtri) filesize++;
@@ -174,7 +177,7 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
             break;
         }
     }
-    if (nfiles == 0) throw PsiException("how is this possible? (ab|cd)", __FILE__, __LINE__);
+    if (nfiles == 0 && !ao_ladder) throw PsiException("how is this possible? (ab|cd)", __FILE__, __LINE__);
 
     // how many (ab|ci) files?
     size_t ov3filesize;
@@ -269,10 +272,12 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
     psio->close(PSIF_DCC_ABCI2, 1);
     psio->open(PSIF_DCC_ABCI3, PSIO_OPEN_NEW);
     psio->close(PSIF_DCC_ABCI3, 1);
-    psio->open(PSIF_DCC_ABCD1, PSIO_OPEN_NEW);
-    psio->close(PSIF_DCC_ABCD1, 1);
-    psio->open(PSIF_DCC_ABCD2, PSIO_OPEN_NEW);
-    psio->close(PSIF_DCC_ABCD2, 1);
+    if (!ao_ladder) {
+        psio->open(PSIF_DCC_ABCD1, PSIO_OPEN_NEW);
+        psio->close(PSIF_DCC_ABCD1, 1);
+        psio->open(PSIF_DCC_ABCD2, PSIO_OPEN_NEW);
+        psio->close(PSIF_DCC_ABCD2, 1);
+    }
     psio->open(PSIF_DCC_IJAB, PSIO_OPEN_NEW);
     psio->close(PSIF_DCC_IJAB, 1);
     size_t nijkl = 0;
@@ -318,7 +323,7 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
         psio->close(PSIF_DCC_SORT_START + k + nfiles, 1);
     }
     // (ab|ci) files come after (ab|cd) files:
-    for (size_t k = 0; k < nfiles; k++) {
+    for (size_t k = 0; k < ov3nfiles; k++) {
         psio->open(PSIF_DCC_SORT_START + k + 2 * nfiles, PSIO_OPEN_NEW);
         psio->open(PSIF_DCC_SORT_START + k + 2 * nfiles + ov3nfiles, PSIO_OPEN_NEW);
         psio->open(PSIF_DCC_SORT_START + k + 2 * nfiles + 2 * ov3nfiles, PSIO_OPEN_NEW);
@@ -421,7 +426,7 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
                             PSIF_DCC_SORT_START + 2 * nfiles + ov3nfiles, ov3nfiles);
             abci5_terms_new(val, p, q, r, s, o, v, nabci5, totalnabci5, abci5, ov3filesize, bucketsize, abci5_addr,
                             PSIF_DCC_SORT_START + 2 * nfiles + 2 * ov3nfiles, ov3nfiles);
-        } else if (nocc == 0) {
+        } else if (nocc == 0 && !ao_ladder) {
             val = (double)valptr[Buf->idx];
             abcd1_terms_new(val, pq, rs, p, q, r, s, o, v, nabcd1, totalnabcd1, abcd1, filesize, bucketsize, abcd1_addr,
                             nfiles);
@@ -527,7 +532,7 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
                                 PSIF_DCC_SORT_START + 2 * nfiles + ov3nfiles, ov3nfiles);
                 abci5_terms_new(val, p, q, r, s, o, v, nabci5, totalnabci5, abci5, ov3filesize, bucketsize, abci5_addr,
                                 PSIF_DCC_SORT_START + 2 * nfiles + 2 * ov3nfiles, ov3nfiles);
-            } else if (nocc == 0) {
+            } else if (nocc == 0 && !ao_ladder) {
                 val = (double)valptr[Buf->idx];
                 abcd1_terms_new(val, pq, rs, p, q, r, s, o, v, nabcd1, totalnabcd1, abcd1, filesize, bucketsize,
                                 abcd1_addr, nfiles);
@@ -663,14 +668,16 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
     // SortBlock(totalnabci5,o*v*v*v,integralbuffer,tmp,PSIF_DCC_ABCI2,"E2abci2",maxelem);
     outfile->Printf("done.\n");
 
-    outfile->Printf("        Sort (AB|CD) 1/2....");
-    SortBlockNewNew(totalnabcd1, v * (v + 1) / 2 * v * (v + 1) / 2, integralbuffer2, tmp, PSIF_DCC_ABCD1, "E2abcd1",
-                    maxelem, PSIF_DCC_SORT_START, nfiles);
-    outfile->Printf("done.\n");
-    outfile->Printf("        Sort (AB|CD) 2/2....");
-    SortBlockNewNew(totalnabcd2, v * (v + 1) / 2 * v * (v + 1) / 2, integralbuffer2, tmp, PSIF_DCC_ABCD2, "E2abcd2",
-                    maxelem, PSIF_DCC_SORT_START + nfiles, nfiles);
-    outfile->Printf("done.\n");
+    if (!ao_ladder) {
+        outfile->Printf("        Sort (AB|CD) 1/2....");
+        SortBlockNewNew(totalnabcd1, v4, integralbuffer2, tmp, PSIF_DCC_ABCD1, "E2abcd1", maxelem, PSIF_DCC_SORT_START,
+                        nfiles);
+        outfile->Printf("done.\n");
+        outfile->Printf("        Sort (AB|CD) 2/2....");
+        SortBlockNewNew(totalnabcd2, v4, integralbuffer2, tmp, PSIF_DCC_ABCD2, "E2abcd2", maxelem,
+                        PSIF_DCC_SORT_START + nfiles, nfiles);
+        outfile->Printf("done.\n");
+    }
     outfile->Printf("\n");
 
     delete[] integralbuffer2;
@@ -718,6 +725,13 @@ void SortAllIntegrals(iwlbuf *Buf, int nfzc, int nfzv, int norbs, int ndoccact,
     psio->close(PSIF_DCC_ABCI3, 1);
     psio->close(PSIF_DCC_ABCI5, 1);
 
+    // nothing to combine when the ladder is evaluated AO-direct
+    if (ao_ladder) {
+        delete[] tmp;
+        delete[] tmp2;
+        return;
+    }
+
     /**
       *  Combine ABCD1 and ABCD2 integrals if SJS packing
       */
@@ -38,6 +38,7 @@
 
 #include "blas.h"
 #include "ccsd.h"
+#include "triples_tasks.h"
 
 namespace psi {
 namespace fnocc {
@@ -162,29 +163,14 @@ PsiReturnType CoupledCluster::triples() {
     psio->read_entry(PSIF_DCC_IAJB, "E2iajb", (char *)&E2klcd[0], vvoo * sizeof(double));
     psio->close(PSIF_DCC_IAJB, 1);
 
-    double *etrip = (double *)malloc(nthreads * sizeof(double));
-    for (int i = 0; i < nthreads; i++) etrip[i] = 0.0;
-    outfile->Printf("        Computing (T) correction...\n");
-    outfile->Printf("\n");
-    outfile->Printf("        %% complete  total time\n");
-
-    std::time_t stop, start = std::time(nullptr);
-    int pct10, pct20, pct30, pct40, pct50, pct60, pct70, pct80, pct90;
-    pct10 = pct20 = pct30 = pct40 = pct50 = pct60 = pct70 = pct80 = pct90 = 0;
+    // the unique ijk are split into tasks that can be checkpointed and shared among processes
+    TriplesTasks tasks(options_, "ijk", nijk, o, v, ccmethod, escf, ccmethod == 2 ? emp2 : eccsd);
 
-/**
-  *  if there is enough memory to explicitly thread, do so
-  */
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-    for (long int ind = 0; ind < nijk; ind++) {
+    auto ijk_energy = [&](long int ind, int thread) -> double {
         long int i = ijk[ind][0];
         long int j = ijk[ind][1];
         long int k = ijk[ind][2];
-
-        int thread = 0;
-#ifdef _OPENMP
-        thread = omp_get_thread_num();
-#endif
+        double etask = 0.0;
 
         auto mypsio = std::make_shared<PSIO>();
         mypsio->open(PSIF_DCC_ABCI, PSIO_OPEN_OLD);
@@ -301,7 +287,7 @@ PsiReturnType CoupledCluster::triples() {
                 }
             }
         }
-        etrip[thread] += tripval * ijkfac;
+        etask += tripval * ijkfac;
         // the second bit
         for (long int a = 0; a < v; a++) {
             for (long int b = 0; b < v; b++) {
@@ -335,49 +321,12 @@ PsiReturnType CoupledCluster::triples() {
                 }
             }
         }
-        etrip[thread] += tripval * ijkfac;
-        // print out update
-        if (thread == 0) {
-            int print = 0;
-            stop = std::time(nullptr);
-            if ((double)ind / nijk >= 0.1 && !pct10) {
-                pct10 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.2 && !pct20) {
-                pct20 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.3 && !pct30) {
-                pct30 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.4 && !pct40) {
-                pct40 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.5 && !pct50) {
-                pct50 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.6 && !pct60) {
-                pct60 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.7 && !pct70) {
-                pct70 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.8 && !pct80) {
-                pct80 = 1;
-                print = 1;
-            } else if ((double)ind / nijk >= 0.9 && !pct90) {
-                pct90 = 1;
-                print = 1;
-            }
-            if (print) {
-                outfile->Printf("              %3.1lf  %8d s\n", 100.0 * ind / nijk, (int)stop - (int)start);
-            }
-        }
+        etask += tripval * ijkfac;
         mypsio->close(PSIF_DCC_ABCI, 1);
         mypsio.reset();
-    }
-
-    double myet = 0.0;
-    for (int i = 0; i < nthreads; i++) myet += etrip[i];
+        return etask;
+    };
+    double myet = tasks.compute(nthreads, ijk_energy);
 
     // ccsd(t) or qcisd(t)
     if (ccmethod <= 1) {
@@ -411,7 +360,6 @@ PsiReturnType CoupledCluster::triples() {
     free(Z);
     free(Z2);
     free(E2abci);
-    free(etrip);
     delete[] name;
     delete[] space;
 
@@ -0,0 +1,264 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "triples_tasks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+
+namespace psi {
+namespace fnocc {
+
+TriplesTasks::TriplesTasks(Options &options, const std::string &loop, long int nitems, long int o, long int v,
+                           int ccmethod, double escf, double ecc)
+    : nitems_(nitems), ndone_(0), file_(nullptr), decile_(0) {
+    nproc_ = options.get_int("TRIPLES_NPROC");
+    proc_ = options.get_int("TRIPLES_PROC");
+    filename_ = options.get_str("TRIPLES_CHECKPOINT_FILE");
+    if (nproc_ < 1 || proc_ < 0 || proc_ >= nproc_) {
+        throw PSIEXCEPTION("TRIPLES_PROC must lie in [0, TRIPLES_NPROC).");
+    }
+    if (nproc_ > 1 && filename_.empty()) {
+        throw PSIEXCEPTION("TRIPLES_NPROC > 1 requires a shared TRIPLES_CHECKPOINT_FILE.");
+    }
+
+    // by default, ~100 tasks per process: small enough to lose little on a restart,
+    // large enough that the checkpoint stays tiny
+    long int ntasks = options.get_int("TRIPLES_NTASKS");
+    if (ntasks <= 0) ntasks = 100L * nproc_;
+    if (ntasks > nitems_) ntasks = nitems_;
+    if (ntasks < 1) ntasks = 1;
+    tasksize_ = (nitems_ + ntasks - 1) / ntasks;
+    if (tasksize_ < 1) tasksize_ = 1;
+    ntasks_ = (nitems_ + tasksize_ - 1) / tasksize_;
+
+    energy_.assign(ntasks_, 0.0);
+    done_.assign(ntasks_, 0);
+
+    outfile->Printf("        (T) loop:                       %s\n", loop.c_str());
+    outfile->Printf("        Number of (T) tasks:      %9li\n", ntasks_);
+    if (nproc_ > 1) outfile->Printf("        This process:             %6i of %i\n", proc_, nproc_);
+
+    if (filename_.empty()) return;
+
+    // the CC and MP4 triples can run in the same job, so each method gets its own file
+    const char *method = (ccmethod == 0 ? "ccsd" : (ccmethod == 1 ? "qcisd" : "mp4"));
+    filename_ += std::string(".") + method;
+
+    // everything that must agree for the checkpoint to be reusable. the energies tell apart
+    // files from another geometry, basis, or set of amplitudes with the same dimensions.
+    char header[200];
+    sprintf(header, "fnocc (T) %s o=%ld v=%ld method=%d items=%ld tasks=%ld escf=", loop.c_str(), o, v, ccmethod,
+            nitems_, ntasks_);
+    header_ = header;
+    char energies[100];
+    sprintf(energies, "%.17le ecc=%.17le\n", escf, ecc);
+
+    file_ = fopen(filename_.c_str(), "a+");
+    if (file_ == nullptr) {
+        throw PSIEXCEPTION("Unable to open TRIPLES_CHECKPOINT_FILE " + filename_);
+    }
+
+    // the first process to get here writes the header; everyone else checks it
+    lock(true);
+    fseek(file_, 0, SEEK_END);
+    if (ftell(file_) == 0) {
+        fputs((header_ + energies).c_str(), file_);
+        fflush(file_);
+    } else {
+        // the energies need only agree to within what a rerun of the same job reproduces
+        char line[300];
+        double escf_file = 0.0, ecc_file = 0.0;
+        rewind(file_);
+        bool same = (fgets(line, sizeof(line), file_) != nullptr &&
+                     strncmp(line, header_.c_str(), header_.size()) == 0 &&
+                     sscanf(line + header_.size(), "%le ecc=%le", &escf_file, &ecc_file) == 2 &&
+                     std::fabs(escf_file - escf) < 1.0e-8 && std::fabs(ecc_file - ecc) < 1.0e-8);
+        if (!same) {
+            unlock();
+            fclose(file_);
+            file_ = nullptr;
+            throw PSIEXCEPTION("TRIPLES_CHECKPOINT_FILE " + filename_ +
+                               " belongs to a different (T) computation. Remove it or choose another name.");
+        }
+    }
+    unlock();
+    outfile->Printf("        Checkpoint file:                %s\n", filename_.c_str());
+}
+
+TriplesTasks::~TriplesTasks() {
+    if (file_ != nullptr) fclose(file_);
+}
+
+void TriplesTasks::lock(bool exclusive) {
+#ifndef _MSC_VER
+    struct flock fl;
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type = exclusive ? F_WRLCK : F_RDLCK;
+    fl.l_whence = SEEK_SET;
+    fcntl(fileno(file_), F_SETLKW, &fl);
+#endif
+}
+
+void TriplesTasks::unlock() {
+#ifndef _MSC_VER
+    struct flock fl;
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type = F_UNLCK;
+    fl.l_whence = SEEK_SET;
+    fcntl(fileno(file_), F_SETLK, &fl);
+#endif
+}
+
+void TriplesTasks::refresh() {
+    if (file_ == nullptr) return;
+    lock(false);
+    rewind(file_);
+    char line[300];
+    // skip the header
+    if (fgets(line, sizeof(line), file_) != nullptr) {
+        while (fgets(line, sizeof(line), file_) != nullptr) {
+            long int task;
+            double e;
+            // a line cut short by a crash simply doesn't parse
+            if (strchr(line, '\n') == nullptr) break;
+            if (sscanf(line, "%ld %lf", &task, &e) != 2) continue;
+            if (task < 0 || task >= ntasks_ || done_[task]) continue;
+            done_[task] = 1;
+            energy_[task] = e;
+            ndone_++;
+        }
+    }
+    unlock();
+}
+
+void TriplesTasks::record(long int task) {
+    if (file_ == nullptr) return;
+    lock(true);
+    fseek(file_, 0, SEEK_END);
+    fprintf(file_, "%ld %.17le\n", task, energy_[task]);
+    fflush(file_);
+#ifndef _MSC_VER
+    fsync(fileno(file_));
+#endif
+    unlock();
+}
+
+void TriplesTasks::progress() {
+    while (decile_ < 9 && 10 * ndone_ >= (decile_ + 1) * ntasks_) {
+        decile_++;
+        std::time_t stop = std::time(nullptr);
+        outfile->Printf("              %3.1lf  %8d s\n", 100.0 * ndone_ / ntasks_, (int)(stop - start_));
+    }
+}
+
+void TriplesTasks::run(const std::vector<long int> &tasks, int nthreads,
+                       const std::function<double(long int, int)> &kernel) {
+    std::vector<long int> items;
+    std::vector<long int> remaining(ntasks_, 0);
+    for (long int task : tasks) {
+        long int first = task * tasksize_;
+        long int last = std::min(first + tasksize_, nitems_);
+        for (long int item = first; item < last; item++) items.push_back(item);
+        remaining[task] = last - first;
+        energy_[task] = 0.0;
+    }
+    long int nitems = items.size();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (long int n = 0; n < nitems; n++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        long int item = items[n];
+        long int task = item / tasksize_;
+        double e = kernel(item, thread);
+
+#pragma omp critical(fnocc_triples_tasks)
+        {
+            energy_[task] += e;
+            if (--remaining[task] == 0) {
+                done_[task] = 1;
+                ndone_++;
+                record(task);
+                progress();
+            }
+        }
+    }
+}
+
+double TriplesTasks::compute(int nthreads, const std::function<double(long int, int)> &kernel) {
+    start_ = (long int)std::time(nullptr);
+
+    refresh();
+    if (ndone_ > 0) {
+        outfile->Printf("        Resuming: %ld of %ld tasks read from checkpoint.\n", ndone_, ntasks_);
+    }
+    outfile->Printf("\n");
+    outfile->Printf("        Computing (T) correction...\n");
+    outfile->Printf("\n");
+    outfile->Printf("        %% complete  total time\n");
+    progress();
+
+    // this process's share first
+    std::vector<long int> mine;
+    for (long int task = 0; task < ntasks_; task++) {
+        if (task % nproc_ == proc_ && !done_[task]) mine.push_back(task);
+    }
+    run(mine, nthreads, kernel);
+
+    // then whatever the other processes haven't finished, from the back so we
+    // meet them rather than race them. a task done twice gives the same energy.
+    for (long int task = ntasks_ - 1; task >= 0; task--) {
+        refresh();
+        if (done_[task]) continue;
+        run(std::vector<long int>(1, task), nthreads, kernel);
+    }
+
+    // sum in task order, so the result doesn't depend on who computed what
+    double et = 0.0;
+    for (long int task = 0; task < ntasks_; task++) et += energy_[task];
+    return et;
+}
+}
+}  // end of namespaces
@@ -0,0 +1,92 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef TRIPLES_TASKS_H
+#define TRIPLES_TASKS_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "psi4/psi4-dec.h"
+
+namespace psi {
+class Options;
+
+namespace fnocc {
+
+/**
+ *  Splits the unique index triples of a (T) loop (ijk or abc) into
+ *  contiguous tasks. The energy of each finished task can be appended
+ *  to a small checkpoint file (TRIPLES_CHECKPOINT_FILE, with the method
+ *  appended, e.g. ".qcisd" or ".mp4") so an interrupted
+ *  job resumes where it stopped, and several processes on one node that
+ *  share the file (TRIPLES_NPROC/TRIPLES_PROC) split the tasks among
+ *  themselves.
+ */
+class TriplesTasks {
+   public:
+    /// escf and ecc (the correlation energy of the amplitudes) identify the reference and amplitudes on file
+    TriplesTasks(Options &options, const std::string &loop, long int nitems, long int o, long int v, int ccmethod,
+                 double escf, double ecc);
+    ~TriplesTasks();
+
+    /// evaluate every task not already on file; kernel(item, thread) returns the energy of one item
+    double compute(int nthreads, const std::function<double(long int, int)> &kernel);
+
+   protected:
+    long int nitems_, ntasks_, tasksize_;
+    int nproc_, proc_;
+
+    /// per-task energies, and whether they are final
+    std::vector<double> energy_;
+    std::vector<char> done_;
+    long int ndone_;
+
+    /// checkpoint file; null if not checkpointing
+    std::string filename_;
+    std::string header_;
+    FILE *file_;
+
+    void lock(bool exclusive);
+    void unlock();
+    /// pick up tasks finished by earlier jobs or other processes
+    void refresh();
+    void record(long int task);
+    void run(const std::vector<long int> &tasks, int nthreads, const std::function<double(long int, int)> &kernel);
+
+    /// progress report
+    long int start_;
+    int decile_;
+    void progress();
+};
+}
+}
+
+#endif
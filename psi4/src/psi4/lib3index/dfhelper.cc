@@ -29,11 +29,16 @@
 #include "dfhelper.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #ifdef _MSC_VER
 #include <process.h>
 #define SYSTEM_GETPID ::_getpid
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #define SYSTEM_GETPID ::getpid
 #endif
@@ -51,6 +56,7 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/twobody.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libpsio/psio.h"
@@ -66,6 +72,7 @@ DFHelper::DFHelper(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet>
 
     nbf_ = primary_->nbf();
     naux_ = aux_->nbf();
+    set_io_backend(Process::environment.options.get_str("DFHELPER_IO_BACKEND"));
     prepare_blocking();
 }
 
@@ -248,6 +255,7 @@ void DFHelper::print_header() {
     outfile->Printf("    Algorithm:               %11s\n", method_.c_str());
     outfile->Printf("    AO Core:                 %11s\n", (AO_core_ ? "True" : "False"));
     outfile->Printf("    MO Core:                 %11s\n", (MO_core_ ? "True" : "False"));
+    outfile->Printf("    IO Backend:              %11s\n", io_backend_.c_str());
     outfile->Printf("    Hold Metric:             %11s\n", (hold_met_ ? "True" : "False"));
     outfile->Printf("    Metric Power:            %11.3f\n", mpower_);
     outfile->Printf("    Fitting Condition:       %11.0E\n", condition_);
@@ -255,6 +263,20 @@ void DFHelper::print_header() {
     outfile->Printf("\n\n");
 }
 
+void DFHelper::set_io_backend(std::string backend) {
+    if (backend != "STDIO" && backend != "MMAP") {
+        std::stringstream error;
+        error << "DFHelper:set_io_backend: backend (" << backend << ") must be one of STDIO or MMAP";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+#ifdef _MSC_VER
+    if (backend == "MMAP") {
+        throw PSIEXCEPTION("DFHelper:set_io_backend: MMAP is not available on this platform");
+    }
+#endif
+    io_backend_ = backend;
+}
+
 void DFHelper::prepare_sparsity() {
     if (sparsity_prepared_) return;
     timer_on("DFH: sparsity prep");
@@ -273,6 +295,7 @@ void DFHelper::prepare_sparsity() {
     // prepare eri buffers
     size_t nthreads = (nthreads_ == 1 ? 1 : 2);  // for now
     auto rifactory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+    rifactory->set_ints_tolerance(ints_tolerance_);
     std::vector<std::shared_ptr<TwoBodyAOInt>> eri(nthreads);
 
     eri[0] = std::shared_ptr<TwoBodyAOInt>(rifactory->eri());
@@ -385,6 +408,7 @@ void DFHelper::prepare_AO() {
     // prepare eris
     std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
     auto rifactory = std::make_shared<IntegralFactory>(aux_, zero, primary_, primary_);
+    rifactory->set_ints_tolerance(ints_tolerance_);
     std::vector<std::shared_ptr<TwoBodyAOInt>> eri(nthreads_);
     eri[0] = std::shared_ptr<TwoBodyAOInt>(rifactory->eri());
 #pragma omp parallel num_threads(nthreads_)
@@ -461,6 +485,7 @@ void DFHelper::prepare_AO_wK() {
     // prepare eris
     std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
     auto rifactory = std::make_shared<IntegralFactory>(aux_, zero, primary_, primary_);
+    rifactory->set_ints_tolerance(ints_tolerance_);
     std::vector<std::shared_ptr<TwoBodyAOInt>> eri(nthreads_);
     eri[0] = std::shared_ptr<TwoBodyAOInt>(rifactory->eri());
 #pragma omp parallel num_threads(nthreads_)
@@ -480,6 +505,7 @@ void DFHelper::prepare_AO_core() {
     // get each thread an eri object
     std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
     auto rifactory = std::make_shared<IntegralFactory>(aux_, zero, primary_, primary_);
+    rifactory->set_ints_tolerance(ints_tolerance_);
     std::vector<std::shared_ptr<TwoBodyAOInt>> eri(nthreads_);
     eri[0] = std::shared_ptr<TwoBodyAOInt>(rifactory->eri());
 #pragma omp parallel num_threads(nthreads_)
@@ -554,6 +580,7 @@ void DFHelper::prepare_AO_wK_core() {
     // get each thread an eri object
     std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
     auto rifactory = std::make_shared<IntegralFactory>(aux_, zero, primary_, primary_);
+    rifactory->set_ints_tolerance(ints_tolerance_);
     std::vector<std::shared_ptr<TwoBodyAOInt>> eri(nthreads_);
     std::vector<std::shared_ptr<TwoBodyAOInt>> weri(nthreads_);
 
@@ -724,7 +751,8 @@ std::pair<size_t, size_t> DFHelper::pshell_blocks_for_AO_build(const size_t mem,
     return std::make_pair(largest, block_size);
 }
 std::pair<size_t, size_t> DFHelper::Qshell_blocks_for_transform(const size_t mem, size_t wtmp, size_t wfinal,
-                                                                std::vector<std::pair<size_t, size_t>>& b) {
+                                                                std::vector<std::pair<size_t, size_t>>& b,
+                                                                size_t AO_buffers, size_t MO_buffers) {
     size_t extra = (hold_met_ ? naux_ * naux_ : 0);
     size_t end, begin, current, block_size, tmpbs, total, count, largest;
     block_size = tmpbs = total = count = largest = 0;
@@ -745,8 +773,9 @@ std::pair<size_t, size_t> DFHelper::Qshell_blocks_for_transform(const size_t mem
             total = (AO_core_ ? big_skips_[nbf_] : total);
         }
 
-        size_t constraint = total + (wtmp * nbf_ + 2 * wfinal) * tmpbs + extra;
-        // AOs + worst half transformed + worst final
+        size_t AO_total = (AO_core_ ? total : AO_buffers * total);
+        size_t constraint = AO_total + (wtmp * nbf_ + 2 * MO_buffers * wfinal) * tmpbs + extra;
+        // AOs + worst half transformed + worst final (each possibly double buffered)
         if (constraint > mem || i == Qshells_ - 1) {
             if (count == 1 && i != Qshells_ - 1) {
                 std::stringstream error;
@@ -830,6 +859,7 @@ std::tuple<size_t, size_t> DFHelper::Qshell_blocks_for_JK_build(std::vector<std:
 }
 
 FILE* DFHelper::stream_check(std::string filename, std::string op) {
+    std::lock_guard<std::mutex> lock(stream_lock_);
     if (file_streams_.count(filename) == 0) {
         file_streams_[filename] = std::make_shared<Stream>(filename, op);
     }
@@ -837,24 +867,150 @@ FILE* DFHelper::stream_check(std::string filename, std::string op) {
     return file_streams_[filename]->get_stream(op);
 }
 
-DFHelper::StreamStruct::StreamStruct(std::string filename, std::string op, bool activate) {
+double* DFHelper::map_check(std::string filename, size_t size, bool write, std::string op) {
+    std::lock_guard<std::mutex> lock(stream_lock_);
+    if (file_streams_.count(filename) == 0) {
+        file_streams_[filename] = std::make_shared<Stream>(filename, op, true, true);
+    }
+
+    return file_streams_[filename]->get_map(size * sizeof(double), write, op);
+}
+
+void DFHelper::advise_tensor(double* start, size_t size, bool sequential) {
+#ifndef _MSC_VER
+    // hints only, failures are harmless
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t begin = reinterpret_cast<uintptr_t>(start) & ~(page - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(start + size);
+    if (sequential) madvise(reinterpret_cast<void*>(begin), end - begin, MADV_SEQUENTIAL);
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+#endif
+}
+
+DFHelper::StreamStruct::StreamStruct(std::string filename, std::string op, bool activate, bool mapped) {
     op_ = op;
     filename_ = filename;
     if (activate) {
-        fp_ = fopen(filename.c_str(), op_.c_str());
-        open_ = true;
+        if (mapped) {
+#ifndef _MSC_VER
+            // a fresh "wb" stream truncates, as fopen would
+            fd_ = open(filename.c_str(), O_RDWR | O_CREAT | (op_ == "wb" ? O_TRUNC : 0), 0644);
+            if (fd_ < 0) {
+                std::stringstream error;
+                error << "DFHelper:StreamStruct: unable to open " << filename_;
+                throw PSIEXCEPTION(error.str().c_str());
+            }
+            mapped_ = true;
+#endif
+        } else {
+            fp_ = fopen(filename.c_str(), op_.c_str());
+            open_ = true;
+        }
     }
 }
 
 DFHelper::StreamStruct::StreamStruct() {}
 
 DFHelper::StreamStruct::~StreamStruct() {
-    fflush(fp_);
-    fclose(fp_);
+    unmap();
+    if (open_ && fp_) {
+        fflush(fp_);
+        fclose(fp_);
+    }
     std::remove(filename_.c_str());
 }
 
+double* DFHelper::StreamStruct::get_map(size_t bytes, bool write, std::string op) {
+#ifndef _MSC_VER
+    // a change to "wb" starts the file over, like fopen in change_stream
+    bool truncate = (op == "wb" && op_ != "wb");
+    op_ = op;
+
+    // switching over from stdio, flush and hand the file to the mapping
+    if (!mapped_) {
+        if (open_ && fp_) {
+            close_stream();
+            open_ = false;
+        }
+        fd_ = open(filename_.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+        if (fd_ < 0) {
+            std::stringstream error;
+            error << "DFHelper:StreamStruct: unable to open " << filename_;
+            throw PSIEXCEPTION(error.str().c_str());
+        }
+        mapped_ = true;
+    } else if (truncate) {
+        if (map_) munmap(map_, map_bytes_);
+        map_ = nullptr;
+        map_bytes_ = 0;
+        if (ftruncate(fd_, 0)) {
+            std::stringstream error;
+            error << "DFHelper:put_tensor: unable to truncate " << filename_;
+            throw PSIEXCEPTION(error.str().c_str());
+        }
+    }
+
+    if (bytes > map_bytes_) {
+        struct stat st;
+        if (fstat(fd_, &st)) {
+            std::stringstream error;
+            error << "DFHelper:StreamStruct: unable to stat " << filename_;
+            throw PSIEXCEPTION(error.str().c_str());
+        }
+        size_t file_bytes = (size_t)st.st_size;
+        if (file_bytes < bytes) {
+            if (!write) {
+                std::stringstream error;
+                error << "DFHelper:get_tensor: read error, " << filename_ << " is too short";
+                throw PSIEXCEPTION(error.str().c_str());
+            }
+            if (ftruncate(fd_, (off_t)bytes)) {
+                std::stringstream error;
+                error << "DFHelper:put_tensor: unable to grow " << filename_;
+                throw PSIEXCEPTION(error.str().c_str());
+            }
+            file_bytes = bytes;
+        }
+        if (map_) munmap(map_, map_bytes_);
+        void* addr = mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            map_ = nullptr;
+            map_bytes_ = 0;
+            std::stringstream error;
+            error << "DFHelper:StreamStruct: unable to map " << filename_;
+            throw PSIEXCEPTION(error.str().c_str());
+        }
+        map_ = static_cast<double*>(addr);
+        map_bytes_ = file_bytes;
+    }
+
+    return map_;
+#else
+    throw PSIEXCEPTION("DFHelper:StreamStruct: memory-mapped IO is not available on this platform");
+#endif
+}
+
+void DFHelper::StreamStruct::unmap() {
+#ifndef _MSC_VER
+    if (map_) munmap(map_, map_bytes_);
+    if (fd_ >= 0) close(fd_);
+#endif
+    map_ = nullptr;
+    map_bytes_ = 0;
+    fd_ = -1;
+    mapped_ = false;
+}
+
 FILE* DFHelper::StreamStruct::get_stream(std::string op) {
+    // switching over from the mapping, the data is already in the file
+    if (mapped_) {
+        unmap();
+        op_ = op;
+        fp_ = fopen(filename_.c_str(), op_.c_str());
+        open_ = true;
+        return fp_;
+    }
+
     if (op.compare(op_)) {
         change_stream(op);
     } else {
@@ -899,6 +1055,15 @@ void DFHelper::put_tensor(std::string file, double* b, std::pair<size_t, size_t>
     // check contiguity (a2)
     if (A2 == a2) {
         put_tensor(file, b, sta0, sto0, a2 * sta1, a2 * (sto1 + 1) - 1, op);
+    } else if (io_backend_ == "MMAP") {  // scatter straight into the mapping
+        size_t A1 = std::get<1>(sizes_[file]);
+        double* Fp = map_check(file, (sto0 * A1 + sto1) * A2 + sto2 + 1, true, op);
+        for (size_t j = 0; j < a0; j++) {
+            for (size_t i = 0; i < a1; i++) {
+                std::memcpy(&Fp[((sta0 + j) * A1 + sta1 + i) * A2 + sta2], &b[j * (a1 * a2) + i * a2],
+                            a2 * sizeof(double));
+            }
+        }
     } else {  // loop (a0, a1)
         for (size_t j = 0; j < a0; j++) {
             for (size_t i = 0; i < a1; i++) {
@@ -916,6 +1081,19 @@ void DFHelper::put_tensor(std::string file, double* Mp, const size_t start1, con
     size_t A1 = std::get<1>(sizes_[file]) * std::get<2>(sizes_[file]);
     size_t st = A1 - a1;
 
+    if (io_backend_ == "MMAP") {
+        double* Fp = map_check(file, stop1 * A1 + stop2 + 1, true, op);
+        double* Sp = &Fp[start1 * A1 + start2];
+        if (st == 0) {
+            std::memcpy(Sp, Mp, a0 * a1 * sizeof(double));
+        } else {
+            for (size_t i = 0; i < a0; i++) {
+                std::memcpy(&Sp[i * A1], &Mp[i * a1], a1 * sizeof(double));
+            }
+        }
+        return;
+    }
+
     // begin stream
     FILE* fp = stream_check(file, op);
 
@@ -952,6 +1130,12 @@ void DFHelper::put_tensor(std::string file, double* Mp, const size_t start1, con
     }
 }
 void DFHelper::put_tensor_AO(std::string file, double* Mp, size_t size, size_t start, std::string op) {
+    if (io_backend_ == "MMAP") {
+        double* Fp = map_check(file, start + size, true, op);
+        std::memcpy(&Fp[start], Mp, size * sizeof(double));
+        return;
+    }
+
     // begin stream
     FILE* fp = stream_check(file, op);
 
@@ -967,6 +1151,13 @@ void DFHelper::put_tensor_AO(std::string file, double* Mp, size_t size, size_t s
     }
 }
 void DFHelper::get_tensor_AO(std::string file, double* Mp, size_t size, size_t start) {
+    if (io_backend_ == "MMAP") {
+        double* Fp = map_check(file, start + size, false);
+        advise_tensor(&Fp[start], size, true);
+        std::memcpy(Mp, &Fp[start], size * sizeof(double));
+        return;
+    }
+
     // begin stream
     FILE* fp = stream_check(file, "rb");
 
@@ -1004,6 +1195,17 @@ void DFHelper::get_tensor_(std::string file, double* b, std::pair<size_t, size_t
     // check contiguity (a2)
     if (A2 == a2) {
         get_tensor_(file, b, sta0, sto0, a2 * sta1, a2 * (sto1 + 1) - 1);
+    } else if (io_backend_ == "MMAP") {  // gather straight out of the mapping
+        size_t A1 = std::get<1>(sizes);
+        double* Fp = map_check(file, (sto0 * A1 + sto1) * A2 + sto2 + 1, false);
+        size_t first = (sta0 * A1 + sta1) * A2 + sta2;
+        advise_tensor(&Fp[first], (sto0 * A1 + sto1) * A2 + sto2 + 1 - first, false);
+        for (size_t j = 0; j < a0; j++) {
+            for (size_t i = 0; i < a1; i++) {
+                std::memcpy(&b[j * (a1 * a2) + i * a2], &Fp[((sta0 + j) * A1 + sta1 + i) * A2 + sta2],
+                            a2 * sizeof(double));
+            }
+        }
     } else {  // loop (a0, a1)
         for (size_t j = 0; j < a0; j++) {
             for (size_t i = 0; i < a1; i++) {
@@ -1026,6 +1228,20 @@ void DFHelper::get_tensor_(std::string file, double* b, const size_t start1, con
     size_t A1 = std::get<1>(sizes) * std::get<2>(sizes);
     size_t st = A1 - a1;
 
+    if (io_backend_ == "MMAP") {
+        double* Fp = map_check(file, stop1 * A1 + stop2 + 1, false);
+        double* Sp = &Fp[start1 * A1 + start2];
+        advise_tensor(Sp, (a0 - 1) * A1 + a1, st == 0);
+        if (st == 0) {
+            std::memcpy(b, Sp, a0 * a1 * sizeof(double));
+        } else {
+            for (size_t i = 0; i < a0; i++) {
+                std::memcpy(&b[i * a1], &Sp[i * A1], a1 * sizeof(double));
+            }
+        }
+        return;
+    }
+
     // check stream
     FILE* fp = stream_check(file, "rb");
 
@@ -1844,9 +2060,26 @@ void DFHelper::transform() {
     // prep AO file stream if STORE + !AO_core_
     if (!direct_iaQ_ && !direct_ && !AO_core_) stream_check(AO_files_[AO_names_[1]], "rb");
 
-    // get Q blocking scheme
+    // pipeline the out-of-core paths: the next AO block is read and the
+    // previous MO block written on background threads during the contractions
+    bool prefetch = transform_prefetch_ && !AO_core_ && !direct_ && !direct_iaQ_;
+    async_put_ = transform_prefetch_ && !MO_core_;
+
+    // get Q blocking scheme, room permitting for the extra buffers
     std::vector<std::pair<size_t, size_t>> Qsteps;
-    std::pair<size_t, size_t> Qlargest = Qshell_blocks_for_transform(memory_, wtmp, wfinal, Qsteps);
+    std::pair<size_t, size_t> Qlargest;
+    if (prefetch || async_put_) {
+        try {
+            Qlargest = Qshell_blocks_for_transform(memory_, wtmp, wfinal, Qsteps, (prefetch ? 2 : 1),
+                                                   (async_put_ ? 2 : 1));
+        } catch (PsiException& e) {
+            prefetch = async_put_ = false;
+            Qsteps.clear();
+            Qlargest = Qshell_blocks_for_transform(memory_, wtmp, wfinal, Qsteps);
+        }
+    } else {
+        Qlargest = Qshell_blocks_for_transform(memory_, wtmp, wfinal, Qsteps);
+    }
     size_t max_block = std::get<1>(Qlargest);
 
     // prepare eri and C buffers per thread
@@ -1854,6 +2087,7 @@ void DFHelper::transform() {
     std::vector<std::vector<double>> C_buffers(nthreads_);
     std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
     auto rifactory = std::make_shared<IntegralFactory>(aux_, zero, primary_, primary_);
+    rifactory->set_ints_tolerance(ints_tolerance_);
     std::vector<std::shared_ptr<TwoBodyAOInt>> eri(nthread);
     eri[0] = std::shared_ptr<TwoBodyAOInt>(rifactory->eri());
 #pragma omp parallel num_threads(nthreads_)
@@ -1889,8 +2123,18 @@ void DFHelper::transform() {
             Np = N.get();
         }
 
+        // second set of MO buffers, written out while the first is filled
+        std::unique_ptr<double[]> F2, N2;
+        if (async_put_) {
+            F2 = std::unique_ptr<double[]>(new double[max_block * wfinal]);
+            N2 = std::unique_ptr<double[]>(new double[max_block * wfinal]);
+        }
+        double* Fbufs[2] = {F.get(), F2.get()};
+        double* Nbufs[2] = {N.get(), N2.get()};
+        size_t put_slot = 0;
+
         // AO buffer, allocate if not in-core, else point to in-core
-        std::unique_ptr<double[]> M;
+        std::unique_ptr<double[]> M, M2;
         double* Mp;
         if (!AO_core_) {
             M = std::unique_ptr<double[]>(new double[std::get<0>(Qlargest)]);
@@ -1899,6 +2143,25 @@ void DFHelper::transform() {
             Mp = Ppq_.get();
         }
 
+        // second AO buffer, read ahead while the first is transformed
+        if (prefetch) M2 = std::unique_ptr<double[]>(new double[std::get<0>(Qlargest)]);
+        double* Mbufs[2] = {M.get(), M2.get()};
+        std::future<void> prefetched;
+
+        // never unwind past a write still reading from these buffers
+        struct PutFlush {
+            DFHelper* dfh;
+            ~PutFlush() {
+                if (dfh->put_future_.valid()) dfh->put_future_.wait();
+            }
+        } put_flush{this};
+        if (prefetch && Qsteps.size()) {
+            size_t start = std::get<0>(Qsteps[0]);
+            size_t stop = std::get<1>(Qsteps[0]);
+            double* Mnext = Mbufs[0];
+            prefetched = std::async(std::launch::async, [this, start, stop, Mnext]() { grab_AO(start, stop, Mnext); });
+        }
+
         // transform in steps, blocking over the auxiliary basis (Q blocks)
         for (size_t j = 0, bcount = 0, block_size; j < Qsteps.size(); j++, bcount += block_size) {
             // Qshell step info
@@ -1923,6 +2186,20 @@ void DFHelper::transform() {
                 timer_on("DFH: Total Workflow");
                 compute_sparse_pQq_blocking_Q(start, stop, Mp, eri);
                 timer_off("DFH: Total Workflow");
+            } else if (prefetch) {
+                // wait on this block, then start on the next one
+                timer_on("DFH: Grabbing AOs");
+                prefetched.get();
+                Mp = Mbufs[j % 2];
+                if (j + 1 < Qsteps.size()) {
+                    size_t next_start = std::get<0>(Qsteps[j + 1]);
+                    size_t next_stop = std::get<1>(Qsteps[j + 1]);
+                    double* Mnext = Mbufs[(j + 1) % 2];
+                    prefetched = std::async(std::launch::async, [this, next_start, next_stop, Mnext]() {
+                        grab_AO(next_start, next_stop, Mnext);
+                    });
+                }
+                timer_off("DFH: Grabbing AOs");
             } else {
                 timer_on("DFH: Grabbing AOs");
                 grab_AO(start, stop, Mp);
@@ -1971,6 +2248,11 @@ void DFHelper::transform() {
                         Fp = transf_core_[order_[count + k]].get();
                     } else if (MO_core_) {
                         Np = transf_core_[order_[count + k]].get();
+                    } else if (async_put_) {
+                        // the other slot may still be in flight
+                        Fp = Fbufs[put_slot];
+                        Np = Nbufs[put_slot];
+                        put_slot ^= 1;
                     }
 
                     // perform final contraction
@@ -2015,6 +2297,12 @@ void DFHelper::transform() {
                 }
             }
         }
+
+        // flush the pipeline before the buffers go
+        timer_on("DFH: MO to disk");
+        wait_for_puts();
+        timer_off("DFH: MO to disk");
+        async_put_ = false;
     }  // buffers destroyed with std housekeeping
 
     // outfile->Printf("\n     ==> DFHelper:--End Transformations (disk)<==\n\n");
@@ -2155,11 +2443,11 @@ void DFHelper::put_transformations_Qpq(int begin, int end, int wsize, int bsize,
         std::string op = "ab";
 
         if (bleft) {
-            put_tensor(putf, Fp, std::make_pair(begin, end), std::make_pair(0, bsize - 1), std::make_pair(0, wsize - 1),
-                       op);
+            put_transformation_block(putf, Fp, std::make_pair(begin, end), std::make_pair(0, bsize - 1),
+                                     std::make_pair(0, wsize - 1), op);
         } else {
-            put_tensor(putf, Fp, std::make_pair(begin, end), std::make_pair(0, wsize - 1), std::make_pair(0, bsize - 1),
-                       op);
+            put_transformation_block(putf, Fp, std::make_pair(begin, end), std::make_pair(0, wsize - 1),
+                                     std::make_pair(0, bsize - 1), op);
         }
     }
 }
@@ -2196,8 +2484,8 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
                 }
             }
             if (!MO_core_) {
-                put_tensor(putf, Np, std::make_pair(0, bsize - 1), std::make_pair(0, wsize - 1),
-                           std::make_pair(begin, end), op);
+                put_transformation_block(putf, Np, std::make_pair(0, bsize - 1), std::make_pair(0, wsize - 1),
+                                         std::make_pair(begin, end), op);
             }
 
             // result is in Qpq format
@@ -2212,8 +2500,8 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
                 }
             }
             if (!MO_core_) {
-                put_tensor(putf, Np, std::make_pair(begin, end), std::make_pair(0, bsize - 1),
-                           std::make_pair(0, wsize - 1), op);
+                put_transformation_block(putf, Np, std::make_pair(begin, end), std::make_pair(0, bsize - 1),
+                                         std::make_pair(0, wsize - 1), op);
             }
 
             // result is in pQq format
@@ -2229,8 +2517,8 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
                 }
             }
             if (!MO_core_) {
-                put_tensor(putf, Np, std::make_pair(0, bsize - 1), std::make_pair(begin, end),
-                           std::make_pair(0, wsize - 1), op);
+                put_transformation_block(putf, Np, std::make_pair(0, bsize - 1), std::make_pair(begin, end),
+                                         std::make_pair(0, wsize - 1), op);
             }
         }
 
@@ -2248,8 +2536,8 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
                 }
             }
             if (!MO_core_) {
-                put_tensor(putf, Np, std::make_pair(0, wsize - 1), std::make_pair(0, bsize - 1),
-                           std::make_pair(begin, end), op);
+                put_transformation_block(putf, Np, std::make_pair(0, wsize - 1), std::make_pair(0, bsize - 1),
+                                         std::make_pair(begin, end), op);
             }
 
             // result is in Qpq format
@@ -2263,16 +2551,16 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
                 }
             }
             if (!MO_core_) {
-                put_tensor(putf, Np, std::make_pair(begin, end), std::make_pair(0, wsize - 1),
-                           std::make_pair(0, bsize - 1), op);
+                put_transformation_block(putf, Np, std::make_pair(begin, end), std::make_pair(0, wsize - 1),
+                                         std::make_pair(0, bsize - 1), op);
             }
 
             // result is in pQq format
         } else {
             // (w|Qb)
             if (!MO_core_) {
-                put_tensor(putf, Fp, std::make_pair(0, wsize - 1), std::make_pair(begin, end),
-                           std::make_pair(0, bsize - 1), op);
+                put_transformation_block(putf, Fp, std::make_pair(0, wsize - 1), std::make_pair(begin, end),
+                                         std::make_pair(0, bsize - 1), op);
             } else {
 // we have to copy over the buffer
 #pragma omp parallel for num_threads(nthreads_)
@@ -2287,6 +2575,24 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
     }
 }
 
+void DFHelper::put_transformation_block(std::string file, double* b, std::pair<size_t, size_t> a0,
+                                        std::pair<size_t, size_t> a1, std::pair<size_t, size_t> a2, std::string op) {
+    if (!async_put_) {
+        put_tensor(file, b, a0, a1, a2, op);
+        return;
+    }
+
+    // a single write in flight keeps appends ordered. b must be left alone
+    // until the next call or wait_for_puts()
+    wait_for_puts();
+    put_future_ = std::async(std::launch::async, [this, file, b, a0, a1, a2, op]() { put_tensor(file, b, a0, a1, a2, op); });
+}
+
+void DFHelper::wait_for_puts() {
+    // rethrows anything raised on the IO thread
+    if (put_future_.valid()) put_future_.get();
+}
+
 // Fill using a pointer, be cautious of bounds!!
 void DFHelper::fill_tensor(std::string name, double* b) {
     check_file_key(name);
@@ -32,8 +32,10 @@
 #include "psi4/psi4-dec.h"
 #include <psi4/libmints/typedefs.h>
 
+#include <future>
 #include <map>
 #include <list>
+#include <mutex>
 #include <vector>
 #include <tuple>
 #include <string>
@@ -110,10 +112,35 @@ class PSI_API DFHelper {
     void set_MO_core(bool core) { MO_core_ = core; }
     bool get_MO_core() { return MO_core_; }
 
+    ///
+    /// Sets the storage backend for on-disk tensors (defaults to the
+    /// DFHELPER_IO_BACKEND option)
+    /// @param backend STDIO for buffered stdio streams, or MMAP to
+    /// memory-map each file so that slices are gathered from (scattered to)
+    /// the page cache with no per-row seeks or syscalls. MMAP is unavailable
+    /// on Windows.
+    ///
+    void set_io_backend(std::string backend);
+    std::string get_io_backend() { return io_backend_; }
+
+    ///
+    /// Overlap disk IO with the contractions in transform() (defaults to TRUE)
+    /// @param prefetch True to read the next AO block and write the previous
+    /// MO block on background threads. Needs a second AO and MO buffer, the
+    /// Q blocking shrinks accordingly (or falls back to unpipelined if even
+    /// one Q shell cannot be doubled buffered).
+    ///
+    void set_transform_prefetch(bool prefetch) { transform_prefetch_ = prefetch; }
+    bool get_transform_prefetch() { return transform_prefetch_; }
+
     /// schwarz screening cutoff (defaults to 1e-12)
     void set_schwarz_cutoff(double cutoff) { cutoff_ = cutoff; }
     double get_schwarz_cutoff() { return cutoff_; }
 
+    /// screening threshold of the integral engines (defaults to INTS_TOLERANCE)
+    void set_ints_tolerance(double tolerance) { ints_tolerance_ = tolerance; }
+    double get_ints_tolerance() { return ints_tolerance_; }
+
     /// fitting metric power (defaults to -0.5) to use in
     /// K_{m n} = C_{l a}(m l|Q)(Q|R)^{-1/2}(R|P)^{-1/2}(P|n s)C_{s a}
     void set_metric_pow(double m_pow) { mpower_ = m_pow; }
@@ -326,8 +353,11 @@ class PSI_API DFHelper {
     bool symm_compute_;
     bool AO_core_ = true;
     bool MO_core_ = false;
+    std::string io_backend_ = "STDIO";
+    bool transform_prefetch_ = true;
     size_t nthreads_ = 1;
     double cutoff_ = 1e-12;
+    double ints_tolerance_ = -1.0;
     double condition_ = 1e-12;
     double mpower_ = -0.5;
     double wmpower_ = -1.0;
@@ -404,7 +434,8 @@ class PSI_API DFHelper {
     std::pair<size_t, size_t> pshell_blocks_for_AO_build(const size_t mem, size_t symm,
                                                          std::vector<std::pair<size_t, size_t>>& b);
     std::pair<size_t, size_t> Qshell_blocks_for_transform(const size_t mem, size_t wtmp, size_t wfinal,
-                                                          std::vector<std::pair<size_t, size_t>>& b);
+                                                          std::vector<std::pair<size_t, size_t>>& b,
+                                                          size_t AO_buffers = 1, size_t MO_buffers = 1);
     void metric_contraction_blocking(std::vector<std::pair<size_t, size_t>>& steps, size_t blocking_index,
                                      size_t block_sizes, size_t total_mem, size_t memory_factor, size_t memory_bump);
 
@@ -441,6 +472,12 @@ class PSI_API DFHelper {
     void put_transformations_Qpq(int begin, int end, int wsize, int bsize, double* Fp, int ind, bool bleft);
     void put_transformations_pQq(int begin, int end, int block_size, int bcount, int wsize, int bsize, double* Np,
                                  double* Fp, int ind, bool bleft);
+    // => asynchronous MO writes, one in flight at a time <=
+    bool async_put_ = false;
+    std::future<void> put_future_;
+    void put_transformation_block(std::string file, double* b, std::pair<size_t, size_t> a0,
+                                  std::pair<size_t, size_t> a1, std::pair<size_t, size_t> a2, std::string op);
+    void wait_for_puts();
     std::vector<std::pair<std::string, size_t>> sorted_spaces_;
     std::vector<std::string> order_;
     std::vector<std::string> bspace_;
@@ -449,22 +486,37 @@ class PSI_API DFHelper {
     // => FILE IO maintenence <=
     typedef struct StreamStruct {
         StreamStruct();
-        StreamStruct(std::string filename, std::string op, bool activate = true);
+        StreamStruct(std::string filename, std::string op, bool activate = true, bool mapped = false);
         ~StreamStruct();
 
         FILE* get_stream(std::string op);
         void change_stream(std::string op);
         void close_stream();
 
-        FILE* fp_;
+        // memory-mapped backend, the whole file is mapped read-write and
+        // grown on demand. pointers are invalidated by a remap. switching
+        // to "wb" truncates, as reopening the stdio stream would.
+        double* get_map(size_t bytes, bool write, std::string op);
+        void unmap();
+
+        FILE* fp_ = nullptr;
         std::string op_;
         bool open_ = false;
         std::string filename_;
 
+        bool mapped_ = false;
+        int fd_ = -1;
+        double* map_ = nullptr;
+        size_t map_bytes_ = 0;
+
     } Stream;
 
     std::map<std::string, std::shared_ptr<Stream>> file_streams_;
+    // guards file_streams_ against the transform() IO threads
+    std::mutex stream_lock_;
     FILE* stream_check(std::string filename, std::string op);
+    double* map_check(std::string filename, size_t size, bool write, std::string op = "rb");
+    void advise_tensor(double* start, size_t size, bool sequential);
 
     // => FILE IO machinery <=
     void put_tensor(std::string file, double* b, std::pair<size_t, size_t> a1, std::pair<size_t, size_t> a2,
@@ -40,6 +40,7 @@
 #include "psi4/libfock/cubature.h"
 #include "psi4/libfock/points.h"
 #include "psi4/libmints/basisset.h"
+#include "psi4/libmints/espgrid.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/molecule.h"
@@ -427,8 +428,8 @@ void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::v
 
     J->power(-1.0, condition);
 
-    auto d = std::make_shared<Vector>("d", naux);
-    double* dp = d->pointer();
+    auto d = std::make_shared<Matrix>("d", naux, 1);
+    double* dp = d->pointer()[0];
 
     C_DGEMV('N', naux, naux, 1.0, Jp[0], naux, cp, 1, 0.0, dp, 1);
 
@@ -439,41 +440,9 @@ void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::v
 
     // => Electronic Part <= //
 
-    std::shared_ptr<IntegralFactory> Vfact = std::make_shared<IntegralFactory>(
-        auxiliary_, BasisSet::zero_ao_basis_set(), auxiliary_, BasisSet::zero_ao_basis_set());
-    std::vector<std::shared_ptr<Matrix>> ZxyzT;
-    std::vector<std::shared_ptr<Matrix>> VtempT;
-    std::vector<std::shared_ptr<PotentialInt>> VintT;
-    for (int thread = 0; thread < nthreads; thread++) {
-        ZxyzT.push_back(std::make_shared<Matrix>("Zxyz", 1, 4));
-        VtempT.push_back(std::make_shared<Matrix>("Vtemp", naux, 1));
-        VintT.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(Vfact->ao_potential())));
-        VintT[thread]->set_charge_field(ZxyzT[thread]);
-    }
-
-#pragma omp parallel for schedule(dynamic)
-    for (int P = 0; P < npoints_; P++) {
-        // Thread info
-        int thread = 0;
-#ifdef _OPENMP
-        thread = omp_get_thread_num();
-#endif
-
-        // Pointers
-        double** ZxyzTp = ZxyzT[thread]->pointer();
-        double** VtempTp = VtempT[thread]->pointer();
-
-        // Integrals
-        VtempT[thread]->zero();
-        ZxyzTp[0][0] = 1.0;
-        ZxyzTp[0][1] = x_[P];
-        ZxyzTp[0][2] = y_[P];
-        ZxyzTp[0][3] = z_[P];
-        VintT[thread]->compute(VtempT[thread]);
-
-        // Contraction
-        v[P] += C_DDOT(naux, dp, 1, VtempTp[0], 1);  // Potential integrals are negative definite already
-    }
+    // The fitted density is a one-center expansion, i.e. pairs of auxiliary functions with the zero basis
+    ESPGridEngine engine(auxiliary_, BasisSet::zero_ao_basis_set(), d, cutoff);
+    engine.add_esp(npoints_, x_, y_, z_, v);
 
     // => Nuclear Part <= //
 
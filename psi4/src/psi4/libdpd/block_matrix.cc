@@ -106,6 +106,15 @@ double **DPD::dpd_block_matrix(size_t n, size_t m) {
             }
         }
 
+        /* Adaptive (cost- and frequency-weighted) cache */
+        else if (dpd_main.cachetype == 2) {
+            if (file4_cache_del_adaptive()) {
+                file4_cache_print("outfile");
+                outfile->Printf("dpd_block_matrix: n = %zd  m = %zd\n", n, m);
+                dpd_error("dpd_block_matrix: No memory left.", "outfile");
+            }
+        }
+
         else
             dpd_error("LIBDPD Error: invalid cachetype.", "outfile");
     }
@@ -148,6 +157,15 @@ double **DPD::dpd_block_matrix(size_t n, size_t m) {
                 dpd_error("dpd_block_matrix: No memory left.", "outfile");
             }
         }
+
+        /* Adaptive (cost- and frequency-weighted) cache */
+        else if (dpd_main.cachetype == 2) {
+            if (file4_cache_del_adaptive()) {
+                file4_cache_print("outfile");
+                outfile->Printf("dpd_block_matrix: n = %zd  m = %zd\n", n, m);
+                dpd_error("dpd_block_matrix: No memory left.", "outfile");
+            }
+        }
     }
 
     /*  memset((void *) B, 0, m*n*sizeof(double)); */
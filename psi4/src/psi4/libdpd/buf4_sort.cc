@@ -37,13 +37,36 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 
 using std::string;
 namespace psi {
 
+/* Out[pq][rs] = In[srcrow[rs]][srccol[pq]], the in-core kernel of the sorts
+** that swap bra and ket.  Threads take tiles of target rows; within a tile the
+** columns are walked in tiles as well so the strided reads of In stay in cache. */
+static void buf4_sort_transpose(double **Out, double **In, int nrows, int ncols, const int *srccol,
+                                const int *srcrow) {
+    const int tile = 32;
+
+#pragma omp parallel for schedule(static)
+    for (int pq0 = 0; pq0 < nrows; pq0 += tile) {
+        int pq1 = std::min(pq0 + tile, nrows);
+        for (int rs0 = 0; rs0 < ncols; rs0 += tile) {
+            int rs1 = std::min(rs0 + tile, ncols);
+            for (int pq = pq0; pq < pq1; pq++) {
+                double *Outpq = Out[pq];
+                int col = srccol[pq];
+                for (int rs = rs0; rs < rs1; rs++) Outpq[rs] = In[srcrow[rs]][col];
+            }
+        }
+    }
+}
+
 /*
 ** dpd_buf4_sort(): A general DPD buffer sorting function that will
 ** (eventually) handle all 24 possible permutations of four-index
@@ -137,6 +160,10 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
     buf4_init(&OutBuf, outfilenum, my_irrep, pqnum, rsnum, pqnum, rsnum, 0, label);
 
+    /* the in-core orbital-loop sorts below split the target rows over p; a
+       packed target bra maps PQ and QP to the same row, so those run serially */
+    bool distinct_rows = !OutBuf.params->perm_pq;
+
     /* select in-core vs. out-of-core algorithms */
     incore = 1;
     core_total = 0;
@@ -242,6 +269,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for private(p, q, r, s, rs, row, sr)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -339,6 +367,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gpr = Gp ^ Gr;
                             Gqs = Gq ^ Gs;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, pr, qs) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -568,6 +597,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gps = Gp ^ Gs;
                             Gqr = Gq ^ Gr;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, ps, qr) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -798,6 +828,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gpr = Gp ^ Gr;
                             Gsq = Gs ^ Gq;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, pr, sq) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -851,6 +882,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gps = Gp ^ Gs;
                             Grq = Gr ^ Gq;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, ps, rq) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -896,6 +928,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for private(p, q, r, s, rs, col, qp)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -1020,6 +1053,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+#pragma omp parallel for private(p, q, r, s, rs, qp, sr)
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
@@ -1171,6 +1205,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Grp = Gr ^ Gp;
                             Gqs = Gq ^ Gs;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, qs, rp) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1224,6 +1259,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gsp = Gs ^ Gp;
                             Gqr = Gq ^ Gr;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, qr, sp) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1276,6 +1312,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Grp = Gr ^ Gp;
                             Gsq = Gs ^ Gq;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, rp, sq) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1328,6 +1365,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gsp = Gs ^ Gp;
                             Grq = Gr ^ Gq;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, rq, sp) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1381,6 +1419,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Grq = Gr ^ Gq;
                             Gps = Gp ^ Gs;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, ps, rq) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1434,6 +1473,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gsq = Gs ^ Gq;
                             Gpr = Gp ^ Gr;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, pr, sq) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1487,6 +1527,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gqr = Gq ^ Gr;
                             Gps = Gp ^ Gs;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, ps, qr) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1540,6 +1581,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gqs = Gq ^ Gs;
                             Gpr = Gp ^ Gr;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, pr, qs) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1585,21 +1627,20 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+                    std::vector<int> srccol(OutBuf.params->rowtot[h]), srcrow(OutBuf.params->coltot[r_irrep]);
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
-
-                        col = InBuf->params->colidx[p][q];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            row = InBuf->params->rowidx[s][r];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][row][col];
-                        }
+                        srccol[pq] = InBuf->params->colidx[p][q];
+                    }
+                    for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
+                        r = OutBuf.params->colorb[r_irrep][rs][0];
+                        s = OutBuf.params->colorb[r_irrep][rs][1];
+                        srcrow[rs] = InBuf->params->rowidx[s][r];
                     }
+
+                    buf4_sort_transpose(OutBuf.matrix[h], InBuf->matrix[h], OutBuf.params->rowtot[h],
+                                        OutBuf.params->coltot[r_irrep], srccol.data(), srcrow.data());
                 }
             } else {
                 outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for rsqp sort.\n");
@@ -1623,21 +1664,20 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+                    std::vector<int> srccol(OutBuf.params->rowtot[h]), srcrow(OutBuf.params->coltot[r_irrep]);
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
-
-                        col = InBuf->params->colidx[p][q];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            row = InBuf->params->rowidx[r][s];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[r_irrep][row][col];
-                        }
+                        srccol[pq] = InBuf->params->colidx[p][q];
+                    }
+                    for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
+                        r = OutBuf.params->colorb[r_irrep][rs][0];
+                        s = OutBuf.params->colorb[r_irrep][rs][1];
+                        srcrow[rs] = InBuf->params->rowidx[r][s];
                     }
+
+                    buf4_sort_transpose(OutBuf.matrix[h], InBuf->matrix[r_irrep], OutBuf.params->rowtot[h],
+                                        OutBuf.params->coltot[r_irrep], srccol.data(), srcrow.data());
                 }
             } else {
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
@@ -1733,6 +1773,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gsq = Gs ^ Gq;
                             Grp = Gr ^ Gp;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, rp, sq) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1783,21 +1824,20 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+                    std::vector<int> srccol(OutBuf.params->rowtot[h]), srcrow(OutBuf.params->coltot[r_irrep]);
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
-
-                        col = InBuf->params->colidx[q][p];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            row = InBuf->params->rowidx[s][r];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[r_irrep][row][col];
-                        }
+                        srccol[pq] = InBuf->params->colidx[q][p];
+                    }
+                    for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
+                        r = OutBuf.params->colorb[r_irrep][rs][0];
+                        s = OutBuf.params->colorb[r_irrep][rs][1];
+                        srcrow[rs] = InBuf->params->rowidx[s][r];
                     }
+
+                    buf4_sort_transpose(OutBuf.matrix[h], InBuf->matrix[r_irrep], OutBuf.params->rowtot[h],
+                                        OutBuf.params->coltot[r_irrep], srccol.data(), srcrow.data());
                 }
             } else {
                 outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for srqp sort.\n");
@@ -1820,21 +1860,20 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                 for (h = 0; h < nirreps; h++) {
                     r_irrep = h ^ my_irrep;
 
+                    std::vector<int> srccol(OutBuf.params->rowtot[h]), srcrow(OutBuf.params->coltot[r_irrep]);
                     for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
                         p = OutBuf.params->roworb[h][pq][0];
                         q = OutBuf.params->roworb[h][pq][1];
-
-                        col = InBuf->params->colidx[q][p];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            row = InBuf->params->rowidx[r][s];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][row][col];
-                        }
+                        srccol[pq] = InBuf->params->colidx[q][p];
                     }
+                    for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
+                        r = OutBuf.params->colorb[r_irrep][rs][0];
+                        s = OutBuf.params->colorb[r_irrep][rs][1];
+                        srcrow[rs] = InBuf->params->rowidx[r][s];
+                    }
+
+                    buf4_sort_transpose(OutBuf.matrix[h], InBuf->matrix[h], OutBuf.params->rowtot[h],
+                                        OutBuf.params->coltot[r_irrep], srccol.data(), srcrow.data());
                 }
             } else {
                 outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for srpq sort.\n");
@@ -1866,6 +1905,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gqr = Gq ^ Gr;
                             Gsp = Gs ^ Gp;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, qr, sp) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
@@ -1919,6 +1959,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                             Gqs = Gq ^ Gs;
                             Grp = Gr ^ Gp;
 
+#pragma omp parallel for private(q, r, s, P, Q, R, S, pq, rs, qs, rp) if (distinct_rows)
                             for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
                                 P = OutBuf.params->poff[Gp] + p;
                                 for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
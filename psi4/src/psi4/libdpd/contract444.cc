@@ -32,13 +32,24 @@
 */
 #include <cstdio>
 #include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.h"
 #include "dpd.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
 
 namespace psi {
 
+/* Largest per-irrep GEMM (in multiply-adds) for which contract444 runs the
+** symmetry blocks concurrently with single-threaded BLAS rather than one
+** after the other with threaded BLAS. */
+#define DPD_CONTRACT444_SMALL_GEMM (1L << 24)
+
 /* dpd_contract444(): Contracts a pair of four-index quantities to
 ** give a product four-index quantity.
 **
@@ -112,21 +123,85 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
     }
 #endif
 
-    for (Hx = 0; Hx < nirreps; Hx++) {
+    /* irreps of the Y and Z blocks that go with symmetry block Hx of X */
+    auto block_irreps = [&](int hx, int &hy, int &hz) {
         if ((!Xtrans) && (!Ytrans)) {
-            Hy = Hx ^ GX;
-            Hz = Hx;
+            hy = hx ^ GX;
+            hz = hx;
         } else if ((!Xtrans) && (Ytrans)) {
-            Hy = Hx ^ GX ^ GY;
-            Hz = Hx;
+            hy = hx ^ GX ^ GY;
+            hz = hx;
         } else if ((Xtrans) && (!Ytrans)) {
-            Hy = Hx;
-            Hz = Hx ^ GX;
+            hy = hx;
+            hz = hx ^ GX;
         } else /* (( Xtrans)&&( Ytrans))*/ {
-            Hy = Hx ^ GY;
-            Hz = Hx ^ GX;
+            hy = hx ^ GY;
+            hz = hx ^ GX;
+        }
+    };
+
+    /* If every symmetry block of X, Y and Z fits in core at once and no
+    ** single GEMM is big enough to keep threaded BLAS busy, read all
+    ** blocks and run the GEMMs for the different irreps concurrently. */
+    if (nirreps > 1 && X != Y && X != Z && Y != Z) {
+        long int total = 0, maxgemm = 0;
+        for (Hx = 0; Hx < nirreps; Hx++) {
+            block_irreps(Hx, Hy, Hz);
+            total += ((long)X->params->rowtot[Hx]) * ((long)X->params->coltot[Hx ^ GX]);
+            total += ((long)Y->params->rowtot[Hy]) * ((long)Y->params->coltot[Hy ^ GY]);
+            total += ((long)Z->params->rowtot[Hz]) * ((long)Z->params->coltot[Hz ^ GZ]);
+            long int gemm = ((long)Z->params->rowtot[Hz]) * ((long)Z->params->coltot[Hz ^ GZ]) *
+                            ((long)numlinks[Hx ^ symlink]);
+            if (gemm > maxgemm) maxgemm = gemm;
         }
 
+        if (maxgemm < DPD_CONTRACT444_SMALL_GEMM && total < dpd_memfree()) {
+            for (Hx = 0; Hx < nirreps; Hx++) {
+                block_irreps(Hx, Hy, Hz);
+                buf4_mat_irrep_init(X, Hx);
+                buf4_mat_irrep_rd(X, Hx);
+                buf4_mat_irrep_init(Y, Hy);
+                buf4_mat_irrep_rd(Y, Hy);
+                buf4_mat_irrep_init(Z, Hz);
+                if (std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hz);
+            }
+
+#ifdef USING_LAPACK_MKL
+            int old_threads = mkl_get_max_threads();
+            mkl_set_num_threads(1);
+#endif
+
+#pragma omp parallel for schedule(dynamic, 1)
+            for (int hx = 0; hx < nirreps; hx++) {
+                int hy, hz;
+                block_irreps(hx, hy, hz);
+                if (Z->params->rowtot[hz] && Z->params->coltot[hz ^ GZ] && numlinks[hx ^ symlink]) {
+                    C_DGEMM(Xtrans ? 't' : 'n', Ytrans ? 't' : 'n', Z->params->rowtot[hz], Z->params->coltot[hz ^ GZ],
+                            numlinks[hx ^ symlink], alpha, &(X->matrix[hx][0][0]), X->params->coltot[hx ^ GX],
+                            &(Y->matrix[hy][0][0]), Y->params->coltot[hy ^ GY], beta, &(Z->matrix[hz][0][0]),
+                            Z->params->coltot[hz ^ GZ]);
+                }
+            }
+
+#ifdef USING_LAPACK_MKL
+            mkl_set_num_threads(old_threads);
+#endif
+
+            for (Hx = 0; Hx < nirreps; Hx++) {
+                block_irreps(Hx, Hy, Hz);
+                buf4_mat_irrep_close(X, Hx);
+                buf4_mat_irrep_wrt(Z, Hz);
+                buf4_mat_irrep_close(Y, Hy);
+                buf4_mat_irrep_close(Z, Hz);
+            }
+
+            return 0;
+        }
+    }
+
+    for (Hx = 0; Hx < nirreps; Hx++) {
+        block_irreps(Hx, Hy, Hz);
+
         size_Y = ((long)Y->params->rowtot[Hy]) * ((long)Y->params->coltot[Hy ^ GY]);
         size_Z = ((long)Z->params->rowtot[Hz]) * ((long)Z->params->coltot[Hz ^ GZ]);
         size_file_X_row = ((long)X->file.params->coltot[0]); /* need room for a row of the X->file */
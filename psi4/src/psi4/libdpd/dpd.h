@@ -163,10 +163,29 @@ struct dpd_file4_cache_entry {
     size_t priority;             /* priority level */
     int lock;                    /* auto-deletion allowed? */
     int clean;                   /* has this file4 changed? */
+    double cost;                 /* measured time (s) to read the entry from disk */
+    double inflation;            /* adaptive-cache clock value at last access */
+    int stat;                    /* index into dpd_gbl::file4_cache_stats */
     dpd_file4_cache_entry *next; /* pointer to next cache entry */
     dpd_file4_cache_entry *last; /* pointer to previous cache entry */
 };
 
+/* DPD File4 Cache statistics, kept per buffer across evictions */
+struct dpd_file4_cache_stat {
+    int dpdnum;              /* dpd structure reference */
+    int filenum;             /* libpsio unit number */
+    int irrep;               /* overall symmetry */
+    int pqnum;               /* dpd pq value */
+    int rsnum;               /* dpd rs value */
+    char label[PSIO_KEYLEN]; /* libpsio TOC keyword */
+    size_t size;             /* size of buffer in double words */
+    size_t hits;             /* file4_init calls satisfied from the cache */
+    size_t misses;           /* file4_init calls that read the buffer from disk */
+    size_t evictions;        /* number of times the buffer was dropped from the cache */
+    size_t bytes_reloaded;   /* bytes re-read after an earlier eviction */
+    double io_time;          /* total time (s) spent reading the buffer into the cache */
+};
+
 /* DPD File2 Cache entries */
 struct dpd_file2_cache_entry {
     dpd_file2_cache_entry() : next(nullptr), last(nullptr) {}
@@ -245,14 +264,20 @@ struct dpd_gbl {
           file4_cache_most_recent(0),
           file4_cache_least_recent(1),
           file4_cache_lru_del(0),
-          file4_cache_low_del(0) {}
+          file4_cache_low_del(0),
+          file4_cache_adaptive_del(0),
+          file4_cache_inflation(0.0) {}
     dpd_file2_cache_entry *file2_cache;
     dpd_file4_cache_entry *file4_cache;
     size_t file4_cache_most_recent;
     size_t file4_cache_least_recent;
     size_t file4_cache_lru_del;
     size_t file4_cache_low_del;
-    int cachetype;
+    size_t file4_cache_adaptive_del;
+    double file4_cache_inflation; /* adaptive-cache clock: score of the last evicted entry */
+    std::vector<dpd_file4_cache_stat> file4_cache_stats;
+    std::vector<dpd_file4_cache_stat> file4_cache_trace; /* stats read back from a previous run */
+    int cachetype; /* 0 = LRU, 1 = LOW (static priorities), 2 = ADAPTIVE */
     int *cachefiles;
     int **cachelist;
     dpd_file4_cache_entry *file4_cache_priority;
@@ -452,6 +477,14 @@ class PSI_API DPD {
     int file4_cache_del(dpdfile4 *File);
     dpd_file4_cache_entry *file4_cache_find_lru();
     int file4_cache_del_lru();
+    dpd_file4_cache_entry *file4_cache_find_adaptive();
+    int file4_cache_del_adaptive();
+    size_t file4_cache_get_trace_priority(dpdfile4 *File);
+    void file4_cache_hit(dpd_file4_cache_entry *entry);
+    int file4_cache_stat_index(dpdfile4 *File);
+    void file4_cache_print_stats(std::string out_fname);
+    int file4_cache_trace_load(const std::string &fname);
+    int file4_cache_trace_save(const std::string &fname);
     void file4_cache_dirty(dpdfile4 *File);
     void file4_cache_lock(dpdfile4 *File);
     void file4_cache_unlock(dpdfile4 *File);
@@ -30,9 +30,13 @@
     \ingroup DPD
     \brief Enter brief description of file here
 */
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <sstream>
 #include "psi4/libqt/qt.h"
 #include "dpd.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -44,6 +48,9 @@ void DPD::file4_cache_init() {
     dpd_main.file4_cache_least_recent = 1;
     dpd_main.file4_cache_lru_del = 0;
     dpd_main.file4_cache_low_del = 0;
+    dpd_main.file4_cache_adaptive_del = 0;
+    dpd_main.file4_cache_inflation = 0.0;
+    dpd_main.file4_cache_stats.clear();
 }
 
 void DPD::file4_cache_close() {
@@ -62,6 +69,7 @@ void DPD::file4_cache_close() {
         /* Clean out each file4_cache entry */
         file4_init(&Outfile, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
                    this_entry->label);
+        dpd_main.file4_cache_stats[this_entry->stat].hits--; /* bookkeeping, not a real access */
 
         next_entry = this_entry->next;
 
@@ -94,6 +102,7 @@ dpd_file4_cache_entry *DPD::file4_cache_scan(int filenum, int irrep, int pqnum,
             /* increment the access timers */
             dpd_main.file4_cache_most_recent++;
             this_entry->access = dpd_main.file4_cache_most_recent;
+            this_entry->inflation = dpd_main.file4_cache_inflation;
 
             /* increment the usage counter */
             this_entry->usage++;
@@ -146,13 +155,24 @@ int DPD::file4_cache_add(dpdfile4 *File, size_t priority) {
         dpdnum = dpd_default;
         dpd_set_default(File->dpdnum);
 
-        /* Read all data into core */
+        /* Read all data into core, timing the reads so the adaptive cache knows the reload cost */
+        auto start = std::chrono::steady_clock::now();
         this_entry->size = 0;
         for (h = 0; h < File->params->nirreps; h++) {
             this_entry->size += File->params->rowtot[h] * File->params->coltot[h ^ (File->my_irrep)];
             file4_mat_irrep_init(File, h);
             file4_mat_irrep_rd(File, h);
         }
+        this_entry->cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        this_entry->inflation = dpd_main.file4_cache_inflation;
+
+        /* Record the miss in the per-buffer statistics */
+        this_entry->stat = file4_cache_stat_index(File);
+        dpd_file4_cache_stat &stat = dpd_main.file4_cache_stats[this_entry->stat];
+        stat.size = this_entry->size;
+        stat.misses++;
+        stat.io_time += this_entry->cost;
+        if (stat.evictions) stat.bytes_reloaded += this_entry->size * sizeof(double);
 
         this_entry->dpdnum = File->dpdnum;
         this_entry->filenum = File->filenum;
@@ -267,8 +287,8 @@ void DPD::file4_cache_print_screen() {
     outfile->Printf("--------------------------------------------------------------------------------\n");
     outfile->Printf("Total cached: %9.1f kB; MRU = %6zu; LRU = %6zu\n", (total_size * sizeof(double)) / 1e3,
                     dpd_main.file4_cache_most_recent, dpd_main.file4_cache_least_recent);
-    outfile->Printf("#LRU deletions = %6zu; #Low-priority deletions = %6zu\n", dpd_main.file4_cache_lru_del,
-                    dpd_main.file4_cache_low_del);
+    outfile->Printf("#LRU deletions = %6zu; #Low-priority deletions = %6zu; #Adaptive deletions = %6zu\n",
+                    dpd_main.file4_cache_lru_del, dpd_main.file4_cache_low_del, dpd_main.file4_cache_adaptive_del);
     outfile->Printf("Core max size:  %9.1f kB\n", (dpd_main.memory) * sizeof(double) / 1e3);
     outfile->Printf("Core used:      %9.1f kB\n", (dpd_main.memused) * sizeof(double) / 1e3);
     outfile->Printf("Core available: %9.1f kB\n", dpd_memfree() * sizeof(double) / 1e3);
@@ -299,8 +319,8 @@ void DPD::file4_cache_print(std::string out) {
     printer->Printf("--------------------------------------------------------------------------------\n");
     printer->Printf("Total cached: %8.1f kB; MRU = %6zu; LRU = %6zu\n", (total_size * sizeof(double)) / 1e3,
                     dpd_main.file4_cache_most_recent, dpd_main.file4_cache_least_recent);
-    printer->Printf("#LRU deletions = %6zu; #Low-priority deletions = %6zu\n", dpd_main.file4_cache_lru_del,
-                    dpd_main.file4_cache_low_del);
+    printer->Printf("#LRU deletions = %6zu; #Low-priority deletions = %6zu; #Adaptive deletions = %6zu\n",
+                    dpd_main.file4_cache_lru_del, dpd_main.file4_cache_low_del, dpd_main.file4_cache_adaptive_del);
     printer->Printf("Core max size:  %9.1f kB\n", (dpd_main.memory) * sizeof(double) / 1e3);
     printer->Printf("Core used:      %9.1f kB\n", (dpd_main.memused) * sizeof(double) / 1e3);
     printer->Printf("Core available: %9.1f kB\n", dpd_memfree() * sizeof(double) / 1e3);
@@ -367,6 +387,7 @@ int DPD::file4_cache_del_lru() {
 
         /* increment the global LRU deletion counter */
         dpd_main.file4_cache_lru_del++;
+        dpd_main.file4_cache_stats[this_entry->stat].evictions++;
 
         /* Save the current dpd_default */
         dpdnum = dpd_default;
@@ -374,6 +395,7 @@ int DPD::file4_cache_del_lru() {
 
         file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
                    this_entry->label);
+        dpd_main.file4_cache_stats[this_entry->stat].hits--; /* bookkeeping, not a real access */
 
         file4_cache_del(&File);
         file4_close(&File);
@@ -470,6 +492,7 @@ int DPD::file4_cache_del_low() {
 
         /* increment the global LOW deletion counter */
         dpd_main.file4_cache_low_del++;
+        dpd_main.file4_cache_stats[this_entry->stat].evictions++;
 
         /* save the current dpd default value */
         dpdnum = dpd_default;
@@ -478,6 +501,7 @@ int DPD::file4_cache_del_low() {
 
         file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
                    this_entry->label);
+        dpd_main.file4_cache_stats[this_entry->stat].hits--; /* bookkeeping, not a real access */
         file4_cache_del(&File);
         file4_close(&File);
 
@@ -526,4 +550,222 @@ void DPD::file4_cache_unlock(dpdfile4 *File) {
     }
 }
 
+/* file4_cache_stat_index(): Returns the index of File's entry in the
+** per-buffer cache statistics, creating one if this is the first time
+** the buffer has been seen.  The statistics outlive the cache entry
+** itself so that reloads after an eviction can be counted.
+*/
+int DPD::file4_cache_stat_index(dpdfile4 *File) {
+    for (size_t i = 0; i < dpd_main.file4_cache_stats.size(); i++) {
+        const dpd_file4_cache_stat &stat = dpd_main.file4_cache_stats[i];
+        if (stat.filenum == File->filenum && stat.irrep == File->my_irrep && stat.pqnum == File->params->pqnum &&
+            stat.rsnum == File->params->rsnum && stat.dpdnum == File->dpdnum && !strcmp(stat.label, File->label))
+            return static_cast<int>(i);
+    }
+
+    dpd_file4_cache_stat stat;
+    ::memset(&stat, 0, sizeof(dpd_file4_cache_stat));
+    stat.dpdnum = File->dpdnum;
+    stat.filenum = File->filenum;
+    stat.irrep = File->my_irrep;
+    stat.pqnum = File->params->pqnum;
+    stat.rsnum = File->params->rsnum;
+    strcpy(stat.label, File->label);
+    dpd_main.file4_cache_stats.push_back(stat);
+
+    return static_cast<int>(dpd_main.file4_cache_stats.size()) - 1;
+}
+
+/* file4_cache_hit(): Records a file4_init() that was satisfied from the cache. */
+void DPD::file4_cache_hit(dpd_file4_cache_entry *entry) { dpd_main.file4_cache_stats[entry->stat].hits++; }
+
+/* file4_cache_get_trace_priority(): Returns the number of accesses a
+** previous run of the same calculation recorded for File (see
+** file4_cache_trace_load()), or zero if no trace is available.  The
+** adaptive cache uses this to seed the access frequency of new
+** entries, so buffers that were hot last time are retained from the
+** first iteration on.
+*/
+size_t DPD::file4_cache_get_trace_priority(dpdfile4 *File) {
+    for (const dpd_file4_cache_stat &trace : dpd_main.file4_cache_trace) {
+        if (trace.filenum == File->filenum && trace.irrep == File->my_irrep && trace.pqnum == File->params->pqnum &&
+            trace.rsnum == File->params->rsnum && trace.dpdnum == File->dpdnum && !strcmp(trace.label, File->label))
+            return trace.hits + trace.misses;
+    }
+
+    return 0;
+}
+
+/* dpd_file4_cache_score(): Greedy-dual-size-frequency score of a cache
+** entry: the clock value at its last access plus (access frequency) x
+** (reload cost) / (size).  Entries that are cheap to re-read, rarely
+** used, or large relative to their cost have the lowest scores.  When a
+** read was too fast to time, the cost falls back to the entry's size
+** times the average seconds-per-double of all timed reads.
+*/
+static double dpd_file4_cache_score(const dpd_file4_cache_entry *entry, double rate) {
+    double size = std::max(entry->size, 1);
+    double cost = entry->cost > 0.0 ? entry->cost : size * rate;
+    double freq = entry->usage + entry->priority;
+
+    return entry->inflation + freq * cost / size;
+}
+
+dpd_file4_cache_entry *DPD::file4_cache_find_adaptive() {
+    dpd_file4_cache_entry *this_entry, *low_entry;
+    double io_time = 0.0, io_size = 0.0, rate, score, low_score = 0.0;
+
+    for (const dpd_file4_cache_stat &stat : dpd_main.file4_cache_stats) {
+        io_time += stat.io_time;
+        io_size += static_cast<double>(stat.size) * stat.misses;
+    }
+    rate = (io_time > 0.0 && io_size > 0.0) ? io_time / io_size : 1.0;
+
+    low_entry = nullptr;
+    for (this_entry = dpd_main.file4_cache; this_entry != nullptr; this_entry = this_entry->next) {
+        if (this_entry->lock) continue;
+        score = dpd_file4_cache_score(this_entry, rate);
+        if (low_entry == nullptr || score < low_score) {
+            low_entry = this_entry;
+            low_score = score;
+        }
+    }
+
+    /* Age the cache: later entries are scored relative to this victim */
+    if (low_entry != nullptr) dpd_main.file4_cache_inflation = low_score;
+
+    return low_entry;
+}
+
+int DPD::file4_cache_del_adaptive() {
+    int dpdnum;
+    dpdfile4 File;
+    dpd_file4_cache_entry *this_entry;
+
+#ifdef DPD_TIMER
+    timer_on("cache_adaptive");
+#endif
+
+    this_entry = file4_cache_find_adaptive();
+
+    if (this_entry == nullptr) {
+#ifdef DPD_TIMER
+        timer_off("cache_adaptive");
+#endif
+        return 1; /* there is no cache or everything is locked */
+    }
+
+    /* increment the global adaptive deletion counter */
+    dpd_main.file4_cache_adaptive_del++;
+    dpd_main.file4_cache_stats[this_entry->stat].evictions++;
+
+    /* save the current dpd default value */
+    dpdnum = dpd_default;
+    dpd_set_default(this_entry->dpdnum);
+
+    file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
+               this_entry->label);
+    dpd_main.file4_cache_stats[this_entry->stat].hits--; /* bookkeeping, not a real access */
+    file4_cache_del(&File);
+    file4_close(&File);
+
+    /* return the default dpd to its original value */
+    dpd_set_default(dpdnum);
+
+#ifdef DPD_TIMER
+    timer_off("cache_adaptive");
+#endif
+
+    return 0;
+}
+
+void DPD::file4_cache_print_stats(std::string out) {
+    std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
+    size_t hits = 0, misses = 0, evictions = 0, reloaded = 0;
+    double io_time = 0.0;
+
+    if (dpd_main.file4_cache_stats.empty()) return;
+
+    printer->Printf("\n\tDPD File4 Cache Statistics:\n\n");
+    printer->Printf("Cache Label            DPD File symm  pq  rs    hits  misses  evict  size(kB) reload(MB)  I/O(s)\n");
+    printer->Printf("------------------------------------------------------------------------------------------------\n");
+    for (const dpd_file4_cache_stat &stat : dpd_main.file4_cache_stats) {
+        printer->Printf("%-22s  %1d   %3d   %1d   %2d  %2d  %6zu  %6zu  %5zu  %8.1f  %9.2f  %6.2f\n", stat.label,
+                        stat.dpdnum, stat.filenum, stat.irrep, stat.pqnum, stat.rsnum, stat.hits, stat.misses,
+                        stat.evictions, stat.size * sizeof(double) / 1e3, stat.bytes_reloaded / 1e6, stat.io_time);
+        hits += stat.hits;
+        misses += stat.misses;
+        evictions += stat.evictions;
+        reloaded += stat.bytes_reloaded;
+        io_time += stat.io_time;
+    }
+    printer->Printf("------------------------------------------------------------------------------------------------\n");
+    printer->Printf("Hits = %zu; Misses = %zu; Hit rate = %5.1f%%\n", hits, misses,
+                    (hits + misses) ? 100.0 * hits / (hits + misses) : 0.0);
+    printer->Printf("Evictions = %zu; Reloaded = %.2f MB; Cache I/O time = %.2f s\n", evictions, reloaded / 1e6,
+                    io_time);
+}
+
+/* file4_cache_trace_save(): Writes the per-buffer access counts, sizes,
+** and read times of the current run to fname, merged with any trace
+** previously loaded, for use by file4_cache_trace_load() in a later run
+** of the same calculation.  Returns 0 on success.
+*/
+int DPD::file4_cache_trace_save(const std::string &fname) {
+    std::vector<dpd_file4_cache_stat> trace = dpd_main.file4_cache_stats;
+
+    /* Keep entries from the previous trace that this run never touched */
+    for (const dpd_file4_cache_stat &old : dpd_main.file4_cache_trace) {
+        bool found = false;
+        for (const dpd_file4_cache_stat &stat : trace) {
+            if (stat.filenum == old.filenum && stat.irrep == old.irrep && stat.pqnum == old.pqnum &&
+                stat.rsnum == old.rsnum && stat.dpdnum == old.dpdnum && !strcmp(stat.label, old.label)) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) trace.push_back(old);
+    }
+
+    std::ofstream fout(fname);
+    if (!fout) return 1;
+
+    fout << "# DPD file4 cache trace: dpd file irrep pq rs accesses size io_time label\n";
+    for (const dpd_file4_cache_stat &stat : trace) {
+        fout << stat.dpdnum << " " << stat.filenum << " " << stat.irrep << " " << stat.pqnum << " " << stat.rsnum
+             << " " << stat.hits + stat.misses << " " << stat.size << " " << stat.io_time << " " << stat.label << "\n";
+    }
+
+    return fout.good() ? 0 : 1;
+}
+
+/* file4_cache_trace_load(): Reads a trace written by
+** file4_cache_trace_save().  Returns 0 if a trace was found.
+*/
+int DPD::file4_cache_trace_load(const std::string &fname) {
+    std::ifstream fin(fname);
+    std::string line;
+
+    dpd_main.file4_cache_trace.clear();
+    if (!fin) return 1;
+
+    while (std::getline(fin, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        dpd_file4_cache_stat stat;
+        ::memset(&stat, 0, sizeof(dpd_file4_cache_stat));
+        std::istringstream iss(line);
+        std::string label;
+        if (!(iss >> stat.dpdnum >> stat.filenum >> stat.irrep >> stat.pqnum >> stat.rsnum >> stat.hits >>
+              stat.size >> stat.io_time))
+            continue;
+        std::getline(iss >> std::ws, label);
+        if (label.empty() || label.size() >= PSIO_KEYLEN) continue;
+        strcpy(stat.label, label.c_str());
+        dpd_main.file4_cache_trace.push_back(stat);
+    }
+
+    return 0;
+}
+
 }  // namespace psi
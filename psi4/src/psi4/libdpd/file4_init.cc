@@ -71,6 +71,7 @@ int DPD::file4_init(dpdfile4 *File, int filenum, int irrep, int pqnum, int rsnum
     if (this_entry != nullptr) {
         File->incore = 1;
         File->matrix = this_entry->matrix;
+        file4_cache_hit(this_entry);
     } else {
         File->incore = 0;
         File->matrix = (double ***)malloc(File->params->nirreps * sizeof(double **));
@@ -107,6 +108,8 @@ int DPD::file4_init(dpdfile4 *File, int filenum, int irrep, int pqnum, int rsnum
         /* Get the file4's cache priority */
         if (dpd_main.cachetype == 1)
             priority = file4_cache_get_priority(File);
+        else if (dpd_main.cachetype == 2)
+            priority = file4_cache_get_trace_priority(File);
         else
             priority = 0;
 
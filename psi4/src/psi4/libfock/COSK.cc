@@ -0,0 +1,388 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libfock/cubature.h"
+#include "psi4/libfock/points.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/potential.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+
+#include "jk.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+COSK::COSK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options)
+    : JK(primary), options_(options), auxiliary_(auxiliary) {
+    kscreen_ = options_.get_double("COSX_INTS_TOLERANCE");
+    overlap_fitted_ = options_.get_bool("COSX_OVERLAP_FITTING");
+
+    // J goes to density fitting if there is a fitting basis, to four-index integrals otherwise
+    if (auxiliary_ && auxiliary_->nbf() > 0) {
+        jk_ = JK::build_JK(primary_, auxiliary_, options_, "MEM_DF");
+    } else {
+        jk_ = JK::build_JK(primary_, auxiliary_, options_, "DIRECT");
+    }
+}
+COSK::~COSK() {}
+
+size_t COSK::memory_estimate() {
+    size_t nbf = primary_->nbf();
+    return jk_->memory_estimate() + (1 + (size_t)omp_nthread_) * nbf * nbf;
+}
+
+void COSK::set_do_wK(bool do_wK) {
+    if (do_wK) throw PSIEXCEPTION("COSK: range-separated exchange (wK) is not available, choose another SCF_TYPE.");
+    do_wK_ = do_wK;
+}
+
+void COSK::print_header() const {
+    if (print_) {
+        outfile->Printf("  ==> COSK: Chain-of-Spheres Seminumerical K <==\n\n");
+
+        outfile->Printf("    J tasked:           %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf("    K tasked:           %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf("    J algorithm:        %11s\n", jk_->name().c_str());
+        outfile->Printf("    OpenMP threads:     %11d\n", omp_nthread_);
+        outfile->Printf("    Grid points:        %11zu\n", (grid_ ? (size_t)grid_->npoints() : (size_t)0));
+        outfile->Printf("    Radial points:      %11d\n", options_.get_int("COSX_RADIAL_POINTS"));
+        outfile->Printf("    Spherical points:   %11d\n", options_.get_int("COSX_SPHERICAL_POINTS"));
+        outfile->Printf("    Integral Cutoff:    %11.0E\n", kscreen_);
+        outfile->Printf("    Overlap Fitting:    %11s\n\n", (overlap_fitted_ ? "Yes" : "No"));
+    }
+    if (do_J_) jk_->print_header();
+}
+
+void COSK::preiterations() {
+    size_t nbf = primary_->nbf();
+    size_t nshell = primary_->nshell();
+
+    // => Grid <= //
+
+    std::map<std::string, std::string> opt_map;
+    std::map<std::string, int> opt_int_map;
+    opt_int_map["DFT_RADIAL_POINTS"] = options_.get_int("COSX_RADIAL_POINTS");
+    opt_int_map["DFT_SPHERICAL_POINTS"] = options_.get_int("COSX_SPHERICAL_POINTS");
+    grid_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, opt_int_map, opt_map, options_);
+
+    // => Per-thread workers <= //
+
+    auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+    point_workers_.clear();
+    int_workers_.clear();
+    charges_.clear();
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        auto worker = std::make_shared<BasisFunctions>(primary_, grid_->max_points(), grid_->max_functions());
+        worker->set_deriv(0);
+        point_workers_.push_back(worker);
+
+        // A single charge of -1, moved to each grid point, gives +(mn|1/|r-g|)
+        auto charge = std::make_shared<Matrix>("COSK Point Charge", 1, 4);
+        charge->set(0, 0, -1.0);
+        auto ints = std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(factory->ao_potential()));
+        ints->set_charge_field(charge);
+        int_workers_.push_back(ints);
+        charges_.push_back(charge);
+    }
+
+    // => Shell pairs with significant overlap, from their most diffuse primitives <= //
+
+    shell_pairs_.assign(nshell, std::vector<int>());
+    for (size_t P = 0; P < nshell; P++) {
+        const GaussianShell& Pshell = primary_->shell(P);
+        double aP = *std::min_element(Pshell.exps(), Pshell.exps() + Pshell.nprimitive());
+        Vector3 A = Pshell.center();
+        for (size_t Q = 0; Q < nshell; Q++) {
+            const GaussianShell& Qshell = primary_->shell(Q);
+            double aQ = *std::min_element(Qshell.exps(), Qshell.exps() + Qshell.nprimitive());
+            double R2 = A.distance(Qshell.center());
+            R2 *= R2;
+            if (std::exp(-aP * aQ / (aP + aQ) * R2) >= kscreen_) shell_pairs_[P].push_back(Q);
+        }
+    }
+
+    // => Overlap fitting metric, Q = S_num^-1 S_an makes the quadrature exact for the overlap <= //
+
+    Q_.reset();
+    if (overlap_fitted_) {
+        std::vector<SharedMatrix> S_thread;
+        for (int thread = 0; thread < omp_nthread_; thread++) {
+            S_thread.push_back(std::make_shared<Matrix>("S numerical", nbf, nbf));
+        }
+
+        const auto& blocks = grid_->blocks();
+#pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+        for (size_t b = 0; b < blocks.size(); b++) {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            std::shared_ptr<BlockOPoints> block = blocks[b];
+            size_t npoints = block->npoints();
+            const std::vector<int>& bf_map = block->functions_local_to_global();
+            size_t nlocal = bf_map.size();
+            if (!npoints || !nlocal) continue;
+
+            point_workers_[rank]->compute_functions(block);
+            SharedMatrix phi = point_workers_[rank]->basis_value("PHI");
+            double** Xp = phi->pointer();
+            size_t ldx = phi->ncol();
+            double* w = block->w();
+
+            std::vector<double> XW(npoints * nlocal);
+            for (size_t P = 0; P < npoints; P++) {
+                for (size_t ml = 0; ml < nlocal; ml++) XW[P * nlocal + ml] = w[P] * Xp[P][ml];
+            }
+            std::vector<double> Sl(nlocal * nlocal);
+            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, XW.data(), nlocal, Xp[0], ldx, 0.0, Sl.data(), nlocal);
+
+            double** Sp = S_thread[rank]->pointer();
+            for (size_t ml = 0; ml < nlocal; ml++) {
+                for (size_t nl = 0; nl < nlocal; nl++) Sp[bf_map[ml]][bf_map[nl]] += Sl[ml * nlocal + nl];
+            }
+        }
+        for (int thread = 1; thread < omp_nthread_; thread++) S_thread[0]->add(S_thread[thread]);
+
+        auto S_an = std::make_shared<Matrix>("S analytic", nbf, nbf);
+        std::shared_ptr<OneBodyAOInt> overlap(factory->ao_overlap());
+        overlap->compute(S_an);
+
+        S_thread[0]->power(-1.0, 1.0E-12);
+        Q_ = linalg::doublet(S_thread[0], S_an);
+        Q_->set_name("COSK Overlap Fitting");
+    }
+
+    // => J builder <= //
+
+    jk_->set_do_J(do_J_);
+    jk_->set_do_K(false);
+    jk_->set_do_wK(false);
+    jk_->set_print(print_);
+    jk_->set_debug(debug_);
+    jk_->set_omp_nthread(omp_nthread_);
+    size_t own = (1 + (size_t)omp_nthread_) * nbf * nbf;
+    jk_->set_memory(memory_ > own ? memory_ - own : 0);
+    if (do_J_) jk_->initialize();
+}
+
+void COSK::compute_JK() {
+    if (do_J_) {
+        jk_->C_left() = C_left_ao_;
+        jk_->C_right().clear();
+        if (!lr_symmetric_) jk_->C_right() = C_right_ao_;
+        jk_->compute();
+        for (size_t N = 0; N < D_ao_.size(); N++) J_ao_[N]->copy(jk_->J()[N]);
+    }
+
+    if (do_K_) build_K();
+}
+
+void COSK::build_K() {
+    size_t nbf = primary_->nbf();
+    size_t nshell = primary_->nshell();
+    size_t njk = D_ao_.size();
+    if (!njk) return;
+
+    timer_on("COSK: K");
+
+    // Per-thread numerical K, K_mn = sum_g w_g X_mg sum_s A_ns(g) F_sg with F_sg = sum_l X_lg D_ls
+    std::vector<std::vector<SharedMatrix>> KT(omp_nthread_);
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        for (size_t jk = 0; jk < njk; jk++) KT[thread].push_back(std::make_shared<Matrix>("K numerical", nbf, nbf));
+    }
+
+    const auto& blocks = grid_->blocks();
+#pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+    for (size_t b = 0; b < blocks.size(); b++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        std::shared_ptr<BlockOPoints> block = blocks[b];
+        size_t npoints = block->npoints();
+        const std::vector<int>& bf_map = block->functions_local_to_global();
+        size_t nlocal = bf_map.size();
+        if (!npoints || !nlocal) continue;
+
+        // => Collocation <= //
+
+        point_workers_[rank]->compute_functions(block);
+        SharedMatrix phi = point_workers_[rank]->basis_value("PHI");
+        double** Xp = phi->pointer();
+        size_t ldx = phi->ncol();
+        double* x = block->x();
+        double* y = block->y();
+        double* z = block->z();
+        double* w = block->w();
+
+        double Xsum = 0.0;
+        std::vector<double> XW(npoints * nlocal);
+        for (size_t P = 0; P < npoints; P++) {
+            double row = 0.0;
+            for (size_t ml = 0; ml < nlocal; ml++) {
+                XW[P * nlocal + ml] = w[P] * Xp[P][ml];
+                row += std::fabs(Xp[P][ml]);
+            }
+            Xsum = std::max(Xsum, row);
+        }
+
+        // => Screening: |F_sg| <= Xsum * max_l |D_ls|, so keep the shells s with a large enough bound <= //
+
+        std::vector<char> kept(nshell, 0);
+        std::vector<int> s_shells;
+        std::vector<size_t> s_offset(nshell, 0);
+        size_t ns = 0;
+        for (size_t S = 0; S < nshell; S++) {
+            int s0 = primary_->shell_to_basis_function(S);
+            int nS = primary_->shell(S).nfunction();
+            double Dmax = 0.0;
+            for (size_t jk = 0; jk < njk; jk++) {
+                double** Dp = D_ao_[jk]->pointer();
+                for (size_t ml = 0; ml < nlocal; ml++) {
+                    for (int s = s0; s < s0 + nS; s++) Dmax = std::max(Dmax, std::fabs(Dp[bf_map[ml]][s]));
+                }
+            }
+            if (Xsum * Dmax < kscreen_) continue;
+            kept[S] = 1;
+            s_shells.push_back(S);
+            s_offset[S] = ns;
+            ns += nS;
+        }
+        if (!ns) continue;
+
+        // Shells n that overlap a kept s, with those partners
+        std::vector<int> n_shells;
+        std::vector<std::vector<int>> n_partners;
+        std::vector<size_t> n_offset;
+        size_t nn = 0;
+        for (size_t N = 0; N < nshell; N++) {
+            std::vector<int> partners;
+            for (int S : shell_pairs_[N]) {
+                if (kept[S]) partners.push_back(S);
+            }
+            if (partners.empty()) continue;
+            n_shells.push_back(N);
+            n_partners.push_back(partners);
+            n_offset.push_back(nn);
+            nn += primary_->shell(N).nfunction();
+        }
+
+        // => F = X D, on the kept columns <= //
+
+        std::vector<double> Dl(nlocal * ns);
+        std::vector<std::vector<double>> F(njk, std::vector<double>(npoints * ns));
+        for (size_t jk = 0; jk < njk; jk++) {
+            double** Dp = D_ao_[jk]->pointer();
+            for (size_t ml = 0; ml < nlocal; ml++) {
+                for (int S : s_shells) {
+                    int s0 = primary_->shell_to_basis_function(S);
+                    int nS = primary_->shell(S).nfunction();
+                    for (int s = 0; s < nS; s++) Dl[ml * ns + s_offset[S] + s] = Dp[bf_map[ml]][s0 + s];
+                }
+            }
+            C_DGEMM('N', 'N', npoints, ns, nlocal, 1.0, Xp[0], ldx, Dl.data(), ns, 0.0, F[jk].data(), ns);
+        }
+
+        // => G_ng = sum_s A_ns(g) F_sg, one point charge at a time <= //
+
+        std::vector<std::vector<double>> G(njk, std::vector<double>(npoints * nn, 0.0));
+        std::shared_ptr<PotentialInt> ints = int_workers_[rank];
+        double** Cp = charges_[rank]->pointer();
+        const double* buffer = ints->buffer();
+        for (size_t P = 0; P < npoints; P++) {
+            Cp[0][1] = x[P];
+            Cp[0][2] = y[P];
+            Cp[0][3] = z[P];
+            for (size_t i = 0; i < n_shells.size(); i++) {
+                int N = n_shells[i];
+                int nN = primary_->shell(N).nfunction();
+                for (int S : n_partners[i]) {
+                    int nS = primary_->shell(S).nfunction();
+                    ints->compute_shell(N, S);
+                    for (size_t jk = 0; jk < njk; jk++) {
+                        const double* Fp = &F[jk][P * ns + s_offset[S]];
+                        double* Gp = &G[jk][P * nn + n_offset[i]];
+                        for (int n = 0; n < nN; n++) Gp[n] += C_DDOT(nS, const_cast<double*>(&buffer[n * nS]), 1,
+                                                                     const_cast<double*>(Fp), 1);
+                    }
+                }
+            }
+        }
+
+        // => K_mn += sum_g w_g X_mg G_ng <= //
+
+        std::vector<double> Kl(nlocal * nn);
+        for (size_t jk = 0; jk < njk; jk++) {
+            C_DGEMM('T', 'N', nlocal, nn, npoints, 1.0, XW.data(), nlocal, G[jk].data(), nn, 0.0, Kl.data(), nn);
+            double** KTp = KT[rank][jk]->pointer();
+            for (size_t ml = 0; ml < nlocal; ml++) {
+                for (size_t i = 0; i < n_shells.size(); i++) {
+                    int n0 = primary_->shell_to_basis_function(n_shells[i]);
+                    int nN = primary_->shell(n_shells[i]).nfunction();
+                    for (int n = 0; n < nN; n++) KTp[bf_map[ml]][n0 + n] += Kl[ml * nn + n_offset[i] + n];
+                }
+            }
+        }
+    }
+
+    // => Reduce, fit, symmetrize <= //
+
+    for (size_t jk = 0; jk < njk; jk++) {
+        for (int thread = 1; thread < omp_nthread_; thread++) KT[0][jk]->add(KT[thread][jk]);
+        if (overlap_fitted_) {
+            K_ao_[jk]->gemm(true, false, 1.0, Q_, KT[0][jk], 0.0);
+        } else {
+            K_ao_[jk]->copy(KT[0][jk]);
+        }
+        if (lr_symmetric_) K_ao_[jk]->hermitivitize();
+    }
+
+    timer_off("COSK: K");
+}
+
+void COSK::postiterations() {
+    if (do_J_) jk_->finalize();
+    point_workers_.clear();
+    int_workers_.clear();
+    charges_.clear();
+    grid_.reset();
+    Q_.reset();
+}
+
+}  // namespace psi
@@ -45,6 +45,7 @@
 #include "psi4/liboptions/liboptions.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <sstream>
 #include <set>
@@ -83,6 +84,16 @@ void DirectJK::common_init() {
 #ifdef _OPENMP
     df_ints_num_threads_ = Process::environment.get_n_threads();
 #endif
+    incfock_ = false;
+    incfock_full_fock_every_ = 10;
+    incfock_count_ = 0;
+    incfock_incremental_builds_ = 0L;
+    computed_quartets_ = 0L;
+    density_screened_quartets_ = 0L;
+    linK_ = false;
+    linK_ints_cutoff_ = 0.0;
+    linK_ints_cutoff_set_ = false;
+    linK_quartets_ = 0L;
 }
 size_t DirectJK::memory_estimate() {
     return 0;  // Effectively
@@ -97,7 +108,12 @@ void DirectJK::print_header() const {
         if (do_wK_) outfile->Printf("    Omega:             %11.3E\n", omega_);
         outfile->Printf("    Integrals threads: %11d\n", df_ints_num_threads_);
         // outfile->Printf( "    Memory [MiB]:      %11ld\n", (memory_ *8L) / (1024L * 1024L));
-        outfile->Printf("    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
+        outfile->Printf("    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        outfile->Printf("    Incremental Fock:  %11s\n", (incfock_ ? "Yes" : "No"));
+        if (incfock_) outfile->Printf("    Full Fock Every:   %11d\n", incfock_full_fock_every_);
+        outfile->Printf("    LinK Exchange:     %11s\n", (linK_ ? "Yes" : "No"));
+        if (linK_) outfile->Printf("    LinK Cutoff:       %11.0E\n", (linK_ints_cutoff_set_ ? linK_ints_cutoff_ : cutoff_));
+        outfile->Printf("\n");
     }
 }
 void DirectJK::preiterations() {
@@ -271,6 +287,32 @@ void DirectJK::compute_JK() {
     }
 #endif
 
+    // => Incremental Fock build <= //
+
+    // Only SCF iterations (flagged by the caller) with a compatible previous
+    // build are done incrementally: J[D] = J[D_prev] + J[D - D_prev], etc.
+    bool incfock_iter = incfock_ && do_incfock_iter_;
+    bool incremental = false;
+    if (incfock_iter) {
+        incremental = (incfock_count_ % incfock_full_fock_every_ != 0) && (D_prev_.size() == D_ao_.size()) &&
+                      (!do_J_ || J_prev_.size() == D_ao_.size()) && (!do_K_ || K_prev_.size() == D_ao_.size()) &&
+                      (!do_wK_ || wK_prev_.size() == D_ao_.size());
+        incfock_count_++;
+    }
+    do_incfock_iter_ = false;
+
+    std::vector<SharedMatrix> D_full;
+    if (incremental) {
+        D_full = D_ao_;
+        std::vector<SharedMatrix> D_delta;
+        for (size_t i = 0; i < D_ao_.size(); i++) {
+            D_delta.push_back(D_ao_[i]->clone());
+            D_delta[i]->subtract(D_prev_[i]);
+        }
+        D_ao_ = D_delta;
+        incfock_incremental_builds_++;
+    }
+
     auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
 
     if (do_wK_) {
@@ -296,24 +338,64 @@ void DirectJK::compute_JK() {
         for (int thread = 1; thread < df_ints_num_threads_; thread++) {
             ints.push_back(std::shared_ptr<TwoBodyAOInt>(ints[0]->clone()));
         }
-        if (do_J_ && do_K_) {
+        std::vector<std::shared_ptr<Matrix>> none;
+        if (linK_) {
+            // J and K come from separate quartet lists
+            if (do_J_) build_JK(ints, D_ao_, J_ao_, none);
+            if (do_K_) build_linK(ints, D_ao_, K_ao_);
+        } else if (do_J_ && do_K_) {
             build_JK(ints, D_ao_, J_ao_, K_ao_);
         } else if (do_J_) {
-            std::vector<std::shared_ptr<Matrix>> temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
-            }
-            build_JK(ints, D_ao_, J_ao_, temp);
+            build_JK(ints, D_ao_, J_ao_, none);
         } else {
-            std::vector<std::shared_ptr<Matrix>> temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
-            }
-            build_JK(ints, D_ao_, temp, K_ao_);
+            build_JK(ints, D_ao_, none, K_ao_);
+        }
+    }
+
+    if (incremental) {
+        D_ao_ = D_full;
+        for (size_t i = 0; i < D_ao_.size(); i++) {
+            if (do_J_) J_ao_[i]->add(J_prev_[i]);
+            if (do_K_) K_ao_[i]->add(K_prev_[i]);
+            if (do_wK_) wK_ao_[i]->add(wK_prev_[i]);
         }
     }
+
+    if (incfock_iter) {
+        D_prev_.clear();
+        J_prev_.clear();
+        K_prev_.clear();
+        wK_prev_.clear();
+        for (size_t i = 0; i < D_ao_.size(); i++) {
+            D_prev_.push_back(D_ao_[i]->clone());
+            if (do_J_) J_prev_.push_back(J_ao_[i]->clone());
+            if (do_K_) K_prev_.push_back(K_ao_[i]->clone());
+            if (do_wK_) wK_prev_.push_back(wK_ao_[i]->clone());
+        }
+    }
+}
+void DirectJK::postiterations() {
+    if (incfock_ && print_) {
+        outfile->Printf("  ==> DirectJK: Incremental Fock Statistics <==\n\n");
+        outfile->Printf("    Incremental Builds: %11zu\n", incfock_incremental_builds_);
+        outfile->Printf("    Full Builds:        %11d\n", incfock_count_ - (int)incfock_incremental_builds_);
+        outfile->Printf("    Quartets Computed:  %11zu\n", computed_quartets_);
+        outfile->Printf("    Quartets Screened:  %11zu\n\n", density_screened_quartets_);
+    }
+    if (linK_ && print_) {
+        outfile->Printf("  ==> DirectJK: LinK Statistics <==\n\n");
+        outfile->Printf("    Quartets Computed:  %11zu\n\n", linK_quartets_);
+    }
+    D_prev_.clear();
+    J_prev_.clear();
+    K_prev_.clear();
+    wK_prev_.clear();
+    incfock_count_ = 0;
+    incfock_incremental_builds_ = 0L;
+    computed_quartets_ = 0L;
+    density_screened_quartets_ = 0L;
+    linK_quartets_ = 0L;
 }
-void DirectJK::postiterations() {}
 
 void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::vector<std::shared_ptr<Matrix>>& D,
                         std::vector<std::shared_ptr<Matrix>>& J, std::vector<std::shared_ptr<Matrix>>& K) {
@@ -324,6 +406,9 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
     for (size_t ind = 0; ind < K.size(); ind++) {
         K[ind]->zero();
     }
+    bool build_J = !J.empty();
+    bool build_K = !K.empty();
+
     // => Sizing <= //
 
     int nshell = primary_->nshell();
@@ -417,13 +502,49 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
         JKT.push_back(JK2);
     }
 
+    // => Density Screening <= //
+
+    // Largest density element in each shell block over all densities, used to
+    // drop quartets whose contribution |(PQ|RS)| * max|D| falls under the cutoff.
+    // This is what makes incremental builds cheap as the density change shrinks.
+    std::vector<double> shell_max_density;
+    if (incfock_) {
+        shell_max_density.assign((size_t)nshell * nshell, 0.0);
+        for (size_t ind = 0; ind < D.size(); ind++) {
+            double** Dp = D[ind]->pointer();
+#pragma omp parallel for num_threads(nthread) schedule(dynamic)
+            for (int P = 0; P < nshell; P++) {
+                int Poff = primary_->shell(P).function_index();
+                int Psize = primary_->shell(P).nfunction();
+                for (int Q = 0; Q < nshell; Q++) {
+                    int Qoff = primary_->shell(Q).function_index();
+                    int Qsize = primary_->shell(Q).nfunction();
+                    double& max_val = shell_max_density[P * (size_t)nshell + Q];
+                    for (int p = Poff; p < Poff + Psize; p++) {
+                        for (int q = Qoff; q < Qoff + Qsize; q++) {
+                            max_val = std::max(max_val, std::fabs(Dp[p][q]));
+                        }
+                    }
+                }
+            }
+        }
+        // Either index order of a block may be contracted against, symmetrize
+        for (int P = 0; P < nshell; P++) {
+            for (int Q = 0; Q < P; Q++) {
+                double val = std::max(shell_max_density[P * (size_t)nshell + Q], shell_max_density[Q * (size_t)nshell + P]);
+                shell_max_density[P * (size_t)nshell + Q] = shell_max_density[Q * (size_t)nshell + P] = val;
+            }
+        }
+    }
+
     // => Benchmarks <= //
 
     size_t computed_shells = 0L;
+    size_t screened_shells = 0L;
 
 // ==> Master Task Loop <== //
 
-#pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+ : computed_shells)
+#pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+ : computed_shells, screened_shells)
     for (size_t task = 0L; task < ntask_pair2; task++) {
         size_t task1 = task / ntask_pair;
         size_t task2 = task % ntask_pair;
@@ -479,6 +600,24 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
                         if (R2 * nshell + S2 > P2 * nshell + Q2) continue;
                         if (!ints[0]->shell_pair_significant(R, S)) continue;
                         if (!ints[0]->shell_significant(P, Q, R, S)) continue;
+                        if (incfock_) {
+                            // J only sees the PQ and RS blocks, K only the four mixed ones
+                            double D_max = 0.0;
+                            if (build_J) {
+                                D_max = std::max({D_max, shell_max_density[P * (size_t)nshell + Q],
+                                                  shell_max_density[R * (size_t)nshell + S]});
+                            }
+                            if (build_K) {
+                                D_max = std::max({D_max, shell_max_density[P * (size_t)nshell + R],
+                                                  shell_max_density[P * (size_t)nshell + S],
+                                                  shell_max_density[Q * (size_t)nshell + R],
+                                                  shell_max_density[Q * (size_t)nshell + S]});
+                            }
+                            if (std::sqrt(ints[0]->shell_ceiling2(P, Q, R, S)) * D_max < cutoff_) {
+                                screened_shells++;
+                                continue;
+                            }
+                        }
 
                         // printf("Quartet: %2d %2d %2d %2d\n", P, Q, R, S);
 
@@ -552,12 +691,18 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
                                 for (int q = 0; q < Qsize; q++) {
                                     for (int r = 0; r < Rsize; r++) {
                                         for (int s = 0; s < Ssize; s++) {
-                                            J1p[(p + Poff2) * dQsize + q + Qoff2] +=
-                                                prefactor * (Dp[r + Roff][s + Soff] + Dp[s + Soff][r + Roff]) *
-                                                (*buffer2);
-                                            J2p[(r + Roff2) * dSsize + s + Soff2] +=
-                                                prefactor * (Dp[p + Poff][q + Qoff] + Dp[q + Qoff][p + Poff]) *
-                                                (*buffer2);
+                                            if (build_J) {
+                                                J1p[(p + Poff2) * dQsize + q + Qoff2] +=
+                                                    prefactor * (Dp[r + Roff][s + Soff] + Dp[s + Soff][r + Roff]) *
+                                                    (*buffer2);
+                                                J2p[(r + Roff2) * dSsize + s + Soff2] +=
+                                                    prefactor * (Dp[p + Poff][q + Qoff] + Dp[q + Qoff][p + Poff]) *
+                                                    (*buffer2);
+                                            }
+                                            if (!build_K) {
+                                                buffer2++;
+                                                continue;
+                                            }
                                             K1p[(p + Poff2) * dRsize + r + Roff2] +=
                                                 prefactor * (Dp[q + Qoff][s + Soff]) * (*buffer2);
                                             K2p[(p + Poff2) * dSsize + s + Soff2] +=
@@ -596,8 +741,8 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
         // if (thread == 0) timer_on("JK: Atomic");
         for (size_t ind = 0; ind < D.size(); ind++) {
             double** JKTp = JKT[thread][ind]->pointer();
-            double** Jp = J[ind]->pointer();
-            double** Kp = K[ind]->pointer();
+            double** Jp = (build_J ? J[ind]->pointer() : nullptr);
+            double** Kp = (build_K ? K[ind]->pointer() : nullptr);
 
             double* J1p = JKTp[0L * max_task];
             double* J2p = JKTp[1L * max_task];
@@ -618,41 +763,43 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
 
             // > J_PQ < //
 
-            for (int P2 = 0; P2 < nPtask; P2++) {
-                for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                    int P = task_shells[P2start + P2];
-                    int Q = task_shells[Q2start + Q2];
-                    int Psize = primary_->shell(P).nfunction();
-                    int Qsize = primary_->shell(Q).nfunction();
-                    int Poff = primary_->shell(P).function_index();
-                    int Qoff = primary_->shell(Q).function_index();
-                    int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                    int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                    for (int p = 0; p < Psize; p++) {
-                        for (int q = 0; q < Qsize; q++) {
+            if (build_J) {
+                for (int P2 = 0; P2 < nPtask; P2++) {
+                    for (int Q2 = 0; Q2 < nQtask; Q2++) {
+                        int P = task_shells[P2start + P2];
+                        int Q = task_shells[Q2start + Q2];
+                        int Psize = primary_->shell(P).nfunction();
+                        int Qsize = primary_->shell(Q).nfunction();
+                        int Poff = primary_->shell(P).function_index();
+                        int Qoff = primary_->shell(Q).function_index();
+                        int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
+                        int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
+                        for (int p = 0; p < Psize; p++) {
+                            for (int q = 0; q < Qsize; q++) {
 #pragma omp atomic
-                            Jp[p + Poff][q + Qoff] += J1p[(p + Poff2) * dQsize + q + Qoff2];
+                                Jp[p + Poff][q + Qoff] += J1p[(p + Poff2) * dQsize + q + Qoff2];
+                            }
                         }
                     }
                 }
-            }
 
-            // > J_RS < //
+                // > J_RS < //
 
-            for (int R2 = 0; R2 < nRtask; R2++) {
-                for (int S2 = 0; S2 < nStask; S2++) {
-                    int R = task_shells[R2start + R2];
-                    int S = task_shells[S2start + S2];
-                    int Rsize = primary_->shell(R).nfunction();
-                    int Ssize = primary_->shell(S).nfunction();
-                    int Roff = primary_->shell(R).function_index();
-                    int Soff = primary_->shell(S).function_index();
-                    int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                    int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                    for (int r = 0; r < Rsize; r++) {
-                        for (int s = 0; s < Ssize; s++) {
+                for (int R2 = 0; R2 < nRtask; R2++) {
+                    for (int S2 = 0; S2 < nStask; S2++) {
+                        int R = task_shells[R2start + R2];
+                        int S = task_shells[S2start + S2];
+                        int Rsize = primary_->shell(R).nfunction();
+                        int Ssize = primary_->shell(S).nfunction();
+                        int Roff = primary_->shell(R).function_index();
+                        int Soff = primary_->shell(S).function_index();
+                        int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
+                        int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
+                        for (int r = 0; r < Rsize; r++) {
+                            for (int s = 0; s < Ssize; s++) {
 #pragma omp atomic
-                            Jp[r + Roff][s + Soff] += J2p[(r + Roff2) * dSsize + s + Soff2];
+                                Jp[r + Roff][s + Soff] += J2p[(r + Roff2) * dSsize + s + Soff2];
+                            }
                         }
                     }
                 }
@@ -660,6 +807,8 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
 
             // > K_PR < //
 
+            if (!build_K) continue;
+
             for (int P2 = 0; P2 < nPtask; P2++) {
                 for (int R2 = 0; R2 < nRtask; R2++) {
                     int P = task_shells[P2start + P2];
@@ -764,14 +913,19 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
     }  // End master task list
 
     for (size_t ind = 0; ind < D.size(); ind++) {
-        J[ind]->scale(2.0);
-        J[ind]->hermitivitize();
-        if (lr_symmetric_) {
+        if (build_J) {
+            J[ind]->scale(2.0);
+            J[ind]->hermitivitize();
+        }
+        if (build_K && lr_symmetric_) {
             K[ind]->scale(2.0);
             K[ind]->hermitivitize();
         }
     }
 
+    computed_quartets_ += computed_shells;
+    density_screened_quartets_ += screened_shells;
+
     if (bench_) {
         auto mode = std::ostream::app;
         auto printer = std::make_shared<PsiOutStream>("bench.dat", mode);
@@ -782,4 +936,229 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::v
     }
 }
 
+void DirectJK::build_linK(std::vector<std::shared_ptr<TwoBodyAOInt>>& ints, std::vector<std::shared_ptr<Matrix>>& D,
+                          std::vector<std::shared_ptr<Matrix>>& K) {
+    // => Zeroing <= //
+    for (size_t ind = 0; ind < K.size(); ind++) {
+        K[ind]->zero();
+    }
+
+    // => Sizing <= //
+
+    int nshell = primary_->nshell();
+    int nthread = df_ints_num_threads_;
+    double cutoff = (linK_ints_cutoff_set_ ? linK_ints_cutoff_ : cutoff_);
+
+    // => Schwarz Bounds <= //
+
+    // sqrt(max |(PQ|PQ)|) for each significant shell pair, and the largest over Q for each P
+    std::vector<double> schwarz((size_t)nshell * nshell, 0.0);
+    std::vector<double> schwarz_max(nshell, 0.0);
+    for (int P = 0; P < nshell; P++) {
+        for (int Q = 0; Q < nshell; Q++) {
+            if (!ints[0]->shell_pair_significant(P, Q)) continue;
+            double val = std::sqrt(std::sqrt(ints[0]->shell_ceiling2(P, Q, P, Q)));
+            schwarz[P * (size_t)nshell + Q] = val;
+            schwarz_max[P] = std::max(schwarz_max[P], val);
+        }
+    }
+
+    // => Density Bounds <= //
+
+    // Largest density element in each shell block over all densities, symmetrized,
+    // and the largest in each row of shell blocks
+    std::vector<double> shell_max_density((size_t)nshell * nshell, 0.0);
+    for (size_t ind = 0; ind < D.size(); ind++) {
+        double** Dp = D[ind]->pointer();
+#pragma omp parallel for num_threads(nthread) schedule(dynamic)
+        for (int P = 0; P < nshell; P++) {
+            int Poff = primary_->shell(P).function_index();
+            int Psize = primary_->shell(P).nfunction();
+            for (int Q = 0; Q < nshell; Q++) {
+                int Qoff = primary_->shell(Q).function_index();
+                int Qsize = primary_->shell(Q).nfunction();
+                double& max_val = shell_max_density[P * (size_t)nshell + Q];
+                for (int p = Poff; p < Poff + Psize; p++) {
+                    for (int q = Qoff; q < Qoff + Qsize; q++) {
+                        max_val = std::max(max_val, std::fabs(Dp[p][q]));
+                    }
+                }
+            }
+        }
+    }
+    for (int P = 0; P < nshell; P++) {
+        for (int Q = 0; Q < P; Q++) {
+            double val = std::max(shell_max_density[P * (size_t)nshell + Q], shell_max_density[Q * (size_t)nshell + P]);
+            shell_max_density[P * (size_t)nshell + Q] = shell_max_density[Q * (size_t)nshell + P] = val;
+        }
+    }
+    std::vector<double> row_max_density(nshell, 0.0);
+    for (int P = 0; P < nshell; P++) {
+        for (int Q = 0; Q < nshell; Q++) {
+            row_max_density[P] = std::max(row_max_density[P], shell_max_density[P * (size_t)nshell + Q]);
+        }
+    }
+    double max_density = *std::max_element(row_max_density.begin(), row_max_density.end());
+
+    // => Significant Bra Pairs <= //
+
+    // For each P, the shells Q forming a significant pair, in order of decreasing Schwarz bound
+    std::vector<std::vector<int>> bras(nshell);
+    for (int P = 0; P < nshell; P++) {
+        for (int Q = 0; Q < nshell; Q++) {
+            if (schwarz[P * (size_t)nshell + Q] > 0.0) bras[P].push_back(Q);
+        }
+        const double* schwarzP = &schwarz[P * (size_t)nshell];
+        std::sort(bras[P].begin(), bras[P].end(), [schwarzP](int Q1, int Q2) { return schwarzP[Q1] > schwarzP[Q2]; });
+    }
+
+    // => Significant Ket Shells <= //
+
+    // bra_density[P][S] = max_Q (PQ|PQ)^1/2 |D_QS|, and the largest quartet bound that
+    // reaches K_PR is then max_S bra_density[P][S] (RS|RS)^1/2. For each P, the shells R
+    // with a bound over the cutoff, in order of decreasing bound.
+    std::vector<double> bra_density((size_t)nshell * nshell, 0.0);
+#pragma omp parallel for num_threads(nthread) schedule(dynamic)
+    for (int P = 0; P < nshell; P++) {
+        double* bdP = &bra_density[P * (size_t)nshell];
+        for (int Q : bras[P]) {
+            double QPQ = schwarz[P * (size_t)nshell + Q];
+            const double* dQ = &shell_max_density[Q * (size_t)nshell];
+            for (int S = 0; S < nshell; S++) {
+                bdP[S] = std::max(bdP[S], QPQ * dQ[S]);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> kets(nshell);
+#pragma omp parallel for num_threads(nthread) schedule(dynamic)
+    for (int P = 0; P < nshell; P++) {
+        const double* bdP = &bra_density[P * (size_t)nshell];
+        std::vector<std::pair<double, int>> bounds;
+        for (int R = 0; R < (lr_symmetric_ ? P + 1 : nshell); R++) {
+            double bound = 0.0;
+            for (int S : bras[R]) {
+                bound = std::max(bound, bdP[S] * schwarz[R * (size_t)nshell + S]);
+            }
+            if (bound >= cutoff) bounds.push_back(std::make_pair(bound, R));
+        }
+        std::sort(bounds.begin(), bounds.end(),
+                  [](const std::pair<double, int>& a, const std::pair<double, int>& b) { return a.first > b.first; });
+        for (const auto& bound : bounds) {
+            kets[P].push_back(bound.second);
+        }
+    }
+
+    // => Intermediate Buffers <= //
+
+    int max_nfunction = primary_->max_function_per_shell();
+    std::vector<std::vector<double>> KT(nthread, std::vector<double>(D.size() * max_nfunction * max_nfunction));
+
+    // => Benchmarks <= //
+
+    size_t computed_shells = 0L;
+
+    // ==> Master Shell Loop <== //
+
+    // Each K_PR block is owned by the task for P, so no atomics are needed
+#pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+ : computed_shells)
+    for (int P = 0; P < nshell; P++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int Psize = primary_->shell(P).nfunction();
+        int Poff = primary_->shell(P).function_index();
+        double* KTp = KT[thread].data();
+
+        for (int R : kets[P]) {
+            int Rsize = primary_->shell(R).nfunction();
+            int Roff = primary_->shell(R).function_index();
+            size_t block = (size_t)Psize * Rsize;
+            ::memset((void*)KTp, '\0', D.size() * block * sizeof(double));
+
+            bool touched = false;
+            for (int Q : bras[P]) {
+                double QPQ = schwarz[P * (size_t)nshell + Q];
+                // Bras are sorted, so no later Q can pass if this one fails with the largest density
+                if (QPQ * schwarz_max[R] * max_density < cutoff) break;
+                if (QPQ * schwarz_max[R] * row_max_density[Q] < cutoff) continue;
+                int Qsize = primary_->shell(Q).nfunction();
+                int Qoff = primary_->shell(Q).function_index();
+
+                for (int S : bras[R]) {
+                    double bound = QPQ * schwarz[R * (size_t)nshell + S];
+                    // Early termination: kets are sorted by decreasing Schwarz bound
+                    if (bound * row_max_density[Q] < cutoff) break;
+                    if (bound * shell_max_density[Q * (size_t)nshell + S] < cutoff) continue;
+
+                    if (ints[thread]->compute_shell(P, Q, R, S) == 0) continue;
+                    computed_shells++;
+
+                    int Ssize = primary_->shell(S).nfunction();
+                    int Soff = primary_->shell(S).function_index();
+
+                    for (size_t ind = 0; ind < D.size(); ind++) {
+                        double** Dp = D[ind]->pointer();
+                        double* K1p = KTp + ind * block;
+                        const double* buffer2 = ints[thread]->buffer();
+                        for (int p = 0; p < Psize; p++) {
+                            for (int q = 0; q < Qsize; q++) {
+                                for (int r = 0; r < Rsize; r++) {
+                                    double val = 0.0;
+                                    for (int s = 0; s < Ssize; s++) {
+                                        val += Dp[q + Qoff][s + Soff] * (*buffer2);
+                                        buffer2++;
+                                    }
+                                    K1p[p * Rsize + r] += val;
+                                }
+                            }
+                        }
+                    }
+                    touched = true;
+                }
+            }
+
+            if (!touched) continue;
+
+            // => Stripe out <= //
+
+            for (size_t ind = 0; ind < D.size(); ind++) {
+                double** Kp = K[ind]->pointer();
+                double* K1p = KTp + ind * block;
+                for (int p = 0; p < Psize; p++) {
+                    for (int r = 0; r < Rsize; r++) {
+                        Kp[p + Poff][r + Roff] = K1p[p * Rsize + r];
+                    }
+                }
+            }
+        }
+    }  // End master shell loop
+
+    // Only the R <= P blocks were built for symmetric densities
+    if (lr_symmetric_) {
+        for (size_t ind = 0; ind < K.size(); ind++) {
+            double** Kp = K[ind]->pointer();
+            for (int p = 0; p < primary_->nbf(); p++) {
+                int P = primary_->function_to_shell(p);
+                for (int r = primary_->shell(P).function_index() + primary_->shell(P).nfunction(); r < primary_->nbf();
+                     r++) {
+                    Kp[p][r] = Kp[r][p];
+                }
+            }
+        }
+    }
+
+    linK_quartets_ += computed_shells;
+
+    if (bench_) {
+        auto mode = std::ostream::app;
+        auto printer = std::make_shared<PsiOutStream>("bench.dat", mode);
+        size_t possible_shells = (size_t)nshell * nshell * nshell * nshell;
+        if (lr_symmetric_) possible_shells = (size_t)nshell * (nshell + 1L) / 2L * nshell * nshell;
+        printer->Printf("LinK Computed %20zu Shell Quartets out of %20zu, (%11.3E ratio)\n", computed_shells,
+                        possible_shells, computed_shells / (double)possible_shells);
+    }
+}
+
 }  // namespace psi
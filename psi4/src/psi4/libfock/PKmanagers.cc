@@ -31,6 +31,7 @@
 
 #include "psi4/psi4-dec.h"
 #include "psi4/psifiles.h"
+#include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libiwl/iwl.hpp"
 #include "psi4/liboptions/liboptions.h"
@@ -655,9 +656,99 @@ void PKMgrDisk::finalize_PK() {
     }
 }
 
+bool PKMgrDisk::form_J_streamed(size_t nmat, const std::string& exch) {
+    // Two chunks must fit in the memory of one batch, and a chunk holds at least one row
+    size_t limit = memory() / 2;
+    if (pk_pairs() > limit) return false;
+
+    // Cut every batch into chunks of whole rows
+    struct Chunk {
+        int batch;
+        size_t pq_min, pq_max, offset, size;
+    };
+    std::vector<Chunk> chunks;
+    size_t max_chunk = 0;
+    for (int batch = 0; batch < batch_pq_min_.size(); ++batch) {
+        size_t batch_start = INDEX2(batch_pq_min_[batch], 0);
+        Chunk chunk{batch, batch_pq_min_[batch], batch_pq_min_[batch], 0, 0};
+        for (size_t pq = batch_pq_min_[batch]; pq < batch_pq_max_[batch]; ++pq) {
+            if (chunk.size + pq + 1 > limit) {
+                chunks.push_back(chunk);
+                max_chunk = std::max(max_chunk, chunk.size);
+                chunk = Chunk{batch, pq, pq, INDEX2(pq, 0) - batch_start, 0};
+            }
+            chunk.pq_max = pq + 1;
+            chunk.size += pq + 1;
+        }
+        if (chunk.size) {
+            chunks.push_back(chunk);
+            max_chunk = std::max(max_chunk, chunk.size);
+        }
+    }
+
+    std::vector<char*> labels(batch_pq_min_.size());
+    for (int batch = 0; batch < labels.size(); ++batch) {
+        if (exch == "K") {
+            labels[batch] = PKWorker::get_label_K(batch);
+        } else {
+            labels[batch] = PKWorker::get_label_J(batch);
+        }
+    }
+
+    // Chunk c is read into buffer c % 2 while chunk c - 1 is contracted
+    std::unique_ptr<double[]> buffers[2] = {std::unique_ptr<double[]>(new double[max_chunk]),
+                                            std::unique_ptr<double[]>(new double[max_chunk])};
+    size_t jobs[2] = {0, 0};
+    psio_address ends[2];
+    auto read_ahead = [&](size_t c) {
+        const Chunk& chunk = chunks[c];
+        psio_address start = psio_get_address(PSIO_ZERO, chunk.offset * sizeof(double));
+        jobs[c % 2] = AIO_->read(pk_file_, labels[chunk.batch], (char*)buffers[c % 2].get(),
+                                 chunk.size * sizeof(double), start, &ends[c % 2]);
+    };
+
+    if (!chunks.empty()) read_ahead(0);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        timer_on("PK: wait for read");
+        AIO_->wait_for_job(jobs[c % 2]);
+        timer_off("PK: wait for read");
+        if (c + 1 < chunks.size()) read_ahead(c + 1);
+
+        const Chunk& chunk = chunks[c];
+        for (size_t N = 0; N < nmat; ++N) {
+            double* D_vec = D_glob_vecs(N);
+            double* J_vec = JK_glob_vecs(N);
+            double* j_ptr = buffers[c % 2].get();
+            for (size_t pq = chunk.pq_min; pq < chunk.pq_max; ++pq) {
+                double D_pq = D_vec[pq];
+                double* D_rs = D_vec;
+                double J_pq = 0.0;
+                double* J_rs = J_vec;
+                for (size_t rs = 0; rs <= pq; ++rs) {
+                    J_pq += *j_ptr * (*D_rs);
+                    *J_rs += *j_ptr * D_pq;
+                    ++D_rs;
+                    ++J_rs;
+                    ++j_ptr;
+                }
+                J_vec[pq] += J_pq;
+            }
+        }
+    }
+
+    for (char* label : labels) delete[] label;
+    return true;
+}
+
 void PKMgrDisk::form_J(std::vector<SharedMatrix> J, std::string exch, std::vector<SharedMatrix> K) {
     make_J_vec(J);
 
+    // Symmetric densities only need the integrals once, row by row: stream them
+    if (all_sym() && exch != "wK" && form_J_streamed(J.size(), exch)) {
+        get_results(J, exch);
+        return;
+    }
+
     // Now loop over batches
     for (int batch = 0; batch < batch_pq_min_.size(); ++batch) {
         size_t min_index = batch_index_min_[batch];
@@ -1437,6 +1528,117 @@ void PKMgrYoshimine::generate_wK_PK(double* twoel_ints, size_t max_size) {
     inbuf.set_keep_flag(false);
 }
 
+const size_t PKBlockStore::block_size;
+
+PKBlockStore::PKBlockStore(const double* dense, size_t npairs, double single_threshold) {
+    // First pass: size the storage so the value arrays are allocated once
+    size_t nblocks = 0, nd = 0, nf = 0;
+    const double* row = dense;
+    for (size_t pq = 0; pq < npairs; ++pq) {
+        size_t rowlen = pq + 1;
+        for (size_t rs0 = 0; rs0 < rowlen; rs0 += block_size) {
+            size_t len = std::min(block_size, rowlen - rs0);
+            double absmax = 0.0;
+            for (size_t k = 0; k < len; ++k) absmax = std::max(absmax, std::fabs(row[rs0 + k]));
+            if (absmax == 0.0) continue;
+            ++nblocks;
+            if (absmax < single_threshold)
+                nf += len;
+            else
+                nd += len;
+        }
+        row += rowlen;
+    }
+    row_start_.reserve(npairs + 1);
+    blocks_.reserve(nblocks);
+    dvals_.reserve(nd);
+    fvals_.reserve(nf);
+
+    // Second pass: copy the significant blocks
+    row = dense;
+    for (size_t pq = 0; pq < npairs; ++pq) {
+        size_t rowlen = pq + 1;
+        row_start_.push_back(blocks_.size());
+        for (size_t rs0 = 0; rs0 < rowlen; rs0 += block_size) {
+            size_t len = std::min(block_size, rowlen - rs0);
+            double absmax = 0.0;
+            for (size_t k = 0; k < len; ++k) absmax = std::max(absmax, std::fabs(row[rs0 + k]));
+            if (absmax == 0.0) continue;
+            Block block;
+            block.rs0 = rs0;
+            block.len = len;
+            block.single = absmax < single_threshold;
+            if (block.single) {
+                block.offset = fvals_.size();
+                for (size_t k = 0; k < len; ++k) fvals_.push_back(static_cast<float>(row[rs0 + k]));
+            } else {
+                block.offset = dvals_.size();
+                dvals_.insert(dvals_.end(), row + rs0, row + rs0 + len);
+            }
+            blocks_.push_back(block);
+        }
+        row += rowlen;
+    }
+    row_start_.push_back(blocks_.size());
+}
+
+void PKBlockStore::expand_row(size_t pq, double* row) const {
+    ::memset((void*)row, '\0', (pq + 1) * sizeof(double));
+    for (size_t b = row_start_[pq]; b < row_start_[pq + 1]; ++b) {
+        const Block& block = blocks_[b];
+        double* dest = row + block.rs0;
+        if (block.single) {
+            const float* src = fvals_.data() + block.offset;
+            for (size_t k = 0; k < block.len; ++k) dest[k] = src[k];
+        } else {
+            ::memcpy((void*)dest, (void*)(dvals_.data() + block.offset), block.len * sizeof(double));
+        }
+    }
+}
+
+double PKBlockStore::contract_row(size_t pq, const double* D, double D_pq, double* J) const {
+    double J_pq = 0.0;
+    for (size_t b = row_start_[pq]; b < row_start_[pq + 1]; ++b) {
+        const Block& block = blocks_[b];
+        const double* D_rs = D + block.rs0;
+        double* J_rs = J + block.rs0;
+        if (block.single) {
+            const float* v = fvals_.data() + block.offset;
+            for (size_t k = 0; k < block.len; ++k) {
+                J_pq += v[k] * D_rs[k];
+                J_rs[k] += v[k] * D_pq;
+            }
+        } else {
+            const double* v = dvals_.data() + block.offset;
+            for (size_t k = 0; k < block.len; ++k) {
+                J_pq += v[k] * D_rs[k];
+                J_rs[k] += v[k] * D_pq;
+            }
+        }
+    }
+    return J_pq;
+}
+
+size_t PKBlockStore::bytes() const {
+    return row_start_.size() * sizeof(size_t) + blocks_.size() * sizeof(Block) + dvals_.size() * sizeof(double) +
+           fvals_.size() * sizeof(float);
+}
+
+PKMgrInCore::PKMgrInCore(std::shared_ptr<BasisSet> primary, size_t memory, Options& options)
+    : wK_ints_(nullptr), PKManager(primary, memory, options) {
+    sparse_ = options.get_bool("PK_INCORE_SPARSE");
+    single_threshold_ = sparse_ ? options.get_double("PK_SINGLE_THRESHOLD") : 0.0;
+}
+
+void PKMgrInCore::compress(std::unique_ptr<double[]>& ints, std::unique_ptr<PKBlockStore>& store,
+                           const std::string& name) {
+    store = std::unique_ptr<PKBlockStore>(new PKBlockStore(ints.get(), pk_pairs(), single_threshold_));
+    ints.reset();
+    outfile->Printf("  %-3s supermatrix compressed to %8.2f MiB (%5.1f%% of dense): %lu double, %lu single.\n",
+                    name.c_str(), store->bytes() / 1048576.0, 100.0 * store->bytes() / (pk_size() * sizeof(double)),
+                    store->ndouble(), store->nsingle());
+}
+
 void PKMgrInCore::initialize() {
     print_batches();
     allocate_buffers();
@@ -1452,6 +1654,12 @@ void PKMgrInCore::print_batches() {
     outfile->Printf("  Performing in-core PK\n");
     int nbufincore = do_wk() ? 3 : 2;
     outfile->Printf("  Using %lu doubles for integral storage.\n", nbufincore * pk_size());
+    if (sparse_) {
+        outfile->Printf("  Supermatrices will be stored in sparse blocks of %lu integrals", PKBlockStore::block_size);
+        if (single_threshold_ > 0.0)
+            outfile->Printf(",\n  in single precision for blocks below %8.2e", single_threshold_);
+        outfile->Printf(".\n");
+    }
 }
 
 void PKMgrInCore::allocate_buffers() {
@@ -1487,12 +1695,21 @@ void PKMgrInCore::form_PK() {
     compute_integrals();
     if (!do_wk()) {
         finalize_PK();
+        if (sparse_) {
+            compress(J_ints_, J_store_, "J");
+            compress(K_ints_, K_store_, "K");
+        }
     }
 }
 
 void PKMgrInCore::form_PK_wK() {
     compute_integrals_wK();
     finalize_PK();
+    if (sparse_) {
+        compress(J_ints_, J_store_, "J");
+        compress(K_ints_, K_store_, "K");
+        compress(wK_ints_, wK_store_, "wK");
+    }
 }
 
 void PKMgrInCore::write() { get_buffer()->finalize_ints(pk_pairs()); }
@@ -1512,34 +1729,48 @@ void PKMgrInCore::prepare_JK(std::vector<SharedMatrix> D, std::vector<SharedMatr
 void PKMgrInCore::form_J(std::vector<SharedMatrix> J, std::string exch, std::vector<SharedMatrix> K) {
     make_J_vec(J);
 
+    // Scratch for one expanded row of a compressed supermatrix
+    std::vector<double> row(sparse_ ? pk_pairs() : 0);
+
     for (int N = 0; N < J.size(); ++N) {
         double* j_ptr;
+        const PKBlockStore* store;
         if (exch == "K") {
             j_ptr = K_ints_.get();
+            store = K_store_.get();
         } else {
             j_ptr = J_ints_.get();
+            store = J_store_.get();
         }
         // TODO We should totally parallelize this loop now.
         // Symmetric density matrix case
         if (is_sym(N) && exch != "wK") {
             double* J_vec = JK_glob_vecs(N);
             double* D_vec = D_glob_vecs(N);
-            for (size_t pq = 0; pq < pk_pairs(); ++pq) {
-                double D_pq = D_vec[pq];
-                double* D_rs = D_vec;
-                double J_pq = 0.0;
-                double* J_rs = J_vec;
-                for (size_t rs = 0; rs <= pq; ++rs) {
-                    // DEBUG               if(!exch && rs == 0) {
-                    // DEBUG                 outfile->Printf("PK int (%lu|%lu) = %20.16f\n",pq,rs,*j_ptr);
-                    // DEBUG               }
-                    J_pq += *j_ptr * (*D_rs);
-                    *J_rs += *j_ptr * D_pq;
-                    ++D_rs;
-                    ++J_rs;
-                    ++j_ptr;
+            if (store) {
+                // Compressed supermatrix: only the stored blocks of each row contribute
+                for (size_t pq = 0; pq < pk_pairs(); ++pq) {
+                    double J_pq = store->contract_row(pq, D_vec, D_vec[pq], J_vec);
+                    J_vec[pq] += J_pq;
+                }
+            } else {
+                for (size_t pq = 0; pq < pk_pairs(); ++pq) {
+                    double D_pq = D_vec[pq];
+                    double* D_rs = D_vec;
+                    double J_pq = 0.0;
+                    double* J_rs = J_vec;
+                    for (size_t rs = 0; rs <= pq; ++rs) {
+                        // DEBUG               if(!exch && rs == 0) {
+                        // DEBUG                 outfile->Printf("PK int (%lu|%lu) = %20.16f\n",pq,rs,*j_ptr);
+                        // DEBUG               }
+                        J_pq += *j_ptr * (*D_rs);
+                        *J_rs += *j_ptr * D_pq;
+                        ++D_rs;
+                        ++J_rs;
+                        ++j_ptr;
+                    }
+                    J_vec[pq] += J_pq;
                 }
-                J_vec[pq] += J_pq;
             }
 
             // TODO ? Fuse J and K loops ?
@@ -1552,6 +1783,10 @@ void PKMgrInCore::form_J(std::vector<SharedMatrix> J, std::string exch, std::vec
                     int poffs = p * nbf();
                     for (int q = 0; q <= p; ++q) {
                         int qoffs = q * nbf();
+                        if (store) {
+                            store->expand_row(INDEX2(p, q), row.data());
+                            j_ptr = row.data();
+                        }
                         for (int r = 0; r <= p; ++r) {
                             int roffs = r * nbf();
                             int maxs = (r == p) ? q : r;
@@ -1576,16 +1811,22 @@ void PKMgrInCore::form_J(std::vector<SharedMatrix> J, std::string exch, std::vec
                 if (exch == "wK") {
                     K_vec = J[N]->pointer();
                     j_ptr = wK_ints_.get();
+                    store = wK_store_.get();
                 } else {
                     K_vec = K[N]->pointer();
                     // We use J supermatrix because it contains every unique integral
                     // K supermatrix has summed some integrals that we need separately
                     j_ptr = J_ints_.get();
+                    store = J_store_.get();
                 }
                 for (int p = 0; p < nbf(); ++p) {
                     //        int poffs = p * nbf();
                     for (int q = 0; q <= p; ++q) {
                         //          int qoffs = q * nbf();
+                        if (store) {
+                            store->expand_row(INDEX2(p, q), row.data());
+                            j_ptr = row.data();
+                        }
                         for (int r = 0; r <= p; ++r) {
                             //            int roffs = r * nbf();
                             int maxs = (r == p) ? q : r;
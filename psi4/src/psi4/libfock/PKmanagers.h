@@ -324,6 +324,9 @@ class PKMgrDisk : public PKManager {
     /// Form J from PK supermatrix, shared_ptr() initialized to null
     void form_J(std::vector<SharedMatrix> J, std::string exch = "",
                 std::vector<SharedMatrix> K = std::vector<SharedMatrix>()) override;
+    /// Form J (or K) for symmetric densities, streaming the PK file in chunks of
+    /// rows with read-ahead. Returns false if two chunks cannot fit in memory.
+    bool form_J_streamed(size_t nmat, const std::string& exch);
 
     /// Finalize JK matrix formation
     void finalize_JK() override;
@@ -455,6 +458,50 @@ class PKMgrYoshimine : public PKMgrDisk {
     void generate_wK_PK(double* twoel_ints, size_t max_size);
 };
 
+/* PKBlockStore: compressed storage for one in-core PK supermatrix */
+
+/** Each triangular row pq of the supermatrix is cut into blocks of
+ * block_size integrals. Blocks that are entirely zero, i.e. made only of
+ * shell quartets dropped by the Schwarz sieve, are not stored at all.
+ * Blocks whose largest integral is below a magnitude threshold are kept
+ * in single precision, the others in double precision.
+ */
+
+class PKBlockStore {
+   private:
+    struct Block {
+        /// First rs index of the block within its row
+        size_t rs0;
+        /// Number of integrals in the block
+        size_t len;
+        /// Offset of the block in fvals_ (single) or dvals_ (double)
+        size_t offset;
+        bool single;
+    };
+    /// Index of the first block of each row, npairs + 1 entries
+    std::vector<size_t> row_start_;
+    std::vector<Block> blocks_;
+    std::vector<double> dvals_;
+    std::vector<float> fvals_;
+
+   public:
+    static const size_t block_size = 128;
+
+    /// Compress the dense triangular supermatrix of npairs rows
+    PKBlockStore(const double* dense, size_t npairs, double single_threshold);
+
+    /// Write row pq (pq + 1 integrals) into row, zeros included
+    void expand_row(size_t pq, double* row) const;
+    /// J_pq += sum_rs (pq|rs) D_rs and J_rs += (pq|rs) D_pq over the stored blocks of row pq
+    double contract_row(size_t pq, const double* D, double D_pq, double* J) const;
+
+    /// Memory used in bytes
+    size_t bytes() const;
+    /// Number of integrals kept in double and single precision
+    size_t ndouble() const { return dvals_.size(); }
+    size_t nsingle() const { return fvals_.size(); }
+};
+
 /* PKMgrInCore: Class to manage in-core PK algorithm */
 
 /** The simplest algorithm: a large buffer is allocated in core
@@ -473,10 +520,21 @@ class PKMgrInCore : public PKManager {
     std::unique_ptr<double[]> K_ints_;
     std::unique_ptr<double[]> wK_ints_;
 
+    /// Compressed supermatrices, replacing the arrays above when sparse_ is set
+    std::unique_ptr<PKBlockStore> J_store_;
+    std::unique_ptr<PKBlockStore> K_store_;
+    std::unique_ptr<PKBlockStore> wK_store_;
+    /// Compress the supermatrices once they are formed?
+    bool sparse_;
+    /// Blocks with all integrals below this magnitude are stored in single precision
+    double single_threshold_;
+
+    /// Replace a dense supermatrix by its compressed form
+    void compress(std::unique_ptr<double[]>& ints, std::unique_ptr<PKBlockStore>& store, const std::string& name);
+
    public:
     /// Constructor for in-core class
-    PKMgrInCore(std::shared_ptr<BasisSet> primary, size_t memory, Options& options)
-        : wK_ints_(nullptr), PKManager(primary, memory, options) {}
+    PKMgrInCore(std::shared_ptr<BasisSet> primary, size_t memory, Options& options);
     /// Destructor for in-core class
     ~PKMgrInCore() override {}
 
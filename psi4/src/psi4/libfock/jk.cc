@@ -138,6 +138,21 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        jk->set_incfock(options.get_bool("INCFOCK"));
+        jk->set_incfock_full_fock_every(options.get_int("INCFOCK_FULL_FOCK_EVERY"));
+        jk->set_linK(options.get_bool("LINK"));
+        if (options["LINK_INTS_TOLERANCE"].has_changed())
+            jk->set_linK_ints_cutoff(options.get_double("LINK_INTS_TOLERANCE"));
+
+        return std::shared_ptr<JK>(jk);
+
+    } else if (jk_type == "COSX") {
+        COSK* jk = new COSK(primary, auxiliary, options);
+
+        if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
 
         return std::shared_ptr<JK>(jk);
 
@@ -203,6 +218,7 @@ void JK::common_init() {
     do_wK_ = false;
     wcombine_ = false;
     lr_symmetric_ = false;
+    do_incfock_iter_ = false;
     omega_ = 0.0;
     omega_alpha_ = 1.0;
     omega_beta_ = 0.0;
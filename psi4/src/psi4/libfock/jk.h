@@ -47,6 +47,9 @@ class TwoBodyAOInt;
 class Options;
 class PSIO;
 class DFHelper;
+class DFTGrid;
+class BasisFunctions;
+class PotentialInt;
 
 namespace pk {
 class PKManager;
@@ -269,6 +272,9 @@ class PSI_API JK {
     /// Left-right symmetric? Determined in each call of compute()
     bool lr_symmetric_;
 
+    /// Is the next call to compute() an SCF iteration that may be built incrementally? Reset after each compute()
+    bool do_incfock_iter_;
+
     // => Architecture-Level State Variables (Spatial Symmetry) <= //
 
     /// Pseudo-occupied C matrices, left side
@@ -441,6 +447,14 @@ class PSI_API JK {
     virtual void set_do_wK(bool do_wK) { do_wK_ = do_wK; }
     bool get_do_wK() {return do_wK_;}
     /**
+    * Mark the next compute() as an SCF iteration, which algorithms supporting
+    * incremental Fock builds may build from the previous iteration's matrices
+    * @param do_incfock_iter is the next compute() an SCF iteration?
+    *        reset to false after each compute()
+    */
+    void set_do_incfock_iter(bool do_incfock_iter) { do_incfock_iter_ = do_incfock_iter; }
+    bool get_do_incfock_iter() { return do_incfock_iter_; }
+    /**
     * Set to combine wK integral tensors
     * @param wcombine do we combine wK matrices?
     *        defaults to false unless MemDFJK
@@ -706,6 +720,36 @@ class PSI_API DirectJK : public JK {
     /// ERI Sieve
     std::shared_ptr<ERISieve> sieve_;
 
+    // => Incremental Fock build <= //
+
+    /// Build J/K from the density change between SCF iterations? (default false)
+    bool incfock_;
+    /// Perform a full build every this many SCF iterations (default 10)
+    int incfock_full_fock_every_;
+    /// Number of SCF iterations seen in incremental mode (includes full rebuilds)
+    int incfock_count_;
+    /// Densities and J/K/wK matrices from the previous SCF iteration
+    std::vector<SharedMatrix> D_prev_;
+    std::vector<SharedMatrix> J_prev_;
+    std::vector<SharedMatrix> K_prev_;
+    std::vector<SharedMatrix> wK_prev_;
+    /// Number of incremental builds performed
+    size_t incfock_incremental_builds_;
+    /// Shell quartets computed and skipped by density screening, over all builds
+    size_t computed_quartets_;
+    size_t density_screened_quartets_;
+
+    // => LinK exchange <= //
+
+    /// Build K with the LinK algorithm instead of alongside J? (default false)
+    bool linK_;
+    /// Density-weighted screening threshold for LinK shell quartets (default cutoff_)
+    double linK_ints_cutoff_;
+    /// Whether linK_ints_cutoff_ was set explicitly
+    bool linK_ints_cutoff_set_;
+    /// Shell quartets computed by LinK, over all builds
+    size_t linK_quartets_;
+
     std::string name() override { return "DirectJK"; }
     size_t memory_estimate() override;
 
@@ -720,9 +764,13 @@ class PSI_API DirectJK : public JK {
     /// Delete integrals, files, etc
     void postiterations() override;
 
-    /// Build the J and K matrices for this integral class
+    /// Build the J and K matrices for this integral class (either of J and K may be empty)
     void build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::vector<std::shared_ptr<Matrix> >& D,
                   std::vector<std::shared_ptr<Matrix> >& J, std::vector<std::shared_ptr<Matrix> >& K);
+    /// Build the K matrices with LinK: per-shell sorted significant pair lists and
+    /// density-weighted early termination over the ket
+    void build_linK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::vector<std::shared_ptr<Matrix> >& D,
+                    std::vector<std::shared_ptr<Matrix> >& K);
 
     /// Common initialization
     void common_init();
@@ -748,6 +796,31 @@ class PSI_API DirectJK : public JK {
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * Build J/K from the density change between SCF iterations, with
+     * density-weighted shell quartet screening
+     * @param val do incremental Fock builds?
+     */
+    void set_incfock(bool val) { incfock_ = val; }
+    /**
+     * How often to perform a full build in incremental Fock mode
+     * @param val a positive integer, number of SCF iterations
+     */
+    void set_incfock_full_fock_every(int val) { incfock_full_fock_every_ = (val > 0 ? val : 1); }
+    /**
+     * Build K with the LinK algorithm, J is then built from its own
+     * quartet list
+     * @param val use LinK for K?
+     */
+    void set_linK(bool val) { linK_ = val; }
+    /**
+     * Screening threshold on density-weighted quartet bounds in LinK
+     * @param val a small positive number, defaults to the Schwarz cutoff
+     */
+    void set_linK_ints_cutoff(double val) {
+        linK_ints_cutoff_ = val;
+        linK_ints_cutoff_set_ = true;
+    }
 
     // => Accessors <= //
 
@@ -1114,7 +1187,83 @@ class PSI_API MemDFJK : public JK {
     std::shared_ptr<DFHelper> dfh() { return dfh_; }
 };
 
+/**
+ * Class COSK
+ *
+ * JK implementation using seminumerical (chain-of-spheres)
+ * exchange: one electron is integrated on a DFT-style grid,
+ * the other analytically in the field of a unit charge at
+ * each grid point. The quadrature is fitted to reproduce the
+ * analytic overlap. J is built by MemDFJK if an auxiliary
+ * basis is given, by DirectJK otherwise.
+ */
+class PSI_API COSK : public JK {
+   protected:
+    std::string name() override { return "COSK"; }
+    size_t memory_estimate() override;
+
+    /// Options object, for the grid and the J builder
+    Options& options_;
+    /// Auxiliary basis set for J, may be empty
+    std::shared_ptr<BasisSet> auxiliary_;
+    /// Builds J
+    std::shared_ptr<JK> jk_;
+
+    /// Integration grid for K
+    std::shared_ptr<DFTGrid> grid_;
+    /// Per-thread collocation, potential integrals and the charge they see
+    std::vector<std::shared_ptr<BasisFunctions>> point_workers_;
+    std::vector<std::shared_ptr<PotentialInt>> int_workers_;
+    std::vector<SharedMatrix> charges_;
+    /// For each shell, the shells it has a significant overlap with
+    std::vector<std::vector<int>> shell_pairs_;
+    /// Overlap fitting metric S_num^-1 S_an
+    SharedMatrix Q_;
+
+    /// Screening threshold on density and shell pair bounds
+    double kscreen_;
+    /// Fit the quadrature to the analytic overlap?
+    bool overlap_fitted_;
+
+    // => Required Algorithm-Specific Methods <= //
+
+    /// Do we need to backtransform to C1 under the hood?
+    bool C1() const override { return true; }
+    /// Build the grid, the overlap fitting and the J builder
+    void preiterations() override;
+    /// Compute J/K for current C/D
+    void compute_JK() override;
+    /// Delete integrals, files, etc
+    void postiterations() override;
+
+    /// Seminumerical K_ao_ for the current D_ao_
+    void build_K();
+
+   public:
+    // => Constructors < = //
+
+    /**
+     * @param primary primary basis set for this system.
+     * @param auxiliary auxiliary basis set for J, or an empty basis for direct J
+     * @param options Options reference, for the COSX_ grid and screening options
+     */
+    COSK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options);
+
+    /// Destructor
+    ~COSK() override;
+
+    /// wK is not available, throws if requested
+    void set_do_wK(bool do_wK) override;
+
+    // => Accessors <= //
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    void print_header() const override;
+};
+
 }
 
 #endif
-
@@ -38,14 +38,17 @@
 
 #include "gau2grid/gau2grid.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
 SAPFunctions::SAPFunctions(std::shared_ptr<BasisSet> primary, int max_points, int max_functions)
-    : PointFunctions(primary, max_points, max_functions) {
-    current_basis_map_ = &basis_values_;
-}
+    : PointFunctions(primary, max_points, max_functions) {}
 SAPFunctions::~SAPFunctions() {}
 std::vector<SharedMatrix> SAPFunctions::scratch() {
     std::vector<SharedMatrix> vec;
@@ -61,10 +64,7 @@ void SAPFunctions::allocate() {
 void SAPFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
     block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
+    if (force_compute || !collocation_cache_ || !collocation_cache_->unpack(block->index(), basis_values_)) {
         BasisFunctions::compute_functions(block);
     }
 }
@@ -104,7 +104,6 @@ void SAPFunctions::set_pointers(SharedMatrix /*Ca_AO*/) {
 RKSFunctions::RKSFunctions(std::shared_ptr<BasisSet> primary, int max_points, int max_functions)
     : PointFunctions(primary, max_points, max_functions) {
     set_ansatz(0);
-    current_basis_map_ = &basis_values_;
 }
 RKSFunctions::~RKSFunctions() {}
 std::vector<SharedMatrix> RKSFunctions::scratch() {
@@ -154,10 +153,7 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
 
     // => Build basis function values <= //
     block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
+    if (force_compute || !collocation_cache_ || !collocation_cache_->unpack(block->index(), basis_values_)) {
         BasisFunctions::compute_functions(block);
     }
 
@@ -299,10 +295,7 @@ void RKSFunctions::set_Cs(SharedMatrix /*Ca_AO*/, SharedMatrix /*Cb_AO*/) {
 void RKSFunctions::compute_orbitals(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
     block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
+    if (force_compute || !collocation_cache_ || !collocation_cache_->unpack(block->index(), basis_values_)) {
         BasisFunctions::compute_functions(block);
     }
     // timer_off("Functions: Points");
@@ -362,7 +355,6 @@ void RKSFunctions::print(std::string out, int print) const {
 UKSFunctions::UKSFunctions(std::shared_ptr<BasisSet> primary, int max_points, int max_functions)
     : PointFunctions(primary, max_points, max_functions) {
     set_ansatz(0);
-    current_basis_map_ = &basis_values_;
 }
 UKSFunctions::~UKSFunctions() {}
 std::vector<SharedMatrix> UKSFunctions::scratch() {
@@ -423,10 +415,7 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
 
     // => Build basis function values <= //
     block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
+    if (force_compute || !collocation_cache_ || !collocation_cache_->unpack(block->index(), basis_values_)) {
         BasisFunctions::compute_functions(block);
     }
 
@@ -569,10 +558,7 @@ void UKSFunctions::set_Cs(SharedMatrix Ca_AO, SharedMatrix Cb_AO) {
 void UKSFunctions::compute_orbitals(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
     block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
+    if (force_compute || !collocation_cache_ || !collocation_cache_->unpack(block->index(), basis_values_)) {
         BasisFunctions::compute_functions(block);
     }
 
@@ -694,7 +680,30 @@ void BasisFunctions::allocate() {
         basis_temps_["PHI_ZZ"] = std::make_shared<Matrix>("PHI_ZZ", max_points_, max_functions_);
     }
 
-    if (deriv_ >= 3) throw PSIEXCEPTION("BasisFunctions: Only up to Hessians are currently supported");
+    if (deriv_ >= 3) {
+        basis_values_["PHI_XXX"] = std::make_shared<Matrix>("PHI_XXX", max_points_, max_functions_);
+        basis_values_["PHI_XXY"] = std::make_shared<Matrix>("PHI_XXY", max_points_, max_functions_);
+        basis_values_["PHI_XXZ"] = std::make_shared<Matrix>("PHI_XXZ", max_points_, max_functions_);
+        basis_values_["PHI_XYY"] = std::make_shared<Matrix>("PHI_XYY", max_points_, max_functions_);
+        basis_values_["PHI_XYZ"] = std::make_shared<Matrix>("PHI_XYZ", max_points_, max_functions_);
+        basis_values_["PHI_XZZ"] = std::make_shared<Matrix>("PHI_XZZ", max_points_, max_functions_);
+        basis_values_["PHI_YYY"] = std::make_shared<Matrix>("PHI_YYY", max_points_, max_functions_);
+        basis_values_["PHI_YYZ"] = std::make_shared<Matrix>("PHI_YYZ", max_points_, max_functions_);
+        basis_values_["PHI_YZZ"] = std::make_shared<Matrix>("PHI_YZZ", max_points_, max_functions_);
+        basis_values_["PHI_ZZZ"] = std::make_shared<Matrix>("PHI_ZZZ", max_points_, max_functions_);
+        basis_temps_["PHI_XXX"] = std::make_shared<Matrix>("PHI_XXX", max_points_, max_functions_);
+        basis_temps_["PHI_XXY"] = std::make_shared<Matrix>("PHI_XXY", max_points_, max_functions_);
+        basis_temps_["PHI_XXZ"] = std::make_shared<Matrix>("PHI_XXZ", max_points_, max_functions_);
+        basis_temps_["PHI_XYY"] = std::make_shared<Matrix>("PHI_XYY", max_points_, max_functions_);
+        basis_temps_["PHI_XYZ"] = std::make_shared<Matrix>("PHI_XYZ", max_points_, max_functions_);
+        basis_temps_["PHI_XZZ"] = std::make_shared<Matrix>("PHI_XZZ", max_points_, max_functions_);
+        basis_temps_["PHI_YYY"] = std::make_shared<Matrix>("PHI_YYY", max_points_, max_functions_);
+        basis_temps_["PHI_YYZ"] = std::make_shared<Matrix>("PHI_YYZ", max_points_, max_functions_);
+        basis_temps_["PHI_YZZ"] = std::make_shared<Matrix>("PHI_YZZ", max_points_, max_functions_);
+        basis_temps_["PHI_ZZZ"] = std::make_shared<Matrix>("PHI_ZZZ", max_points_, max_functions_);
+    }
+
+    if (deriv_ >= 4) throw PSIEXCEPTION("BasisFunctions: Only up to third derivatives are currently supported");
 }
 void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
     // Pull out data
@@ -717,6 +726,10 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
     double *tmp_xxp, *tmp_xyp, *tmp_xzp, *tmp_yyp, *tmp_yzp, *tmp_zzp;
     double *valuesp, *values_xp, *values_yp, *values_zp;
     double *values_xxp, *values_xyp, *values_xzp, *values_yyp, *values_yzp, *values_zzp;
+    const char* deriv3_names[] = {"PHI_XXX", "PHI_XXY", "PHI_XXZ", "PHI_XYY", "PHI_XYZ",
+                                  "PHI_XZZ", "PHI_YYY", "PHI_YYZ", "PHI_YZZ", "PHI_ZZZ"};
+    double* tmp3p[10];
+    double* values3p[10];
 
     if (deriv_ >= 0) {
         tmpp = basis_temps_["PHI"]->pointer()[0];
@@ -744,6 +757,12 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         values_yzp = basis_values_["PHI_YZ"]->pointer()[0];
         values_zzp = basis_values_["PHI_ZZ"]->pointer()[0];
     }
+    if (deriv_ >= 3) {
+        for (int c = 0; c < 10; c++) {
+            tmp3p[c] = basis_temps_[deriv3_names[c]]->pointer()[0];
+            values3p[c] = basis_values_[deriv3_names[c]]->pointer()[0];
+        }
+    }
 
     int nvals = 0;
     for (size_t Qlocal = 0; Qlocal < shells.size(); Qlocal++) {
@@ -789,6 +808,22 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
             gg_collocation_deriv2(L, npoints, xyz, 1, nprim, norm, alpha, center.data(), order, phi_start,
                                   phi_x_start, phi_y_start, phi_z_start, phi_xx_start, phi_xy_start, phi_xz_start,
                                   phi_yy_start, phi_yz_start, phi_zz_start);
+        } else if (deriv_ == 3) {
+            double* phi_x_start = tmp_xp + row_shift;
+            double* phi_y_start = tmp_yp + row_shift;
+            double* phi_z_start = tmp_zp + row_shift;
+            double* phi_xx_start = tmp_xxp + row_shift;
+            double* phi_xy_start = tmp_xyp + row_shift;
+            double* phi_xz_start = tmp_xzp + row_shift;
+            double* phi_yy_start = tmp_yyp + row_shift;
+            double* phi_yz_start = tmp_yzp + row_shift;
+            double* phi_zz_start = tmp_zzp + row_shift;
+            gg_collocation_deriv3(L, npoints, xyz, 1, nprim, norm, alpha, center.data(), order, phi_start,
+                                  phi_x_start, phi_y_start, phi_z_start, phi_xx_start, phi_xy_start, phi_xz_start,
+                                  phi_yy_start, phi_yz_start, phi_zz_start, tmp3p[0] + row_shift,
+                                  tmp3p[1] + row_shift, tmp3p[2] + row_shift, tmp3p[3] + row_shift,
+                                  tmp3p[4] + row_shift, tmp3p[5] + row_shift, tmp3p[6] + row_shift,
+                                  tmp3p[7] + row_shift, tmp3p[8] + row_shift, tmp3p[9] + row_shift);
         }
 
         if (puream_) {
@@ -814,6 +849,9 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         gg_fast_transpose(nso, npoints, tmp_yzp, values_yzp);
         gg_fast_transpose(nso, npoints, tmp_zzp, values_zzp);
     }
+    if (deriv_ >= 3) {
+        for (int c = 0; c < 10; c++) gg_fast_transpose(nso, npoints, tmp3p[c], values3p[c]);
+    }
 }
 void BasisFunctions::print(std::string out, int print) const {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
@@ -830,4 +868,185 @@ void BasisFunctions::print(std::string out, int print) const {
     printer->Printf("\n\n");
 }
 
+namespace {
+const char* collocation_names[] = {"PHI",    "PHI_X",  "PHI_Y",  "PHI_Z",  "PHI_XX",
+                                   "PHI_XY", "PHI_XZ", "PHI_YY", "PHI_YZ", "PHI_ZZ"};
+size_t collocation_align(size_t bytes) { return (bytes + 7) & ~(size_t)7; }
+}  // namespace
+
+CollocationCache::CollocationCache(Storage storage, double cutoff)
+    : storage_(storage), cutoff_(cutoff), capacity_(0), used_(0), ncached_(0) {}
+
+void CollocationCache::clear() {
+    names_.clear();
+    entries_.clear();
+    arena_.reset();
+    capacity_ = 0;
+    used_ = 0;
+    ncached_ = 0;
+}
+
+void CollocationCache::build(const std::vector<std::shared_ptr<BlockOPoints>>& blocks,
+                             std::shared_ptr<BasisSet> primary,
+                             const std::vector<std::shared_ptr<PointFunctions>>& workers, size_t memory) {
+    clear();
+    if (blocks.empty() || workers.empty() || memory == 0) return;
+
+    int deriv = workers[0]->deriv();
+    size_t ncomp = (deriv >= 2 ? 10 : (deriv == 1 ? 4 : 1));
+    names_.assign(collocation_names, collocation_names + ncomp);
+    size_t deriv_size = (storage_ == Storage::Single ? sizeof(float) : sizeof(double));
+
+    // => Admission order <= //
+
+    // Recomputing a block costs an exponential per primitive (and derivative order) plus the
+    // polynomial work per function and component; the most work saved per byte goes first
+    size_t max_index = 0;
+    size_t dense_total = 0;
+    std::vector<std::pair<double, size_t>> order;
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        const std::shared_ptr<BlockOPoints>& block = blocks[Q];
+        max_index = std::max(max_index, block->index());
+        size_t npoints = block->npoints();
+        size_t nlocal = block->local_nbf();
+        if (!npoints || !nlocal) continue;
+
+        double work = 0.0;
+        for (int shell : block->shells_local_to_global()) {
+            const GaussianShell& Qshell = primary->shell(shell);
+            work += (double)Qshell.nprimitive() * (deriv + 1) + (double)Qshell.nfunction() * ncomp;
+        }
+        size_t bytes = collocation_align(npoints * nlocal * sizeof(double)) +
+                       (ncomp - 1) * collocation_align(npoints * nlocal * deriv_size);
+        dense_total += bytes;
+        order.push_back(std::make_pair(npoints * work / bytes, Q));
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) { return a.first > b.first; });
+
+    entries_.resize(max_index + 1);
+    capacity_ = std::min(memory, dense_total);
+    arena_.reset(new char[capacity_]);
+
+    // => Fill <= //
+
+#pragma omp parallel for schedule(dynamic) num_threads(workers.size())
+    for (size_t i = 0; i < order.size(); i++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const std::shared_ptr<BlockOPoints>& block = blocks[order[i].second];
+        size_t npoints = block->npoints();
+        size_t nlocal = block->local_nbf();
+
+        // Not even PHI fits any more, don't bother computing
+        size_t phi_bytes = collocation_align(npoints * nlocal * sizeof(double));
+        bool room;
+#pragma omp critical(collocation_cache)
+        room = (used_ + phi_bytes <= capacity_);
+        if (!room) continue;
+
+        std::shared_ptr<PointFunctions> worker = workers[rank];
+        worker->compute_functions(block);
+        std::map<std::string, SharedMatrix>& values = worker->basis_values();
+
+        // Lay out the components
+        Entry entry;
+        entry.npoints = npoints;
+        entry.nlocal = nlocal;
+        entry.components.resize(ncomp);
+        size_t bytes = 0;
+        for (size_t c = 0; c < ncomp; c++) {
+            Component& comp = entry.components[c];
+            comp.single = (c > 0 && storage_ == Storage::Single);
+            comp.sparse = (c > 0 && storage_ == Storage::Sparse);
+            size_t ncols = nlocal;
+            if (comp.sparse) {
+                double** vp = values[names_[c]]->pointer();
+                std::vector<double> vmax(nlocal, 0.0);
+                for (size_t P = 0; P < npoints; P++) {
+                    for (size_t m = 0; m < nlocal; m++) vmax[m] = std::max(vmax[m], std::fabs(vp[P][m]));
+                }
+                for (size_t m = 0; m < nlocal; m++) {
+                    if (vmax[m] >= cutoff_) comp.columns.push_back(m);
+                }
+                ncols = comp.columns.size();
+            }
+            comp.offset = bytes;
+            bytes += collocation_align(npoints * ncols * (comp.single ? sizeof(float) : sizeof(double)));
+        }
+
+        size_t base = 0;
+        bool fits;
+#pragma omp critical(collocation_cache)
+        {
+            fits = (used_ + bytes <= capacity_);
+            if (fits) {
+                base = used_;
+                used_ += bytes;
+                ncached_++;
+            }
+        }
+        if (!fits) continue;
+
+        // Pack, PHI and full components row by row, single precision converted, sparse by kept columns
+        for (size_t c = 0; c < ncomp; c++) {
+            Component& comp = entry.components[c];
+            comp.offset += base;
+            double** vp = values[names_[c]]->pointer();
+            if (comp.sparse) {
+                double* dst = reinterpret_cast<double*>(arena_.get() + comp.offset);
+                size_t ncols = comp.columns.size();
+                for (size_t P = 0; P < npoints; P++) {
+                    for (size_t j = 0; j < ncols; j++) dst[P * ncols + j] = vp[P][comp.columns[j]];
+                }
+            } else if (comp.single) {
+                float* dst = reinterpret_cast<float*>(arena_.get() + comp.offset);
+                for (size_t P = 0; P < npoints; P++) {
+                    for (size_t m = 0; m < nlocal; m++) dst[P * nlocal + m] = (float)vp[P][m];
+                }
+            } else {
+                double* dst = reinterpret_cast<double*>(arena_.get() + comp.offset);
+                for (size_t P = 0; P < npoints; P++) ::memcpy(&dst[P * nlocal], vp[P], sizeof(double) * nlocal);
+            }
+        }
+        entries_[block->index()] = std::move(entry);
+    }
+}
+
+bool CollocationCache::unpack(size_t block, std::map<std::string, SharedMatrix>& values) const {
+    if (block >= entries_.size() || entries_[block].components.empty()) return false;
+    for (const auto& kv : values) {
+        if (std::find(names_.begin(), names_.end(), kv.first) == names_.end()) return false;
+    }
+
+    const Entry& entry = entries_[block];
+    size_t npoints = entry.npoints;
+    size_t nlocal = entry.nlocal;
+    for (size_t c = 0; c < names_.size(); c++) {
+        auto it = values.find(names_[c]);
+        if (it == values.end()) continue;
+        double** vp = it->second->pointer();
+        const Component& comp = entry.components[c];
+        if (comp.sparse) {
+            const double* src = reinterpret_cast<const double*>(arena_.get() + comp.offset);
+            size_t ncols = comp.columns.size();
+            for (size_t P = 0; P < npoints; P++) {
+                std::fill(vp[P], vp[P] + nlocal, 0.0);
+                for (size_t j = 0; j < ncols; j++) vp[P][comp.columns[j]] = src[P * ncols + j];
+            }
+        } else if (comp.single) {
+            const float* src = reinterpret_cast<const float*>(arena_.get() + comp.offset);
+            for (size_t P = 0; P < npoints; P++) {
+                for (size_t m = 0; m < nlocal; m++) vp[P][m] = src[P * nlocal + m];
+            }
+        } else {
+            const double* src = reinterpret_cast<const double*>(arena_.get() + comp.offset);
+            for (size_t P = 0; P < npoints; P++) ::memcpy(vp[P], &src[P * nlocal], sizeof(double) * nlocal);
+        }
+    }
+    return true;
+}
+
 }  // namespace psi
@@ -34,6 +34,7 @@
 
 #include <cstdio>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <tuple>
 #include <vector>
@@ -44,6 +45,7 @@ namespace psi {
 class BasisSet;
 class Vector;
 class BlockOPoints;
+class CollocationCache;
 
 class PSI_API BasisFunctions {
    protected:
@@ -108,11 +110,8 @@ class PointFunctions : public BasisFunctions {
     /// The index of the current referenced block.
     size_t block_index_;
 
-    // Contains a map to the cache the global basis_values
-    std::unordered_map<size_t, std::map<std::string, SharedMatrix>>* cache_map_ = nullptr;
-
-    // Contains a pointer to the current map to use for basis_values
-    std::map<std::string, SharedMatrix>* current_basis_map_ = nullptr;
+    // Precomputed basis_values for some blocks, shared by all workers
+    const CollocationCache* collocation_cache_ = nullptr;
 
     /// Ansatz (0 - LSDA, 1 - GGA, 2 - Meta-GGA)
     int ansatz_;
@@ -131,9 +130,7 @@ class PointFunctions : public BasisFunctions {
     ~PointFunctions() override;
 
     // => Setters <= //
-    void set_cache_map(std::unordered_map<size_t, std::map<std::string, SharedMatrix>>* cache_map) {
-        cache_map_ = cache_map;
-    }
+    void set_collocation_cache(const CollocationCache* cache) { collocation_cache_ = cache; }
 
     // => Computers <= //
 
@@ -144,9 +141,6 @@ class PointFunctions : public BasisFunctions {
     std::shared_ptr<Vector> point_value(const std::string& key);
     std::map<std::string, SharedVector>& point_values() { return point_values_; }
 
-    SharedMatrix basis_value(const std::string& key) { return (*current_basis_map_)[key]; }
-    std::map<std::string, SharedMatrix>& basis_values() { return (*current_basis_map_); }
-
     virtual std::vector<SharedMatrix> scratch() = 0;
     virtual std::vector<SharedMatrix> D_scratch() = 0;
 
@@ -287,10 +281,6 @@ class UKSFunctions : public PointFunctions {
 
     void set_pointers(SharedMatrix Da_occ_AO) override;
     void set_pointers(SharedMatrix Da_occ_AO, SharedMatrix Db_occ_AO) override;
-    void set_cache_map(std::unordered_map<size_t, std::map<std::string, SharedMatrix>>* cache_map) {
-        cache_map_ = cache_map;
-    }
-
     void compute_points(std::shared_ptr<BlockOPoints> block, bool force_compute = true) override;
 
     std::vector<SharedMatrix> scratch() override;
@@ -303,5 +293,63 @@ class UKSFunctions : public PointFunctions {
     void set_Cs(SharedMatrix Caocc, SharedMatrix Cbocc) override;
     size_t block_index() { return block_index_; }
 };
+
+/**
+ * Class CollocationCache
+ *
+ * Basis function values (and derivatives) of the grid blocks, packed into a
+ * single arena. Blocks are admitted by estimated evaluation cost per byte
+ * until the memory budget is used up, so that the blocks that are most
+ * expensive to recompute (many primitives, derivative components) stay cached.
+ * Derivative components can be kept in single precision, or with the columns
+ * of basis functions that are negligible on the block dropped.
+ **/
+class PSI_API CollocationCache {
+   public:
+    enum class Storage { Full, Single, Sparse };
+
+    /// @param storage Format of the derivative components, PHI is always kept in full
+    /// @param cutoff  Columns below this magnitude are dropped in Sparse storage
+    CollocationCache(Storage storage, double cutoff);
+
+    /// Fill the cache from the blocks, using at most memory bytes and one worker per thread
+    void build(const std::vector<std::shared_ptr<BlockOPoints>>& blocks, std::shared_ptr<BasisSet> primary,
+               const std::vector<std::shared_ptr<PointFunctions>>& workers, size_t memory);
+    /// Copy block into the (max_points x max_functions) matrices of values, false if not cached (or if the
+    /// cache lacks one of the components in values)
+    bool unpack(size_t block, std::map<std::string, SharedMatrix>& values) const;
+    void clear();
+
+    Storage storage() const { return storage_; }
+    size_t ncached() const { return ncached_; }
+    size_t size() const { return used_; }
+
+   private:
+    struct Component {
+        /// Byte offset in the arena
+        size_t offset;
+        /// Stored in single precision
+        bool single;
+        /// Only the columns below are stored
+        bool sparse;
+        /// Local functions kept in sparse storage
+        std::vector<int> columns;
+    };
+    struct Entry {
+        int npoints = 0;
+        int nlocal = 0;
+        std::vector<Component> components;
+    };
+
+    Storage storage_;
+    double cutoff_;
+    /// Component names by position, PHI, PHI_X, ...
+    std::vector<std::string> names_;
+    std::vector<Entry> entries_;
+    std::unique_ptr<char[]> arena_;
+    size_t capacity_;
+    size_t used_;
+    size_t ncached_;
+};
 }  // namespace psi
 #endif
@@ -47,7 +47,9 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -102,8 +104,13 @@ void VBase::common_init() {
     debug_ = options_.get_int("DEBUG");
     v2_rho_cutoff_ = options_.get_double("DFT_V2_RHO_CUTOFF");
     vv10_rho_cutoff_ = options_.get_double("DFT_VV10_RHO_CUTOFF");
+    vv10_kernel_cutoff_ = options_.get_double("DFT_VV10_KERNEL_CUTOFF");
     grac_initialized_ = false;
-    cache_map_deriv_ = -1;
+    std::string storage = options_.get_str("DFT_COLLOCATION_CACHE_STORAGE");
+    collocation_cache_ = std::make_shared<CollocationCache>(
+        (storage == "SINGLE" ? CollocationCache::Storage::Single
+                             : (storage == "SPARSE" ? CollocationCache::Storage::Sparse : CollocationCache::Storage::Full)),
+        options_.get_double("DFT_BASIS_TOLERANCE"));
     num_threads_ = 1;
 #ifdef _OPENMP
     num_threads_ = omp_get_max_threads();
@@ -735,82 +742,16 @@ std::shared_ptr<BlockOPoints> VBase::get_block(int block) { return grid_->blocks
 size_t VBase::nblocks() { return grid_->blocks().size(); }
 void VBase::finalize() { grid_.reset(); }
 void VBase::build_collocation_cache(size_t memory) {
-    // Figure out many blocks to skip
+    collocation_cache_->build(grid_->blocks(), primary_, point_workers_, memory * sizeof(double));
+    if (!collocation_cache_->ncached()) return;
 
-    size_t collocation_size = grid_->collocation_size();
-    if (functional_->ansatz() == 1) {
-        collocation_size *= 4;  // For gradients
-    }
-    if (functional_->ansatz() == 2) {
-        collocation_size *= 10;  // For gradients and Hessians
-    }
-
-    // Figure out stride as closest whole number to amount we need
-    size_t stride = (size_t)(std::ceil(collocation_size / (double)memory));
-
-    // More memory than needed
-    if (stride == 0) {
-        stride = 1;
-    }
-    cache_map_.clear();
-
-    // Effectively zero blocks saved.
-    if (stride > grid_->blocks().size()) {
-        return;
-    }
-
-    cache_map_deriv_ = point_workers_[0]->deriv();
-    auto saved_size_rank = std::vector<size_t>(num_threads_, 0);
-    auto ncomputed_rank = std::vector<size_t>(num_threads_, 0);
-
-// Loop over the blocks
-#pragma omp parallel for schedule(guided) num_threads(num_threads_)
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q += stride) {
-        // Get thread info
-        int rank = 0;
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-
-        // Compute a collocation block
-        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
-        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        pworker->compute_functions(block);
-
-        // Build temps
-        size_t nrows = block->npoints();
-        size_t ncols = block->local_nbf();
-        std::map<std::string, SharedMatrix> collocation_map;
-
-        // Loop over components PHI, PHI_X, PHI_Y, ...
-        for (auto& kv : pworker->basis_values()) {
-            auto coll = std::make_shared<Matrix>(kv.second->name(), nrows, ncols);
-
-            double** sourcep = kv.second->pointer();
-            double** collp = coll->pointer();
-
-            // Matrices are packed in a upper left rectangle, cannot use pure DCOPY
-            for (size_t i = 0; i < nrows; i++) {
-                C_DCOPY(ncols, sourcep[i], 1, collp[i], 1);
-            }
-            collocation_map[kv.first] = coll;
-
-            saved_size_rank[rank] += nrows * ncols;
-        }
-        ncomputed_rank[rank]++;
-#pragma omp critical
-        cache_map_[block->index()] = collocation_map;
-    }
-
-    size_t saved_size = std::accumulate(saved_size_rank.begin(), saved_size_rank.end(), 0.0);
-    size_t ncomputed = std::accumulate(ncomputed_rank.begin(), ncomputed_rank.end(), 0.0);
-
-    double gib_saved = 8.0 * (double)saved_size / 1024.0 / 1024.0 / 1024.0;
-    double fraction = (double)ncomputed / grid_->blocks().size() * 100;
+    double gib_saved = (double)collocation_cache_->size() / 1024.0 / 1024.0 / 1024.0;
+    double fraction = (double)collocation_cache_->ncached() / grid_->blocks().size() * 100;
     if (print_) {
         outfile->Printf("  Cached %.1lf%% of DFT collocation blocks in %.3lf [GiB].\n\n", fraction, gib_saved);
     }
 }
+void VBase::clear_collocation_cache() { collocation_cache_->clear(); }
 void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
                                std::vector<std::map<std::string, SharedVector>>& vv10_cache,
                                std::vector<std::shared_ptr<PointFunctions>>& nl_point_workers, int ansatz) {
@@ -851,45 +792,135 @@ void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
             fworker->compute_vv10_cache(pworker->point_values(), block, vv10_rho_cutoff_, block->npoints(), false);
     }
 
-    // Stitch the cache together to make a single contiguous cache
+    // Stitch the cache together to make a single contiguous set of points
     size_t total_size = 0;
-    for (auto cache : vv10_tmp_cache) {
-        total_size += cache["W"]->dimpi()[0];
+    for (const auto& cache : vv10_tmp_cache) {
+        total_size += cache.at("W")->dimpi()[0];
     }
 
     // printf("VV10 NL Total size %zu\n", total_size);
 
-    // Leave this as a vector of maps in case we ever revisit the on-the fly manipulation
-    vv10_cache.resize(1);
-    vv10_cache[0]["W"] = std::make_shared<Vector>("W Grid points", total_size);
-    vv10_cache[0]["X"] = std::make_shared<Vector>("X Grid points", total_size);
-    vv10_cache[0]["Y"] = std::make_shared<Vector>("Y Grid points", total_size);
-    vv10_cache[0]["Z"] = std::make_shared<Vector>("Z Grid points", total_size);
-    vv10_cache[0]["RHO"] = std::make_shared<Vector>("RHO Grid points", total_size);
-    vv10_cache[0]["W0"] = std::make_shared<Vector>("W0 Grid points", total_size);
-    vv10_cache[0]["KAPPA"] = std::make_shared<Vector>("KAPPA Grid points", total_size);
-
-    double* w_vecp = vv10_cache[0]["W"]->pointer();
-    double* x_vecp = vv10_cache[0]["X"]->pointer();
-    double* y_vecp = vv10_cache[0]["Y"]->pointer();
-    double* z_vecp = vv10_cache[0]["Z"]->pointer();
-    double* rho_vecp = vv10_cache[0]["RHO"]->pointer();
-    double* w0_vecp = vv10_cache[0]["W0"]->pointer();
-    double* kappa_vecp = vv10_cache[0]["KAPPA"]->pointer();
+    std::vector<double> w_all(total_size), x_all(total_size), y_all(total_size), z_all(total_size);
+    std::vector<double> rho_all(total_size), w0_all(total_size), kappa_all(total_size);
 
     size_t offset = 0;
-    for (auto cache : vv10_tmp_cache) {
-        size_t csize = cache["W"]->dimpi()[0];
-        C_DCOPY(csize, cache["W"]->pointer(), 1, (w_vecp + offset), 1);
-        C_DCOPY(csize, cache["X"]->pointer(), 1, (x_vecp + offset), 1);
-        C_DCOPY(csize, cache["Y"]->pointer(), 1, (y_vecp + offset), 1);
-        C_DCOPY(csize, cache["Z"]->pointer(), 1, (z_vecp + offset), 1);
-        C_DCOPY(csize, cache["RHO"]->pointer(), 1, (rho_vecp + offset), 1);
-        C_DCOPY(csize, cache["W0"]->pointer(), 1, (w0_vecp + offset), 1);
-        C_DCOPY(csize, cache["KAPPA"]->pointer(), 1, (kappa_vecp + offset), 1);
+    for (const auto& cache : vv10_tmp_cache) {
+        size_t csize = cache.at("W")->dimpi()[0];
+        if (csize == 0) continue;
+        C_DCOPY(csize, cache.at("W")->pointer(), 1, &w_all[offset], 1);
+        C_DCOPY(csize, cache.at("X")->pointer(), 1, &x_all[offset], 1);
+        C_DCOPY(csize, cache.at("Y")->pointer(), 1, &y_all[offset], 1);
+        C_DCOPY(csize, cache.at("Z")->pointer(), 1, &z_all[offset], 1);
+        C_DCOPY(csize, cache.at("RHO")->pointer(), 1, &rho_all[offset], 1);
+        C_DCOPY(csize, cache.at("W0")->pointer(), 1, &w0_all[offset], 1);
+        C_DCOPY(csize, cache.at("KAPPA")->pointer(), 1, &kappa_all[offset], 1);
 
         offset += csize;
     }
+    vv10_tmp_cache.clear();
+
+    // => Bucket the points into uniform cells and cut the cells into tiles <=
+    // Each tile is one entry of vv10_cache and carries a "BOUNDS" vector used by the kernel screening:
+    // [centroid x, y, z, bounding radius, min W0, min kappa, sum of |w rho|]
+    const double cell_length = 4.0;
+    const size_t max_tile_points = 256;
+
+    vv10_cache.clear();
+    if (total_size == 0) return;
+
+    double x_min = *std::min_element(x_all.begin(), x_all.end());
+    double y_min = *std::min_element(y_all.begin(), y_all.end());
+    double z_min = *std::min_element(z_all.begin(), z_all.end());
+    double y_max = *std::max_element(y_all.begin(), y_all.end());
+    double z_max = *std::max_element(z_all.begin(), z_all.end());
+    size_t ny = static_cast<size_t>((y_max - y_min) / cell_length) + 1;
+    size_t nz = static_cast<size_t>((z_max - z_min) / cell_length) + 1;
+
+    std::vector<std::pair<size_t, size_t>> cell_of_point(total_size);
+    for (size_t P = 0; P < total_size; P++) {
+        size_t ix = static_cast<size_t>((x_all[P] - x_min) / cell_length);
+        size_t iy = static_cast<size_t>((y_all[P] - y_min) / cell_length);
+        size_t iz = static_cast<size_t>((z_all[P] - z_min) / cell_length);
+        cell_of_point[P] = std::make_pair((ix * ny + iy) * nz + iz, P);
+    }
+    std::sort(cell_of_point.begin(), cell_of_point.end());
+
+    size_t start = 0;
+    while (start < total_size) {
+        size_t cell_end = start;
+        while (cell_end < total_size && cell_of_point[cell_end].first == cell_of_point[start].first) cell_end++;
+
+        for (size_t tile_start = start; tile_start < cell_end; tile_start += max_tile_points) {
+            size_t tsize = std::min(max_tile_points, cell_end - tile_start);
+
+            std::map<std::string, SharedVector> tile;
+            tile["W"] = std::make_shared<Vector>("W Grid points", tsize);
+            tile["X"] = std::make_shared<Vector>("X Grid points", tsize);
+            tile["Y"] = std::make_shared<Vector>("Y Grid points", tsize);
+            tile["Z"] = std::make_shared<Vector>("Z Grid points", tsize);
+            tile["RHO"] = std::make_shared<Vector>("RHO Grid points", tsize);
+            tile["W0"] = std::make_shared<Vector>("W0 Grid points", tsize);
+            tile["KAPPA"] = std::make_shared<Vector>("KAPPA Grid points", tsize);
+            tile["BOUNDS"] = std::make_shared<Vector>("Tile bounds", 7);
+
+            double* w_vecp = tile["W"]->pointer();
+            double* x_vecp = tile["X"]->pointer();
+            double* y_vecp = tile["Y"]->pointer();
+            double* z_vecp = tile["Z"]->pointer();
+            double* rho_vecp = tile["RHO"]->pointer();
+            double* w0_vecp = tile["W0"]->pointer();
+            double* kappa_vecp = tile["KAPPA"]->pointer();
+            double* bounds = tile["BOUNDS"]->pointer();
+
+            double xc = 0.0, yc = 0.0, zc = 0.0;
+            double w0_min = std::numeric_limits<double>::max();
+            double kappa_min = std::numeric_limits<double>::max();
+            double wrho_sum = 0.0;
+            for (size_t k = 0; k < tsize; k++) {
+                size_t P = cell_of_point[tile_start + k].second;
+                w_vecp[k] = w_all[P];
+                x_vecp[k] = x_all[P];
+                y_vecp[k] = y_all[P];
+                z_vecp[k] = z_all[P];
+                rho_vecp[k] = rho_all[P];
+                w0_vecp[k] = w0_all[P];
+                kappa_vecp[k] = kappa_all[P];
+
+                xc += x_all[P];
+                yc += y_all[P];
+                zc += z_all[P];
+                w0_min = std::min(w0_min, w0_all[P]);
+                kappa_min = std::min(kappa_min, kappa_all[P]);
+                wrho_sum += std::fabs(w_all[P] * rho_all[P]);
+            }
+            xc /= tsize;
+            yc /= tsize;
+            zc /= tsize;
+
+            double R = 0.0;
+            for (size_t k = 0; k < tsize; k++) {
+                double dx = x_vecp[k] - xc;
+                double dy = y_vecp[k] - yc;
+                double dz = z_vecp[k] - zc;
+                R = std::max(R, std::sqrt(dx * dx + dy * dy + dz * dz));
+            }
+
+            bounds[0] = xc;
+            bounds[1] = yc;
+            bounds[2] = zc;
+            bounds[3] = R;
+            bounds[4] = w0_min;
+            bounds[5] = kappa_min;
+            bounds[6] = wrho_sum;
+
+            vv10_cache.push_back(tile);
+        }
+        start = cell_end;
+    }
+
+    if (print_ > 1) {
+        outfile->Printf("  VV10: %zu NL points bucketed into %zu tiles.\n", total_size, vv10_cache.size());
+    }
 }
 double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
     timer_on("V: VV10");
@@ -945,7 +976,8 @@ double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
         std::map<std::string, SharedVector> vals = fworker->values();
 
         parallel_timer_on("Kernel", rank);
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block);
+        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, block->npoints(),
+                                                        false, vv10_kernel_cutoff_);
         parallel_timer_off("Kernel", rank);
 
         parallel_timer_on("VV10 Fock", rank);
@@ -1040,7 +1072,8 @@ SharedMatrix VBase::vv10_nlc_gradient(SharedMatrix D) {
         std::map<std::string, SharedVector> vals = fworker->values();
 
         parallel_timer_on("Kernel", rank);
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints, true);
+        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints, true,
+                                                        vv10_kernel_cutoff_);
         parallel_timer_off("Kernel", rank);
 
         parallel_timer_on("V_xc gradient", rank);
@@ -1091,6 +1124,520 @@ SharedMatrix VBase::vv10_nlc_gradient(SharedMatrix D) {
     return G;
 }
 
+void VBase::compute_xc_deriv2(SharedMatrix H, std::vector<SharedMatrix>& Fx) {
+    int nspin = D_AO_.size();
+    int ansatz = functional_->ansatz();
+    bool gga = (ansatz >= 1);
+    bool do_hess = (H != nullptr);
+    bool do_fx = !Fx.empty();
+
+    int natom = primary_->molecule()->natom();
+    int max_functions = grid_->max_functions();
+    int max_points = grid_->max_points();
+    const std::vector<std::shared_ptr<BlockOPoints>>& blocks = grid_->blocks();
+
+    // The RKS workers hold Da, but the XC kernel is written in terms of the total density
+    double Dscale = (nspin == 1 ? 2.0 : 1.0);
+
+    // => Atoms touched by each block, perturbation storage is sized by the busiest one <= //
+    std::vector<std::vector<int>> block_atoms(blocks.size());
+    std::vector<std::vector<int>> block_local_atom(blocks.size());
+    size_t max_pert = 0;
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        const std::vector<int>& function_map = blocks[Q]->functions_local_to_global();
+        std::vector<int>& atoms = block_atoms[Q];
+        std::vector<int>& local_atom = block_local_atom[Q];
+        for (int mg : function_map) {
+            int A = primary_->function_to_center(mg);
+            auto it = std::find(atoms.begin(), atoms.end(), A);
+            local_atom.push_back(std::distance(atoms.begin(), it));
+            if (it == atoms.end()) atoms.push_back(A);
+        }
+        max_pert = std::max(max_pert, 3 * atoms.size());
+    }
+    if (max_pert == 0) return;
+
+    // => Setup the workers: GGA terms need one more collocation derivative than LSDA <= //
+    int old_point_deriv = point_workers_[0]->deriv();
+    int old_func_deriv = functional_->deriv();
+    int point_deriv = (do_hess ? 2 : 1) + (gga ? 1 : 0);
+    for (size_t i = 0; i < num_threads_; i++) {
+        if (nspin == 1) {
+            point_workers_[i]->set_pointers(D_AO_[0]);
+        } else {
+            point_workers_[i]->set_pointers(D_AO_[0], D_AO_[1]);
+        }
+        point_workers_[i]->set_deriv(point_deriv);
+        functional_workers_[i]->set_deriv(2);
+        functional_workers_[i]->allocate();
+    }
+
+    // => Per [R]ank quantities <= //
+    // [spin][0] is the value, [spin][1..3] the gradient
+    std::vector<std::vector<SharedMatrix>> R_T(num_threads_);     // φ D and ∇φ D
+    std::vector<std::vector<SharedMatrix>> R_rho1(num_threads_);  // ρ^ξ and ∇ρ^ξ, perturbation x point
+    std::vector<std::vector<SharedMatrix>> R_v1(num_threads_);    // w v^ξ and w Vg^ξ, perturbation x point
+    std::vector<std::vector<SharedVector>> R_v(num_threads_);     // v and Vg, the ground state potential
+    std::vector<std::vector<SharedMatrix>> R_LM(num_threads_);    // L_x, M_x, U/Y and Vg·∇φ intermediates
+    std::vector<std::vector<SharedMatrix>> R_X(num_threads_);     // local basis function pairs
+    std::vector<SharedMatrix> R_H, R_Hloc;
+    for (size_t i = 0; i < num_threads_; i++) {
+        for (int s = 0; s < nspin; s++) {
+            for (int k = 0; k < 4; k++) {
+                R_T[i].push_back(std::make_shared<Matrix>("T", max_points, max_functions));
+                R_rho1[i].push_back(std::make_shared<Matrix>("Rho1", max_pert, max_points));
+                R_v1[i].push_back(std::make_shared<Matrix>("V1", max_pert, max_points));
+                R_v[i].push_back(std::make_shared<Vector>("V", max_points));
+            }
+        }
+        for (int k = 0; k < 9; k++) R_LM[i].push_back(std::make_shared<Matrix>("LM", max_points, max_functions));
+        for (int k = 0; k < 4; k++) R_X[i].push_back(std::make_shared<Matrix>("X", max_functions, max_functions));
+        if (do_hess) {
+            R_H.push_back(std::make_shared<Matrix>("H Temp", 3 * natom, 3 * natom));
+            R_Hloc.push_back(std::make_shared<Matrix>("H Local", max_pert, max_pert));
+        }
+    }
+
+    // Maps (x, y) and (k, x, y) onto the collocation derivative names
+    const char* phi2_names[3][3] = {
+        {"PHI_XX", "PHI_XY", "PHI_XZ"}, {"PHI_XY", "PHI_YY", "PHI_YZ"}, {"PHI_XZ", "PHI_YZ", "PHI_ZZ"}};
+    const char* phi3_names[3][3][3] = {{{"PHI_XXX", "PHI_XXY", "PHI_XXZ"},
+                                        {"PHI_XXY", "PHI_XYY", "PHI_XYZ"},
+                                        {"PHI_XXZ", "PHI_XYZ", "PHI_XZZ"}},
+                                       {{"PHI_XXY", "PHI_XYY", "PHI_XYZ"},
+                                        {"PHI_XYY", "PHI_YYY", "PHI_YYZ"},
+                                        {"PHI_XYZ", "PHI_YYZ", "PHI_YZZ"}},
+                                       {{"PHI_XXZ", "PHI_XYZ", "PHI_XZZ"},
+                                        {"PHI_XYZ", "PHI_YYZ", "PHI_YZZ"},
+                                        {"PHI_XZZ", "PHI_YZZ", "PHI_ZZZ"}}};
+
+    int rank = 0;
+
+// Traverse the blocks of points
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+// Get thread info
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+
+        // => Setup <= //
+        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
+        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        int npoints = block->npoints();
+        double* w = block->w();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        const std::vector<int>& atoms = block_atoms[Q];
+        const std::vector<int>& local_atom = block_local_atom[Q];
+        int nlocal = function_map.size();
+        int npert = 3 * atoms.size();
+        if (npoints == 0 || nlocal == 0) continue;
+
+        parallel_timer_on("Properties", rank);
+        pworker->compute_points(block);
+        parallel_timer_off("Properties", rank);
+
+        parallel_timer_on("Functional", rank);
+        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        parallel_timer_off("Functional", rank);
+
+        parallel_timer_on("V_xc second derivatives", rank);
+
+        // => Grab quantities <= //
+        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
+        double** phi = pworker->basis_value("PHI")->pointer();
+        double** phi1[3];
+        phi1[0] = pworker->basis_value("PHI_X")->pointer();
+        phi1[1] = pworker->basis_value("PHI_Y")->pointer();
+        phi1[2] = pworker->basis_value("PHI_Z")->pointer();
+        double** phi2[3][3];
+        double** phi3[3][3][3];
+        for (int x = 0; x < 3; x++) {
+            for (int y = 0; y < 3; y++) {
+                if (point_deriv >= 2) phi2[x][y] = pworker->basis_value(phi2_names[x][y])->pointer();
+                for (int k = 0; k < 3; k++) {
+                    if (point_deriv >= 3) phi3[x][y][k] = pworker->basis_value(phi3_names[x][y][k])->pointer();
+                }
+            }
+        }
+
+        const char* rho_names[2][4] = {{"RHO_A", "RHO_AX", "RHO_AY", "RHO_AZ"},
+                                       {"RHO_B", "RHO_BX", "RHO_BY", "RHO_BZ"}};
+        double* rho[2][4];
+        for (int s = 0; s < nspin; s++) {
+            for (int k = 0; k < (gga ? 4 : 1); k++) rho[s][k] = pworker->point_value(rho_names[s][k])->pointer();
+        }
+
+        // => Ground state potential, v = ∂F/∂ρ and Vg such that ∂F/∂∇ρ = Vg <= //
+        double* v[2][4];
+        for (int s = 0; s < nspin; s++) {
+            for (int k = 0; k < 4; k++) v[s][k] = R_v[rank][4 * s + k]->pointer();
+        }
+        if (nspin == 1) {
+            double* v_rho = vals["V_RHO_A"]->pointer();
+            for (int P = 0; P < npoints; P++) {
+                bool skip = (std::fabs(rho[0][0][P]) < v2_rho_cutoff_);
+                v[0][0][P] = (skip ? 0.0 : v_rho[P]);
+            }
+            if (gga) {
+                double* v_gamma = vals["V_GAMMA_AA"]->pointer();
+                for (int P = 0; P < npoints; P++) {
+                    bool skip = (std::fabs(rho[0][0][P]) < v2_rho_cutoff_);
+                    for (int k = 1; k < 4; k++) v[0][k][P] = (skip ? 0.0 : 2.0 * v_gamma[P] * rho[0][k][P]);
+                }
+            }
+        } else {
+            double* v_rho[2] = {vals["V_RHO_A"]->pointer(), vals["V_RHO_B"]->pointer()};
+            for (int s = 0; s < 2; s++) {
+                for (int P = 0; P < npoints; P++) {
+                    bool skip = (rho[s][0][P] < v2_rho_cutoff_);
+                    v[s][0][P] = (skip ? 0.0 : v_rho[s][P]);
+                }
+            }
+            if (gga) {
+                double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
+                double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
+                double* v_gamma_bb = vals["V_GAMMA_BB"]->pointer();
+                for (int P = 0; P < npoints; P++) {
+                    bool skip_a = (rho[0][0][P] < v2_rho_cutoff_);
+                    bool skip_b = (rho[1][0][P] < v2_rho_cutoff_);
+                    for (int k = 1; k < 4; k++) {
+                        double va = 2.0 * v_gamma_aa[P] * rho[0][k][P] + v_gamma_ab[P] * rho[1][k][P];
+                        double vb = 2.0 * v_gamma_bb[P] * rho[1][k][P] + v_gamma_ab[P] * rho[0][k][P];
+                        v[0][k][P] = (skip_a ? 0.0 : va);
+                        v[1][k][P] = (skip_b ? 0.0 : vb);
+                    }
+                }
+            }
+        }
+
+        // => First order densities <= //
+        //
+        //   ρ^ξ = -2 D_mn ɸ_m,x ɸ_n,    ∇ρ^ξ = -2 D_mn (∇ɸ_m,x ɸ_n + ɸ_m,x ∇ɸ_n),    m on the atom of ξ = (A, x)
+        //
+        parallel_timer_on("Derivative Properties", rank);
+        for (int s = 0; s < nspin; s++) {
+            double** Dp = pworker->D_scratch()[s]->pointer();
+            double** T[4];
+            double** rho1[4];
+            for (int k = 0; k < 4; k++) {
+                T[k] = R_T[rank][4 * s + k]->pointer();
+                rho1[k] = R_rho1[rank][4 * s + k]->pointer();
+            }
+
+            C_DGEMM('N', 'N', npoints, nlocal, nlocal, Dscale, phi[0], coll_funcs, Dp[0], max_functions, 0.0, T[0][0],
+                    max_functions);
+            if (gga) {
+                for (int k = 0; k < 3; k++) {
+                    C_DGEMM('N', 'N', npoints, nlocal, nlocal, Dscale, phi1[k][0], coll_funcs, Dp[0], max_functions,
+                            0.0, T[k + 1][0], max_functions);
+                }
+            }
+
+            for (int k = 0; k < (gga ? 4 : 1); k++) {
+                for (int p = 0; p < npert; p++) std::fill(rho1[k][p], rho1[k][p] + npoints, 0.0);
+            }
+            for (int P = 0; P < npoints; P++) {
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int p0 = 3 * local_atom[ml];
+                    double T0 = T[0][P][ml];
+                    for (int x = 0; x < 3; x++) {
+                        rho1[0][p0 + x][P] -= 2.0 * phi1[x][P][ml] * T0;
+                        if (!gga) continue;
+                        for (int k = 0; k < 3; k++) {
+                            rho1[k + 1][p0 + x][P] -=
+                                2.0 * (phi2[k][x][P][ml] * T0 + phi1[x][P][ml] * T[k + 1][P][ml]);
+                        }
+                    }
+                }
+            }
+        }
+        parallel_timer_off("Derivative Properties", rank);
+
+        // => First order potentials: w v^ξ and w Vg^ξ through the XC kernel <= //
+        if (nspin == 1) {
+            double* v2_rho2 = vals["V_RHO_A_RHO_A"]->pointer();
+            double* v_gamma = (gga ? vals["V_GAMMA_AA"]->pointer() : nullptr);
+            double* v2_rho_gamma = (gga ? vals["V_RHO_A_GAMMA_AA"]->pointer() : nullptr);
+            double* v2_gamma_gamma = (gga ? vals["V_GAMMA_AA_GAMMA_AA"]->pointer() : nullptr);
+            double** rho1[4];
+            double** v1[4];
+            for (int k = 0; k < 4; k++) {
+                rho1[k] = R_rho1[rank][k]->pointer();
+                v1[k] = R_v1[rank][k]->pointer();
+            }
+            for (int p = 0; p < npert; p++) {
+                for (int P = 0; P < npoints; P++) {
+                    if (std::fabs(rho[0][0][P]) < v2_rho_cutoff_) {
+                        for (int k = 0; k < (gga ? 4 : 1); k++) v1[k][p][P] = 0.0;
+                        continue;
+                    }
+                    double r1 = rho1[0][p][P];
+                    v1[0][p][P] = w[P] * v2_rho2[P] * r1;
+                    if (!gga) continue;
+
+                    double s1 = 0.0;
+                    for (int k = 1; k < 4; k++) s1 += 2.0 * rho[0][k][P] * rho1[k][p][P];
+                    v1[0][p][P] += w[P] * v2_rho_gamma[P] * s1;
+                    double vs1 = v2_rho_gamma[P] * r1 + v2_gamma_gamma[P] * s1;
+                    for (int k = 1; k < 4; k++) {
+                        v1[k][p][P] = w[P] * (2.0 * vs1 * rho[0][k][P] + 2.0 * v_gamma[P] * rho1[k][p][P]);
+                    }
+                }
+            }
+        } else {
+            double* v2_rho2_aa = vals["V_RHO_A_RHO_A"]->pointer();
+            double* v2_rho2_ab = vals["V_RHO_A_RHO_B"]->pointer();
+            double* v2_rho2_bb = vals["V_RHO_B_RHO_B"]->pointer();
+            double** rho1a[4];
+            double** rho1b[4];
+            double** v1a[4];
+            double** v1b[4];
+            for (int k = 0; k < 4; k++) {
+                rho1a[k] = R_rho1[rank][k]->pointer();
+                rho1b[k] = R_rho1[rank][4 + k]->pointer();
+                v1a[k] = R_v1[rank][k]->pointer();
+                v1b[k] = R_v1[rank][4 + k]->pointer();
+            }
+
+            // GGA kernel, ordered (ρa, ρb, γaa, γab, γbb)
+            double* f2[5][5];
+            double* v_gamma[3];
+            if (gga) {
+                const char* names[5] = {"RHO_A", "RHO_B", "GAMMA_AA", "GAMMA_AB", "GAMMA_BB"};
+                for (int I = 0; I < 5; I++) {
+                    for (int J = I; J < 5; J++) {
+                        f2[I][J] = f2[J][I] =
+                            vals["V_" + std::string(names[I]) + "_" + std::string(names[J])]->pointer();
+                    }
+                }
+                v_gamma[0] = vals["V_GAMMA_AA"]->pointer();
+                v_gamma[1] = vals["V_GAMMA_AB"]->pointer();
+                v_gamma[2] = vals["V_GAMMA_BB"]->pointer();
+            }
+
+            for (int p = 0; p < npert; p++) {
+                for (int P = 0; P < npoints; P++) {
+                    bool skip_a = (rho[0][0][P] < v2_rho_cutoff_);
+                    bool skip_b = (rho[1][0][P] < v2_rho_cutoff_);
+                    double ra1 = rho1a[0][p][P];
+                    double rb1 = rho1b[0][p][P];
+                    if (!gga) {
+                        v1a[0][p][P] = (skip_a ? 0.0 : w[P] * (v2_rho2_aa[P] * ra1 + v2_rho2_ab[P] * rb1));
+                        v1b[0][p][P] = (skip_b ? 0.0 : w[P] * (v2_rho2_ab[P] * ra1 + v2_rho2_bb[P] * rb1));
+                        continue;
+                    }
+
+                    double u1[5] = {ra1, rb1, 0.0, 0.0, 0.0};
+                    for (int k = 1; k < 4; k++) {
+                        u1[2] += 2.0 * rho[0][k][P] * rho1a[k][p][P];
+                        u1[3] += rho1a[k][p][P] * rho[1][k][P] + rho[0][k][P] * rho1b[k][p][P];
+                        u1[4] += 2.0 * rho[1][k][P] * rho1b[k][p][P];
+                    }
+                    double f1[5];
+                    for (int I = 0; I < 5; I++) {
+                        f1[I] = 0.0;
+                        for (int J = 0; J < 5; J++) f1[I] += f2[I][J][P] * u1[J];
+                    }
+
+                    v1a[0][p][P] = (skip_a ? 0.0 : w[P] * f1[0]);
+                    v1b[0][p][P] = (skip_b ? 0.0 : w[P] * f1[1]);
+                    for (int k = 1; k < 4; k++) {
+                        double va = 2.0 * f1[2] * rho[0][k][P] + 2.0 * v_gamma[0][P] * rho1a[k][p][P] +
+                                    f1[3] * rho[1][k][P] + v_gamma[1][P] * rho1b[k][p][P];
+                        double vb = 2.0 * f1[4] * rho[1][k][P] + 2.0 * v_gamma[2][P] * rho1b[k][p][P] +
+                                    f1[3] * rho[0][k][P] + v_gamma[1][P] * rho1a[k][p][P];
+                        v1a[k][p][P] = (skip_a ? 0.0 : w[P] * va);
+                        v1b[k][p][P] = (skip_b ? 0.0 : w[P] * vb);
+                    }
+                }
+            }
+        }
+
+        // => Collocation intermediates, per spin <= //
+        //
+        //   L_x = w (v ɸ_x + Vg·∇ɸ_x),  M_x = w Vg·∇ɸ_x,  G = Vg·∇ɸ
+        //
+        double** L[3];
+        double** M[3];
+        for (int x = 0; x < 3; x++) {
+            L[x] = R_LM[rank][x]->pointer();
+            M[x] = R_LM[rank][3 + x]->pointer();
+        }
+        double** Up = R_LM[rank][6]->pointer();
+        double** Yp = R_LM[rank][7]->pointer();
+        double** Gp = R_LM[rank][8]->pointer();
+        double** Xp[3];
+        for (int x = 0; x < 3; x++) Xp[x] = R_X[rank][x]->pointer();
+        double** Wp = R_X[rank][3]->pointer();
+        double** Hp = (do_hess ? R_H[rank]->pointer() : nullptr);
+
+        for (int s = 0; s < nspin; s++) {
+            double** Dp = pworker->D_scratch()[s]->pointer();
+            double** T0 = R_T[rank][4 * s]->pointer();
+            double* vs = v[s][0];
+            double* vg[3] = {v[s][1], v[s][2], v[s][3]};
+
+            for (int x = 0; x < 3; x++) {
+                for (int P = 0; P < npoints; P++) {
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        double val = 0.0;
+                        if (gga) {
+                            for (int k = 0; k < 3; k++) val += vg[k][P] * phi2[k][x][P][ml];
+                        }
+                        M[x][P][ml] = w[P] * val;
+                        L[x][P][ml] = w[P] * (vs[P] * phi1[x][P][ml] + val);
+                    }
+                }
+            }
+            if (gga) {
+                for (int P = 0; P < npoints; P++) {
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        Gp[P][ml] = w[P] * (vg[0][P] * phi1[0][P][ml] + vg[1][P] * phi1[1][P][ml] +
+                                            vg[2][P] * phi1[2][P][ml]);
+                    }
+                }
+            }
+
+            // => Hessian, second order basis function terms <= //
+            if (do_hess) {
+                // Same center:  2 D_mn ∫ [v ɸ_m,xy ɸ_n + Vg·∇(ɸ_m,xy ɸ_n)]
+                for (int P = 0; P < npoints; P++) {
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        Up[P][ml] = w[P] * vs[P] * phi[P][ml];
+                        if (gga) Up[P][ml] += Gp[P][ml];
+                    }
+                }
+                C_DGEMM('N', 'N', npoints, nlocal, nlocal, Dscale, Up[0], max_functions, Dp[0], max_functions, 0.0,
+                        Yp[0], max_functions);
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int A = atoms[local_atom[ml]];
+                    for (int x = 0; x < 3; x++) {
+                        for (int y = x; y < 3; y++) {
+                            double val = C_DDOT(npoints, &Yp[0][ml], max_functions, &phi2[x][y][0][ml], coll_funcs);
+                            if (gga) {
+                                for (int P = 0; P < npoints; P++) {
+                                    val += w[P] * T0[P][ml] *
+                                           (vg[0][P] * phi3[0][x][y][P][ml] + vg[1][P] * phi3[1][x][y][P][ml] +
+                                            vg[2][P] * phi3[2][x][y][P][ml]);
+                                }
+                            }
+                            Hp[3 * A + x][3 * A + y] += 2.0 * val;
+                            if (x != y) Hp[3 * A + y][3 * A + x] += 2.0 * val;
+                        }
+                    }
+                }
+
+                // Pairs:  2 D_mn ∫ [v ɸ_m,x ɸ_n,y + Vg·∇(ɸ_m,x ɸ_n,y)]
+                for (int x = 0; x < 3; x++) {
+                    for (int y = 0; y < 3; y++) {
+                        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, L[x][0], max_functions, phi1[y][0], coll_funcs,
+                                0.0, Wp[0], max_functions);
+                        if (gga) {
+                            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi1[x][0], coll_funcs, M[y][0],
+                                    max_functions, 1.0, Wp[0], max_functions);
+                        }
+                        for (int ml = 0; ml < nlocal; ml++) {
+                            int A = atoms[local_atom[ml]];
+                            for (int nl = 0; nl < nlocal; nl++) {
+                                int B = atoms[local_atom[nl]];
+                                Hp[3 * A + x][3 * B + y] += 2.0 * Dscale * Dp[ml][nl] * Wp[ml][nl];
+                            }
+                        }
+                    }
+                }
+            }
+
+            // => Fock derivatives <= //
+            if (do_fx) {
+                // Explicit basis function derivative:  X_x = L_x^T ɸ + (w ɸ_x)^T G, rows on the atom of ξ
+                for (int x = 0; x < 3; x++) {
+                    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, L[x][0], max_functions, phi[0], coll_funcs, 0.0,
+                            Xp[x][0], max_functions);
+                    if (gga) {
+                        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi1[x][0], coll_funcs, Gp[0], max_functions,
+                                1.0, Xp[x][0], max_functions);
+                    }
+                }
+
+                double** v1[4];
+                for (int k = 0; k < 4; k++) v1[k] = R_v1[rank][4 * s + k]->pointer();
+
+                for (int p = 0; p < npert; p++) {
+                    int x = p % 3;
+                    int a = p / 3;
+
+                    // Response of the potential:  T = 0.5 w v^ξ ɸ + w Vg^ξ·∇ɸ
+                    for (int P = 0; P < npoints; P++) {
+                        std::fill(Up[P], Up[P] + nlocal, 0.0);
+                        C_DAXPY(nlocal, 0.5 * v1[0][p][P], phi[P], 1, Up[P], 1);
+                        if (!gga) continue;
+                        C_DAXPY(nlocal, v1[1][p][P], phi1[0][P], 1, Up[P], 1);
+                        C_DAXPY(nlocal, v1[2][p][P], phi1[1][P], 1, Up[P], 1);
+                        C_DAXPY(nlocal, v1[3][p][P], phi1[2][P], 1, Up[P], 1);
+                    }
+                    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Up[0], max_functions, 0.0,
+                            Wp[0], max_functions);
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        if (local_atom[ml] != a) continue;
+                        C_DAXPY(nlocal, -1.0, Xp[x][ml], 1, Wp[ml], 1);
+                    }
+
+                    // => Accumulate the result <= //
+                    double** Fxp = Fx[s * 3 * natom + 3 * atoms[a] + x]->pointer();
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        int mg = function_map[ml];
+                        for (int nl = 0; nl < nlocal; nl++) {
+                            int ng = function_map[nl];
+#pragma omp atomic update
+                            Fxp[mg][ng] += Wp[ml][nl] + Wp[nl][ml];
+                        }
+                    }
+                }
+            }
+        }
+
+        // => Hessian, XC kernel terms:  H_ξζ += ∫ w (v^ζ ρ^ξ + Vg^ζ·∇ρ^ξ) <= //
+        if (do_hess) {
+            double** Hlocp = R_Hloc[rank]->pointer();
+            for (int p = 0; p < npert; p++) std::fill(Hlocp[p], Hlocp[p] + npert, 0.0);
+            for (int s = 0; s < nspin; s++) {
+                for (int k = 0; k < (gga ? 4 : 1); k++) {
+                    double** rho1 = R_rho1[rank][4 * s + k]->pointer();
+                    double** v1 = R_v1[rank][4 * s + k]->pointer();
+                    C_DGEMM('N', 'T', npert, npert, npoints, 1.0, rho1[0], max_points, v1[0], max_points, 1.0,
+                            Hlocp[0], max_pert);
+                }
+            }
+            for (int p = 0; p < npert; p++) {
+                int pg = 3 * atoms[p / 3] + p % 3;
+                for (int q = 0; q < npert; q++) {
+                    int qg = 3 * atoms[q / 3] + q % 3;
+                    Hp[pg][qg] += Hlocp[p][q];
+                }
+            }
+        }
+
+        parallel_timer_off("V_xc second derivatives", rank);
+    }
+
+    // Sum up the Hessian
+    if (do_hess) {
+        for (auto const& val : R_H) {
+            H->add(val);
+        }
+        H->hermitivitize();
+    }
+
+    // Reset the workers
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_deriv(old_point_deriv);
+        functional_workers_[i]->set_deriv(old_func_deriv);
+        functional_workers_[i]->allocate();
+    }
+}
+
 SAP::SAP(std::shared_ptr<SuperFunctional> functional, std::shared_ptr<BasisSet> primary, Options& options)
     : VBase(functional, primary, options) {}
 SAP::~SAP() {}
@@ -1103,7 +1650,7 @@ void SAP::initialize() {
         auto point_tmp = std::make_shared<SAPFunctions>(primary_, max_points, max_functions);
         // This is like LDA
         point_tmp->set_ansatz(0);
-        point_tmp->set_cache_map(&cache_map_);
+        point_tmp->set_collocation_cache(collocation_cache_.get());
         point_workers_.push_back(point_tmp);
     }
 
@@ -1254,7 +1801,7 @@ void RV::initialize() {
         // Need a points worker per thread
         auto point_tmp = std::make_shared<RKSFunctions>(primary_, max_points, max_functions);
         point_tmp->set_ansatz(functional_->ansatz());
-        point_tmp->set_cache_map(&cache_map_);
+        point_tmp->set_collocation_cache(collocation_cache_.get());
         point_workers_.push_back(point_tmp);
     }
 }
@@ -1441,227 +1988,12 @@ std::vector<SharedMatrix> RV::compute_fock_derivatives() {
         throw PSIEXCEPTION("DFT Hessian: RKS cannot compute VV10 Fx contribution.");
     }
 
-    // Thread info
-    int rank = 0;
-
-    // What local XC ansatz are we in?
-    int ansatz = functional_->ansatz();
-    if (ansatz >= 1) {
-        throw PSIEXCEPTION("DFT Hessian: RKS does not support GGAs or MGGAs yet");
-    }
-
-    int old_func_deriv = functional_->deriv();
-
-    // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions();
-    int max_points = grid_->max_points();
-
-    // Set pointers to SCF density
-    for (size_t i = 0; i < num_threads_; i++) {
-        point_workers_[i]->set_pointers(D_AO_[0]);
-        point_workers_[i]->set_deriv(1);
+    if (functional_->is_meta()) {
+        throw PSIEXCEPTION("DFT Hessian: RKS does not support MGGAs yet");
     }
 
-    // Per [R]ank quantities
-    std::vector<std::shared_ptr<Vector>> R_rho_x, R_rho_y, R_rho_z;
-    std::vector<SharedMatrix> R_Vx_local;
-    for (size_t i = 0; i < num_threads_; i++) {
-        R_Vx_local.push_back(std::make_shared<Matrix>("Vx Temp", max_functions, max_functions));
+    compute_xc_deriv2(nullptr, Vx);
 
-        functional_workers_[i]->set_deriv(2);
-        functional_workers_[i]->allocate();
-    }
-    // Output quantities
-    std::vector<SharedMatrix> Vx_AO;
-    for (size_t i = 0; i < 3*natoms; i++) {
-        Vx_AO.push_back(std::make_shared<Matrix>("Vx AO Temp", nbf_, nbf_));
-    }
-
-// Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
-// Get thread info
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-
-        // => Setup <= //
-        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
-        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double **Vx_localp = R_Vx_local[rank]->pointer();
-
-        // => Compute blocks <= //
-        double** Tp = pworker->scratch()[0]->pointer();
-
-        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
-        int npoints = block->npoints();
-        double* w = block->w();
-        const std::vector<int>& function_map = block->functions_local_to_global();
-        double** Dp = pworker->D_scratch()[0]->pointer();
-        int nlocal = function_map.size();
-
-        // Compute Rho, Phi, etc
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
-        parallel_timer_off("Properties", rank);
-
-        // Compute functional values
-
-        parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
-        parallel_timer_off("Functional", rank);
-
-        // => Grab quantities <= //
-        // LDA
-        double** phi = pworker->basis_value("PHI")->pointer();
-        double** phi_x = pworker->basis_value("PHI_X")->pointer();
-        double** phi_y = pworker->basis_value("PHI_Y")->pointer();
-        double** phi_z = pworker->basis_value("PHI_Z")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
-        double* v_rho_aa = vals["V_RHO_A_RHO_A"]->pointer();
-        for (int P = 0; P < npoints; P++) {
-            if (std::fabs(rho_a[P]) < v2_rho_cutoff_) {
-                v_rho_a[P] = 0.0;
-                v_rho_aa[P] = 0.0;
-            }
-        }
-        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
-        for(int atom = 0; atom < primary_->molecule()->natom(); ++atom){
-            // Find first and last basis functions on this atom, from the subset of bfs being handled by this block of points
-            auto first_func_iter = std::find_if(function_map.begin(), function_map.end(), [&](int i) {return primary_->function_to_center(i) == atom;});
-            if(first_func_iter == function_map.end()) continue;
-            auto last_func_riter = std::find_if(function_map.rbegin(), function_map.rend(), [&](int i) {return primary_->function_to_center(i) == atom;});
-            if(last_func_riter == function_map.rend()) continue;
-            auto last_func_iter = last_func_riter.base(); // convert to forward iterator
-
-            int first_func_addr = std::distance(function_map.begin(), first_func_iter);
-            int nfuncs = std::distance(first_func_iter, last_func_iter);
-
-            /*
-             * X derivatives
-             */
-            // T = ɸ D, remembering that only the bfs centered on the current atom of interest contribute to the derivative
-            C_DGEMM('N', 'N', npoints, nfuncs, nlocal, 1.0, phi[0], coll_funcs, &Dp[0][first_func_addr], max_functions, 0.0, Tp[0], max_functions);
-            for (int P = 0; P < npoints; P++) {
-                // ρ_x  = T ɸ_x^t
-                double rho_xP = C_DDOT(nfuncs, Tp[P], 1, &phi_x[P][first_func_addr], 1);
-                // Now redefine the intermediate T:
-                //
-                //       /  | ∂^2 F
-                // T <- | ɸ | ----- ρ_x
-                //       \  | ∂ ρ^2
-                std::fill(Tp[P], Tp[P] + nlocal, 0);
-                C_DAXPY(nlocal, -v_rho_aa[P] * w[P] * rho_xP, phi[P], 1, Tp[P], 1);
-                //
-                //       /    | ∂ F
-                // T <- | ɸ_x | ---
-                //       \    | ∂ ρ
-                C_DAXPY(nfuncs, -0.5 * v_rho_a[P] * w[P], &phi_x[P][first_func_addr], 1, &Tp[P][first_func_addr], 1);
-            }
-            //         |  \
-            // Vx <- T | ɸ |
-            //         |  /
-            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], max_functions, phi[0], coll_funcs, 0.0, Vx_localp[0], max_functions);
-            // => Accumulate the result <= //
-            double **Vxp = Vx[3*atom + 0]->pointer();
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < nlocal; nl++) {
-                    int ng = function_map[nl];
-                    double result = Vx_localp[ml][nl] + Vx_localp[nl][ml];
-#pragma omp atomic update
-                     Vxp[mg][ng] += result;
-#pragma omp atomic update
-                     Vxp[ng][mg] += result;
-                }
-            }
-
-            /*
-             * Y derivatives
-             */
-            // T = ɸ D, remembering that only the bfs centered on the current atom of interest contribute to the derivative
-            C_DGEMM('N', 'N', npoints, nfuncs, nlocal, 1.0, phi[0], coll_funcs, &Dp[0][first_func_addr], max_functions, 0.0, Tp[0], max_functions);
-            for (int P = 0; P < npoints; P++) {
-                // ρ_y  = T ɸ_y^t
-                double rho_yP = C_DDOT(nfuncs, Tp[P], 1, &phi_y[P][first_func_addr], 1);
-                // Now redefine the intermediate T:
-                //
-                //       /  | ∂^2 F
-                // T <- | ɸ | ----- ρ_y
-                //       \  | ∂ ρ^2
-                std::fill(Tp[P], Tp[P] + nlocal, 0);
-                C_DAXPY(nlocal, -v_rho_aa[P] * w[P] * rho_yP, phi[P], 1, Tp[P], 1);
-                //
-                //       /    | ∂ F
-                // T <- | ɸ_y | ---
-                //       \    | ∂ ρ
-                C_DAXPY(nfuncs, -0.5*v_rho_a[P] * w[P], &phi_y[P][first_func_addr], 1, &Tp[P][first_func_addr], 1);
-            }
-            //         |  \
-            // Vx <- T | ɸ |
-            //         |  /
-            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], max_functions, phi[0], coll_funcs, 0.0, Vx_localp[0], max_functions);
-            // => Accumulate the result <= //
-            double **Vyp = Vx[3*atom + 1]->pointer();
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < nlocal; nl++) {
-                    int ng = function_map[nl];
-                    double result = Vx_localp[ml][nl] + Vx_localp[nl][ml];
-#pragma omp atomic update
-                     Vyp[mg][ng] += result;
-#pragma omp atomic update
-                     Vyp[ng][mg] += result;
-                }
-            }
-
-            /*
-             * Z derivatives
-             */
-            // T = ɸ D, remembering that only the bfs centered on the current atom of interest contribute to the derivative
-            C_DGEMM('N', 'N', npoints, nfuncs, nlocal, 1.0, phi[0], coll_funcs, &Dp[0][first_func_addr], max_functions, 0.0, Tp[0], max_functions);
-            for (int P = 0; P < npoints; P++) {
-                // ρ_z  = T ɸ_z^t
-                double rho_zP = C_DDOT(nfuncs, Tp[P], 1, &phi_z[P][first_func_addr], 1);
-                // Now redefine the intermediate T:
-                //
-                //       /  | ∂^2 F
-                // T <- | ɸ | ----- ρ_z
-                //       \  | ∂ ρ^2
-                std::fill(Tp[P], Tp[P] + nlocal, 0);
-                C_DAXPY(nlocal, -v_rho_aa[P] * w[P] * rho_zP, phi[P], 1, Tp[P], 1);
-                //
-                //       /    | ∂ F
-                // T <- | ɸ_z | ---
-                //       \    | ∂ ρ
-                C_DAXPY(nfuncs, -0.5*v_rho_a[P] * w[P], &phi_z[P][first_func_addr], 1, &Tp[P][first_func_addr], 1);
-            }
-            //         |  \
-            // Vx <- T | ɸ |
-            //         |  /
-            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], max_functions, phi[0], coll_funcs, 0.0, Vx_localp[0], max_functions);
-            // => Accumulate the result <= //
-            double **Vzp = Vx[3*atom + 2]->pointer();
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < nlocal; nl++) {
-                    int ng = function_map[nl];
-                    double result = Vx_localp[ml][nl] + Vx_localp[nl][ml];
-#pragma omp atomic update
-                     Vzp[mg][ng] += result;
-#pragma omp atomic update
-                     Vzp[ng][mg] += result;
-                }
-            }
-        }
-    }
-
-    // Reset the workers
-    for (size_t i = 0; i < num_threads_; i++) {
-        functional_workers_[i]->set_deriv(old_func_deriv);
-        functional_workers_[i]->allocate();
-    }
     timer_off("RV: Form Fx");
     return Vx;
 }
@@ -2051,8 +2383,8 @@ SharedMatrix RV::compute_gradient() {
 }
 
 SharedMatrix RV::compute_hessian() {
-    if (functional_->is_gga() || functional_->is_meta())
-        throw PSIEXCEPTION("Hessians for GGA and meta GGA functionals are not yet implemented.");
+    if (functional_->is_meta())
+        throw PSIEXCEPTION("Hessians for meta GGA functionals are not yet implemented.");
 
     if ((D_AO_.size() != 1)) throw PSIEXCEPTION("V: RKS should have only one D Matrix");
 
@@ -2060,325 +2392,14 @@ SharedMatrix RV::compute_hessian() {
         throw PSIEXCEPTION("V: RKS cannot compute VV10 Hessian contribution.");
     }
 
-    // Build the target Hessian Matrix
+    timer_on("RV: Form Hessian");
+
     int natom = primary_->molecule()->natom();
     auto H = std::make_shared<Matrix>("XC Hessian", 3 * natom, 3 * natom);
-    double** Hp = H->pointer();
-
-    // Thread info
-    int rank = 0;
-
-    // Set Hessian derivative level in properties
-    int old_deriv = point_workers_[0]->deriv();
-    int old_func_deriv = functional_->deriv();
-
-    // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions();
-    int max_points = grid_->max_points();
-
-    int derivlev = (functional_->is_gga() || functional_->is_meta()) ? 3 : 2;
-    functional_->set_deriv(derivlev);
-
-    // Setup the pointers
-    for (size_t i = 0; i < num_threads_; i++) {
-        point_workers_[i]->set_pointers(D_AO_[0]);
-        point_workers_[i]->set_deriv(derivlev);
-        functional_workers_[i]->set_deriv(derivlev);
-        functional_workers_[i]->allocate();
-    }
-
-    // Per thread temporaries
-    std::vector<SharedMatrix> V_local;
-    std::vector<std::shared_ptr<Vector>> Q_temp;
-    for (size_t i = 0; i < num_threads_; i++) {
-        V_local.push_back(std::make_shared<Matrix>("V Temp", max_functions, max_functions));
-        Q_temp.push_back(std::make_shared<Vector>("Quadrature Tempt", max_points));
-    }
-
-    auto QT = std::make_shared<Vector>("Quadrature Temp", max_points);
-    double* QTp = QT->pointer();
-    const std::vector<std::shared_ptr<BlockOPoints>>& blocks = grid_->blocks();
-
-    for (size_t Q = 0; Q < blocks.size(); Q++) {
-// Get thread info
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-
-        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
-        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double** V2p = V_local[rank]->pointer();
-        double* QTp = Q_temp[rank]->pointer();
-        double** Dp = pworker->D_scratch()[0]->pointer();
-        SharedMatrix tmpHXX = pworker->D_scratch()[0]->clone();
-        SharedMatrix tmpHXY = pworker->D_scratch()[0]->clone();
-        SharedMatrix tmpHXZ = pworker->D_scratch()[0]->clone();
-        SharedMatrix tmpHYX = pworker->D_scratch()[0]->clone();
-        SharedMatrix tmpHYY = pworker->D_scratch()[0]->clone();
-        SharedMatrix tmpHYZ = pworker->D_scratch()[0]->clone();
-        SharedMatrix tmpHZX = pworker->D_scratch()[0]->clone();
-        SharedMatrix tmpHZY = pworker->D_scratch()[0]->clone();
-        SharedMatrix tmpHZZ = pworker->D_scratch()[0]->clone();
-        double **pHXX = tmpHXX->pointer();
-        double **pHXY = tmpHXY->pointer();
-        double **pHXZ = tmpHXZ->pointer();
-        double **pHYX = tmpHYX->pointer();
-        double **pHYY = tmpHYY->pointer();
-        double **pHYZ = tmpHYZ->pointer();
-        double **pHZX = tmpHZX->pointer();
-        double **pHZY = tmpHZY->pointer();
-        double **pHZZ = tmpHZZ->pointer();
-
-        // Scratch
-        double** Tp = pworker->scratch()[0]->pointer();
-        SharedMatrix U_local(pworker->scratch()[0]->clone());
-        double** Up = U_local->pointer();
-
-        // ACS TODO: these need to be threaded eventually, to fit in with the new infrastructure
-        auto Tmpx = std::make_shared<Vector>("Tx", max_functions);
-        auto Tmpy = std::make_shared<Vector>("Ty", max_functions);
-        auto Tmpz = std::make_shared<Vector>("Tz", max_functions);
-        double* pTx = Tmpx->pointer();
-        double* pTy = Tmpy->pointer();
-        double* pTz = Tmpz->pointer();
-        SharedMatrix Tx(U_local->clone());
-        SharedMatrix Ty(U_local->clone());
-        SharedMatrix Tz(U_local->clone());
-        SharedMatrix T2(U_local->clone());
-        double** pTx2 = Tx->pointer();
-        double** pTy2 = Ty->pointer();
-        double** pTz2 = Tz->pointer();
-        double** pT2 = T2->pointer();
-
-        std::shared_ptr<BlockOPoints> block = blocks[Q];
-        int npoints = block->npoints();
-        double* x = block->x();
-        double* y = block->y();
-        double* z = block->z();
-        double* w = block->w();
-        const std::vector<int>& function_map = block->functions_local_to_global();
-        int nlocal = function_map.size();
-
-        pworker->compute_points(block);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
-
-        double** phi = pworker->basis_value("PHI")->pointer();
-        double** phi_x = pworker->basis_value("PHI_X")->pointer();
-        double** phi_y = pworker->basis_value("PHI_Y")->pointer();
-        double** phi_z = pworker->basis_value("PHI_Z")->pointer();
-        double** phi_xx = pworker->basis_value("PHI_XX")->pointer();
-        double** phi_xy = pworker->basis_value("PHI_XY")->pointer();
-        double** phi_xz = pworker->basis_value("PHI_XZ")->pointer();
-        double** phi_yy = pworker->basis_value("PHI_YY")->pointer();
-        double** phi_yz = pworker->basis_value("PHI_YZ")->pointer();
-        double** phi_zz = pworker->basis_value("PHI_ZZ")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
-        double* v_rho_aa = vals["V_RHO_A_RHO_A"]->pointer();
-        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
-
-        // => LSDA Contribution <= //
-
-        for (int ml = 0; ml < nlocal; ml++) {
-            std::fill(pHXX[ml], pHXX[ml] + nlocal, 0);
-            std::fill(pHXY[ml], pHXY[ml] + nlocal, 0);
-            std::fill(pHXZ[ml], pHXZ[ml] + nlocal, 0);
-            std::fill(pHYX[ml], pHYX[ml] + nlocal, 0);
-            std::fill(pHYY[ml], pHYY[ml] + nlocal, 0);
-            std::fill(pHYZ[ml], pHYZ[ml] + nlocal, 0);
-            std::fill(pHZX[ml], pHZX[ml] + nlocal, 0);
-            std::fill(pHZY[ml], pHZY[ml] + nlocal, 0);
-            std::fill(pHZZ[ml], pHZZ[ml] + nlocal, 0);
-        }
-
-        /*
-         *                        mn  ∂ F
-         *  H_mn <- 2 D_ab ɸ_a ɸ_b    ---
-         *                            ∂ ρ
-         */
-        // T = ɸ D
-        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dp[0], max_functions, 0.0, Tp[0],
-                max_functions);
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            if (std::fabs(rho_a[P]) > v2_rho_cutoff_) {
-                C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], Tp[P], 1, Up[P], 1);
-            }
-        }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            double Txx = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xx[0][ml], coll_funcs);
-            double Txy = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xy[0][ml], coll_funcs);
-            double Txz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xz[0][ml], coll_funcs);
-            double Tyy = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_yy[0][ml], coll_funcs);
-            double Tyz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_yz[0][ml], coll_funcs);
-            double Tzz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_zz[0][ml], coll_funcs);
-            Hp[3 * A + 0][3 * A + 0] += Txx;
-            Hp[3 * A + 0][3 * A + 1] += Txy;
-            Hp[3 * A + 0][3 * A + 2] += Txz;
-            Hp[3 * A + 1][3 * A + 0] += Txy;
-            Hp[3 * A + 1][3 * A + 1] += Tyy;
-            Hp[3 * A + 1][3 * A + 2] += Tyz;
-            Hp[3 * A + 2][3 * A + 0] += Txz;
-            Hp[3 * A + 2][3 * A + 1] += Tyz;
-            Hp[3 * A + 2][3 * A + 2] += Tzz;
-        }
-
-        /*
-         *                        m             n  ∂^2 F
-         *  H_mn <- 4 D_ab ɸ_a ɸ_b  D_cd ɸ_c ɸ_d   ------
-         *                                         ∂ ρ^2
-         *  RHF prefactor gets multiplied by 4 to account for occupancy in both densities.
-         *  A factor of two is applied at the end, so just double this contribution.
-         */
-
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            if (std::fabs(rho_a[P]) > v2_rho_cutoff_) {
-                C_DAXPY(nlocal, 8.0 * w[P] * v_rho_aa[P], Tp[P], 1, Up[P], 1);
-            }
-        }
-        for (int P = 0; P < npoints; P++) {
-            for (int ml = 0; ml < nlocal; ml++) {
-                pTx2[P][ml] = Tp[P][ml] * phi_x[P][ml];
-                pTy2[P][ml] = Tp[P][ml] * phi_y[P][ml];
-                pTz2[P][ml] = Tp[P][ml] * phi_z[P][ml];
-            }
-        }
-
-        // x derivatives
-        for (int P = 0; P < npoints; P++) {
-            for (int ml = 0; ml < nlocal; ml++) {
-                Tp[P][ml] = Up[P][ml] * phi_x[P][ml];
-            }
-        }
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTx2[0], max_functions, 1.0, pHXX[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTy2[0], max_functions, 1.0, pHXY[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTz2[0], max_functions, 1.0, pHXZ[0], max_functions);
-
-        // y derivatives
-        for (int P = 0; P < npoints; P++) {
-            for (int ml = 0; ml < nlocal; ml++) {
-                Tp[P][ml] = Up[P][ml] * phi_y[P][ml];
-            }
-        }
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTx2[0], max_functions, 1.0, pHYX[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTy2[0], max_functions, 1.0, pHYY[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTz2[0], max_functions, 1.0, pHYZ[0], max_functions);
-
-        // z derivatives
-        for (int P = 0; P < npoints; P++) {
-            for (int ml = 0; ml < nlocal; ml++) {
-                Tp[P][ml] = Up[P][ml] * phi_z[P][ml];
-            }
-        }
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTx2[0], max_functions, 1.0, pHZX[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTy2[0], max_functions, 1.0, pHZY[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], coll_funcs, pTz2[0], max_functions, 1.0, pHZZ[0], max_functions);
-
-        /*
-         *                    m    n  ∂ F
-         *  H_mn <- 2 D_ab ɸ_a  ɸ_b   ---
-         *                            ∂ ρ
-         */
-        // x derivatives
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            if (std::fabs(rho_a[P]) > v2_rho_cutoff_) {
-                C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], phi_x[P], 1, Up[P], 1);
-            }
-        }
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_x[0], coll_funcs, Up[0], max_functions, 0.0, pTx2[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_y[0], coll_funcs, Up[0], max_functions, 0.0, pTy2[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_z[0], coll_funcs, Up[0], max_functions, 0.0, pTz2[0], max_functions);
-        for (int ml = 0; ml < nlocal; ml++) {
-            for (int nl = 0; nl < nlocal; nl++) {
-                double D = Dp[ml][nl];
-                pHXX[ml][nl] += pTx2[ml][nl] * D;
-                pHYX[ml][nl] += pTy2[ml][nl] * D;
-                pHZX[ml][nl] += pTz2[ml][nl] * D;
-            }
-        }
-
-        // y derivatives
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            if (std::fabs(rho_a[P]) > v2_rho_cutoff_) {
-                C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], phi_y[P], 1, Up[P], 1);
-            }
-        }
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_x[0], coll_funcs, Up[0], max_functions, 0.0, pTx2[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_y[0], coll_funcs, Up[0], max_functions, 0.0, pTy2[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_z[0], coll_funcs, Up[0], max_functions, 0.0, pTz2[0], max_functions);
-        for (int ml = 0; ml < nlocal; ml++) {
-            for (int nl = 0; nl < nlocal; nl++) {
-                double D = Dp[ml][nl];
-                pHXY[ml][nl] += pTx2[ml][nl] * D;
-                pHYY[ml][nl] += pTy2[ml][nl] * D;
-                pHZY[ml][nl] += pTz2[ml][nl] * D;
-            }
-        }
-
-        // z derivatives
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            if (std::fabs(rho_a[P]) > v2_rho_cutoff_) {
-                C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], phi_z[P], 1, Up[P], 1);
-            }
-        }
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_x[0], coll_funcs, Up[0], max_functions, 0.0, pTx2[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_y[0], coll_funcs, Up[0], max_functions, 0.0, pTy2[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_z[0], coll_funcs, Up[0], max_functions, 0.0, pTz2[0], max_functions);
-        for (int ml = 0; ml < nlocal; ml++) {
-            for (int nl = 0; nl < nlocal; nl++) {
-                double D = Dp[ml][nl];
-                pHXZ[ml][nl] += pTx2[ml][nl] * D;
-                pHYZ[ml][nl] += pTy2[ml][nl] * D;
-                pHZZ[ml][nl] += pTz2[ml][nl] * D;
-            }
-        }
-
-        // Accumulate contributions to the full Hessian: N.B. these terms are not symmetric!
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            for (int nl = 0; nl < nlocal; nl++) {
-                int B = primary_->function_to_center(function_map[nl]);
-                Hp[3 * A + 0][3 * B + 0] += pHXX[ml][nl];
-                Hp[3 * A + 1][3 * B + 0] += pHYX[ml][nl];
-                Hp[3 * A + 2][3 * B + 0] += pHZX[ml][nl];
-                Hp[3 * A + 0][3 * B + 1] += pHXY[ml][nl];
-                Hp[3 * A + 1][3 * B + 1] += pHYY[ml][nl];
-                Hp[3 * A + 2][3 * B + 1] += pHZY[ml][nl];
-                Hp[3 * A + 0][3 * B + 2] += pHXZ[ml][nl];
-                Hp[3 * A + 1][3 * B + 2] += pHYZ[ml][nl];
-                Hp[3 * A + 2][3 * B + 2] += pHZZ[ml][nl];
-            }
-        }
-    }
-
-
-
-    if (debug_) {
-        outfile->Printf("   => XC Hessian: Numerical Integrals <=\n\n");
-        outfile->Printf("    Functional Value:  %24.16E\n", quad_values_["FUNCTIONAL"]);
-        outfile->Printf("    <\\rho_a>        :  %24.16E\n", quad_values_["RHO_A"]);
-        outfile->Printf("    <\\rho_b>        :  %24.16E\n", quad_values_["RHO_B"]);
-        outfile->Printf("    <\\vec r\\rho_a>  : <%24.16E,%24.16E,%24.16E>\n", quad_values_["RHO_AX"],
-                        quad_values_["RHO_AY"], quad_values_["RHO_AZ"]);
-        outfile->Printf("    <\\vec r\\rho_b>  : <%24.16E,%24.16E,%24.16E>\n\n", quad_values_["RHO_BX"],
-                        quad_values_["RHO_BY"], quad_values_["RHO_BZ"]);
-    }
-
-    for (size_t i = 0; i < num_threads_; i++) {
-        point_workers_[i]->set_deriv(old_deriv);
-    }
-    functional_->set_deriv(old_func_deriv);
-
-    // RKS
-    H->scale(2.0);
-    H->hermitivitize();
-//    H->print_out();
+    std::vector<SharedMatrix> no_Fx;
+    compute_xc_deriv2(H, no_Fx);
 
+    timer_off("RV: Form Hessian");
     return H;
 }
 
@@ -2393,7 +2414,7 @@ void UV::initialize() {
         // Need a points worker per thread
         std::shared_ptr<PointFunctions> point_tmp = std::make_shared<UKSFunctions>(primary_, max_points, max_functions);
         point_tmp->set_ansatz(functional_->ansatz());
-        point_tmp->set_cache_map(&cache_map_);
+        point_tmp->set_collocation_cache(collocation_cache_.get());
         point_workers_.push_back(point_tmp);
     }
 }
@@ -2879,9 +2900,9 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
             rho_bk_y = R_rho_bk_y[rank]->pointer();
             rho_bk_z = R_rho_bk_z[rank]->pointer();
             gamma_bbk = R_gamma_bk[rank]->pointer();
-            rho_bx = pworker->point_value("RHO_AX")->pointer();
-            rho_by = pworker->point_value("RHO_AY")->pointer();
-            rho_bz = pworker->point_value("RHO_AZ")->pointer();
+            rho_bx = pworker->point_value("RHO_BX")->pointer();
+            rho_by = pworker->point_value("RHO_BY")->pointer();
+            rho_bz = pworker->point_value("RHO_BZ")->pointer();
 
             gamma_abk = R_gamma_abk[rank]->pointer();
         }
@@ -2942,7 +2963,7 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
                     rho_bk_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tbp[P], 1);
                     gamma_bbk[P] = rho_bk_x[P] * rho_bx[P];
                     gamma_bbk[P] += rho_bk_y[P] * rho_by[P];
-                    gamma_bbk[P] += rho_ak_z[P] * rho_bz[P];
+                    gamma_bbk[P] += rho_bk_z[P] * rho_bz[P];
                     gamma_bbk[P] *= 2.0;
 
                     // Alpha-Beta
@@ -3518,4 +3539,52 @@ SharedMatrix UV::compute_gradient() {
 
     return G;
 }
+
+std::vector<SharedMatrix> UV::compute_fock_derivatives() {
+    timer_on("UV: Form Fx");
+
+    int natoms = primary_->molecule()->natom();
+    std::vector<SharedMatrix> Vx(6 * natoms);
+    for (int n = 0; n < 3 * natoms; ++n) {
+        Vx[n] = std::make_shared<Matrix>("Vax for Perturbation " + std::to_string(n), nbf_, nbf_);
+        Vx[3 * natoms + n] = std::make_shared<Matrix>("Vbx for Perturbation " + std::to_string(n), nbf_, nbf_);
+    }
+    if (D_AO_.size() != 2) {
+        throw PSIEXCEPTION("DFT Hessian: UKS should have two D matrices.");
+    }
+
+    if (functional_->needs_vv10()) {
+        throw PSIEXCEPTION("DFT Hessian: UKS cannot compute VV10 Fx contribution.");
+    }
+
+    if (functional_->is_meta()) {
+        throw PSIEXCEPTION("DFT Hessian: UKS does not support MGGAs yet");
+    }
+
+    compute_xc_deriv2(nullptr, Vx);
+
+    timer_off("UV: Form Fx");
+    return Vx;
+}
+
+SharedMatrix UV::compute_hessian() {
+    if (functional_->is_meta())
+        throw PSIEXCEPTION("Hessians for meta GGA functionals are not yet implemented.");
+
+    if (D_AO_.size() != 2) throw PSIEXCEPTION("V: UKS should have two D matrices.");
+
+    if (functional_->needs_vv10()) {
+        throw PSIEXCEPTION("V: UKS cannot compute VV10 Hessian contribution.");
+    }
+
+    timer_on("UV: Form Hessian");
+
+    int natom = primary_->molecule()->natom();
+    auto H = std::make_shared<Matrix>("XC Hessian", 3 * natom, 3 * natom);
+    std::vector<SharedMatrix> no_Fx;
+    compute_xc_deriv2(H, no_Fx);
+
+    timer_off("UV: Form Hessian");
+    return H;
+}
 }  // namespace psi
@@ -42,6 +42,7 @@ class DFTGrid;
 class PointFunctions;
 class SuperFunctional;
 class BlockOPoints;
+class CollocationCache;
 
 // => BASE CLASS <= //
 
@@ -66,6 +67,8 @@ class PSI_API VBase {
     double v2_rho_cutoff_;
     /// VV10 interior kernel threshold
     double vv10_rho_cutoff_;
+    /// VV10 screening threshold for distant tiles of NL points
+    double vv10_kernel_cutoff_;
     /// Options object, used to build grid
     Options& options_;
     /// Basis set used in the integration
@@ -81,8 +84,7 @@ class PSI_API VBase {
     /// Quadrature values obtained during integration
     std::map<std::string, double> quad_values_;
     // Caches collocation grids
-    std::unordered_map<size_t, std::map<std::string, SharedMatrix>> cache_map_;
-    int cache_map_deriv_;
+    std::shared_ptr<CollocationCache> collocation_cache_;
 
     /// AO2USO matrix (if not C1)
     SharedMatrix AO2USO_;
@@ -101,6 +103,11 @@ class PSI_API VBase {
     double vv10_nlc(SharedMatrix D, SharedMatrix ret);
     SharedMatrix vv10_nlc_gradient(SharedMatrix D);
 
+    /// XC second derivatives w.r.t. nuclear displacements for LSDA/GGA, shared by RV and UV.
+    /// Accumulates the XC Hessian into H (if not null) and the skeleton Fock derivatives into
+    /// Fx (if not empty), ordered [spin][3 * atom + xyz]
+    void compute_xc_deriv2(SharedMatrix H, std::vector<SharedMatrix>& Fx);
+
     /// Set things up
     void common_init();
 
@@ -120,9 +127,9 @@ class PSI_API VBase {
     size_t nblocks();
     std::map<std::string, double>& quadrature_values() { return quad_values_; }
 
-    // Creates a collocation cache map based on stride
+    // Caches the collocation of the costliest blocks in memory doubles
     void build_collocation_cache(size_t memory);
-    void clear_collocation_cache() { cache_map_.clear(); }
+    void clear_collocation_cache();
 
     // Set the D matrix, get it back if needed
     void set_D(std::vector<SharedMatrix> Dvec);
@@ -190,7 +197,10 @@ class UV : public VBase {
 
     void compute_V(std::vector<SharedMatrix> ret) override;
     void compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret) override;
+    /// Returns the 3N alpha Fock derivatives followed by the 3N beta ones
+    std::vector<SharedMatrix> compute_fock_derivatives() override;
     SharedMatrix compute_gradient() override;
+    SharedMatrix compute_hessian() override;
 
     void print_header() const override;
 };
@@ -38,8 +38,10 @@
 #include "functional.h"
 #include "LibXCfunctional.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 
 // using namespace psi;
 
@@ -818,7 +820,8 @@ std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const st
 }
 double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVector>& vals,
                                             const std::vector<std::map<std::string, SharedVector>>& vv10_cache,
-                                            std::shared_ptr<BlockOPoints> block, int npoints, bool do_grad) {
+                                            std::shared_ptr<BlockOPoints> block, int npoints, bool do_grad,
+                                            double kernel_thresh) {
     // Kernel between left (*this) and right (vv10_cache) grids
 
     // Compute the vv10 cache in place
@@ -850,6 +853,12 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
     const double* l_W0 = vv_values_["W0"]->pointer();
     const double* l_kappa = vv_values_["KAPPA"]->pointer();
 
+    // => Active left points and their bounding sphere <= //
+    std::vector<size_t> l_active;
+    l_active.reserve(l_npoints);
+    double l_xc = 0.0, l_yc = 0.0, l_zc = 0.0;
+    double l_W0_min = std::numeric_limits<double>::max();
+    double l_kappa_min = std::numeric_limits<double>::max();
     for (size_t i = 0; i < l_npoints; i++) {
         // Add Phi agnostic quantities
         vv10_e += l_w[i] * l_rho[i] * vv10_beta;
@@ -857,28 +866,90 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
         v_gamma[i] = 0.0;
 
         if (l_rho[i] < l_thresh) continue;
+        l_active.push_back(i);
+        l_xc += l_x[i];
+        l_yc += l_y[i];
+        l_zc += l_z[i];
+        l_W0_min = std::min(l_W0_min, l_W0[i]);
+        l_kappa_min = std::min(l_kappa_min, l_kappa[i]);
+    }
+    const size_t l_nactive = l_active.size();
+    if (l_nactive == 0) return vv10_e;
+
+    l_xc /= l_nactive;
+    l_yc /= l_nactive;
+    l_zc /= l_nactive;
+    double l_R = 0.0;
+    for (size_t i : l_active) {
+        const double d_x = l_x[i] - l_xc;
+        const double d_y = l_y[i] - l_yc;
+        const double d_z = l_z[i] - l_zc;
+        l_R = std::max(l_R, std::sqrt(d_x * d_x + d_y * d_y + d_z * d_z));
+    }
+
+    // => Screen the right tiles against the left block <= //
+    // For R >= Rmin, g >= W0min Rmin^2 + kappamin on either side, so the dropped contributions to phi,
+    // U and W of each left point are bounded by phi_b, 2 phi_b / g_l and 2 phi_b / W0_l, respectively.
+    std::vector<size_t> r_tiles;
+    r_tiles.reserve(vv10_cache.size());
+    for (size_t tile = 0; tile < vv10_cache.size(); tile++) {
+        auto bounds_it = vv10_cache[tile].find("BOUNDS");
+        if (kernel_thresh <= 0.0 || bounds_it == vv10_cache[tile].end() || l_W0_min <= 0.0) {
+            r_tiles.push_back(tile);
+            continue;
+        }
+        const double* bounds = bounds_it->second->pointer();
+        const double d_x = l_xc - bounds[0];
+        const double d_y = l_yc - bounds[1];
+        const double d_z = l_zc - bounds[2];
+        const double Rmin = std::sqrt(d_x * d_x + d_y * d_y + d_z * d_z) - l_R - bounds[3];
+        if (Rmin <= 0.0) {
+            r_tiles.push_back(tile);
+            continue;
+        }
+        const double R2 = Rmin * Rmin;
+        const double g_l = l_W0_min * R2 + l_kappa_min;
+        const double g_r = bounds[4] * R2 + bounds[5];
+        const double phi_b = 1.5 * bounds[6] / (g_l * g_r * (g_l + g_r));
+        const double scale = std::max(1.0, std::max(2.0 / g_l, 2.0 / l_W0_min));
+        if (phi_b * scale >= kernel_thresh) r_tiles.push_back(tile);
+    }
+
+    // => Interior kernel, one cache-resident right tile at a time <= //
+    std::vector<double> phi_acc(l_nactive, 0.0);
+    std::vector<double> U_acc(l_nactive, 0.0);
+    std::vector<double> W_acc(l_nactive, 0.0);
+    std::vector<double> xc_acc, yc_acc, zc_acc;
+    if (do_grad) {
+        xc_acc.assign(l_nactive, 0.0);
+        yc_acc.assign(l_nactive, 0.0);
+        zc_acc.assign(l_nactive, 0.0);
+    }
+
+    for (size_t tile : r_tiles) {
+        const auto& r_block = vv10_cache[tile];
+
+        // Get right points
+        const double* r_x = r_block.at("X")->pointer();
+        const double* r_y = r_block.at("Y")->pointer();
+        const double* r_z = r_block.at("Z")->pointer();
+        const double* r_w = r_block.at("W")->pointer();
+        const double* r_rho = r_block.at("RHO")->pointer();
+        const double* r_W0 = r_block.at("W0")->pointer();
+        const double* r_kappa = r_block.at("KAPPA")->pointer();
+
+        const size_t r_npoints = r_block.at("KAPPA")->dimpi()[0];
+
+        for (size_t li = 0; li < l_nactive; li++) {
+            const size_t i = l_active[li];
+            double phi = 0.0;
+            double U = 0.0;
+            double W = 0.0;
 
-        // Compute interior kernel
-        double phi = 0.0;
-        double U = 0.0;
-        double W = 0.0;
-        double xc = 0.0;
-        double yc = 0.0;
-        double zc = 0.0;
-        for (auto r_block : vv10_cache) {
-            // Get right points
-            const double* r_x = r_block["X"]->pointer();
-            const double* r_y = r_block["Y"]->pointer();
-            const double* r_z = r_block["Z"]->pointer();
-            const double* r_w = r_block["W"]->pointer();
-            const double* r_rho = r_block["RHO"]->pointer();
-            const double* r_W0 = r_block["W0"]->pointer();
-            const double* r_kappa = r_block["KAPPA"]->pointer();
-
-            const size_t r_npoints = r_block["KAPPA"]->dimpi()[0];
-
-            // Interior Kernel
             if (do_grad) {
+                double xc = 0.0;
+                double yc = 0.0;
+                double zc = 0.0;
 #pragma omp simd reduction(+ : phi, U, W, xc, yc, zc)
                 for (size_t j = 0; j < r_npoints; j++) {
                     // Distance between grid points
@@ -895,7 +966,6 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
                     // Sum the kernel
                     const double phi_kernel = (-1.5 * r_w[j] * r_rho[j]) / (g * gp * gs);
 
-                    // Dumb question, does FMA do subtraction?
                     phi += phi_kernel;
                     const double tmp_U = -1.0 * phi_kernel * ((1.0 / g) + (1.0 / gs));
                     U += tmp_U;
@@ -907,6 +977,9 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
                     yc += Q * d_y;
                     zc += Q * d_z;
                 }
+                xc_acc[li] += xc;
+                yc_acc[li] += yc;
+                zc_acc[li] += zc;
 
             } else {
 #pragma omp simd reduction(+ : phi, U, W)
@@ -925,15 +998,24 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
                     // Sum the kernel
                     const double phi_kernel = (-1.5 * r_w[j] * r_rho[j]) / (g * gp * gs);
 
-                    // Dumb question, does FMA do subtraction?
                     phi += phi_kernel;
                     const double tmp_U = -1.0 * phi_kernel * ((1.0 / g) + (1.0 / gs));
                     U += tmp_U;
                     W += tmp_U * R2;
                 }
             }
+            phi_acc[li] += phi;
+            U_acc[li] += U;
+            W_acc[li] += W;
+        }
+    }  // End r tiles
+
+    for (size_t li = 0; li < l_nactive; li++) {
+        const size_t i = l_active[li];
+        const double phi = phi_acc[li];
+        const double U = U_acc[li];
+        const double W = W_acc[li];
 
-        }  // End r blocks
         // Mathematica for the win
         const double kappa_dn = l_kappa[i] / (6.0 * l_rho[i]);
         const double w0_dgamma = vv10_c_ * l_gamma[i] / (l_W0[i] * std::pow(l_rho[i], 4.0));
@@ -945,13 +1027,12 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
         v_rho[i] += phi + l_rho[i] * (kappa_dn * U + w0_drho * W);
         v_gamma[i] += l_rho[i] * w0_dgamma * W;
         if (do_grad) {
-            x_grid[i] += l_rho[i] * l_w[i] * xc;
-            y_grid[i] += l_rho[i] * l_w[i] * yc;
-            z_grid[i] += l_rho[i] * l_w[i] * zc;
+            x_grid[i] += l_rho[i] * l_w[i] * xc_acc[li];
+            y_grid[i] += l_rho[i] * l_w[i] * yc_acc[li];
+            z_grid[i] += l_rho[i] * l_w[i] * zc_acc[li];
         }
     }
 
-    // printf("Nact/Ntot Ext %zu / %zu\n", nact, l_npoints);
     return vv10_e;
 }
 void SuperFunctional::test_functional(SharedVector rho_a, SharedVector rho_b, SharedVector gamma_aa,
@@ -140,10 +140,12 @@ class SuperFunctional {
                                                            std::shared_ptr<BlockOPoints> block, double rho_thresh,
                                                            int npoints = -1, bool internal = false);
 
-    // Copmutes the Cache data for VV10 dispersion
+    // Computes the VV10 kernel of this block against the (tiled) cache. Right tiles carrying "BOUNDS"
+    // whose bounded contribution falls below kernel_thresh are skipped; kernel_thresh <= 0 disables screening
     double compute_vv10_kernel(const std::map<std::string, SharedVector>& vals,
                                const std::vector<std::map<std::string, SharedVector>>& vv10_cache,
-                               std::shared_ptr<BlockOPoints> block, int npoints = -1, bool do_grad = false);
+                               std::shared_ptr<BlockOPoints> block, int npoints = -1, bool do_grad = false,
+                               double kernel_thresh = 0.0);
 
     // => Input/Output <= //
 
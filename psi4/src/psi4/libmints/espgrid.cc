@@ -0,0 +1,371 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/espgrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/gshell.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/osrecur.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/exception.h"
+
+namespace psi {
+
+namespace {
+
+/// Returns the nfunction x ncartesian matrix taking Cartesian to (possibly pure) functions of shell s
+std::vector<double> cart_to_function_matrix(const GaussianShell& s) {
+    int ncart = s.ncartesian();
+    int nfunc = s.nfunction();
+    std::vector<double> T(nfunc * ncart, 0.0);
+    if (s.is_pure() && s.am() > 0) {
+        SphericalTransform st(s.am());
+        for (int i = 0; i < st.n(); ++i) {
+            T[st.pureindex(i) * ncart + st.cartindex(i)] += st.coef(i);
+        }
+    } else {
+        for (int i = 0; i < ncart; ++i) T[i * ncart + i] = 1.0;
+    }
+    return T;
+}
+
+}  // namespace
+
+ESPGridEngine::ESPGridEngine(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, SharedMatrix D,
+                             double cutoff)
+    : bs1_(bs1), bs2_(bs2), cutoff_(cutoff), block_size_(128), npairs_total_(0) {
+    if (D->nirrep() != 1) {
+        throw PSIEXCEPTION("ESPGridEngine only allows \"plain\" density matrices, i.e. nirrep == 1.");
+    }
+    if (D->rowdim() != bs1_->nbf() || D->coldim() != bs2_->nbf()) {
+        throw PSIEXCEPTION("ESPGridEngine: density dimensions do not match the basis sets.");
+    }
+    build_pairs(D);
+}
+
+void ESPGridEngine::build_pairs(SharedMatrix D) {
+    double** Dp = D->pointer();
+    bool same_basis = (bs1_ == bs2_);
+
+    std::vector<std::vector<double>> T1(bs1_->nshell());
+    for (int M = 0; M < bs1_->nshell(); ++M) T1[M] = cart_to_function_matrix(bs1_->shell(M));
+    std::vector<std::vector<double>> T2;
+    if (!same_basis) {
+        T2.resize(bs2_->nshell());
+        for (int N = 0; N < bs2_->nshell(); ++N) T2[N] = cart_to_function_matrix(bs2_->shell(N));
+    }
+    const std::vector<std::vector<double>>& Tright = same_basis ? T1 : T2;
+
+    std::vector<double> Dfunc;
+    std::vector<double> temp;
+    std::vector<double> Dblock;
+
+    for (int M = 0; M < bs1_->nshell(); ++M) {
+        const GaussianShell& s1 = bs1_->shell(M);
+        int nM = s1.nfunction();
+        int oM = s1.function_index();
+        int cM = s1.ncartesian();
+        int nN_shell = same_basis ? M + 1 : bs2_->nshell();
+        for (int N = 0; N < nN_shell; ++N) {
+            const GaussianShell& s2 = bs2_->shell(N);
+            int nN = s2.nfunction();
+            int oN = s2.function_index();
+            int cN = s2.ncartesian();
+            npairs_total_++;
+
+            // => Density in the function basis, folded over (M,N) and (N,M) <= //
+            Dfunc.assign(nM * nN, 0.0);
+            for (int m = 0; m < nM; ++m) {
+                for (int n = 0; n < nN; ++n) {
+                    double val = Dp[oM + m][oN + n];
+                    if (same_basis && M != N) val += Dp[oN + n][oM + m];
+                    Dfunc[m * nN + n] = val;
+                }
+            }
+
+            // => Back-transform to Cartesians: Dcart = T1^T Dfunc T2 <= //
+            const std::vector<double>& TM = T1[M];
+            const std::vector<double>& TN = Tright[N];
+            temp.assign(cM * nN, 0.0);
+            for (int m = 0; m < nM; ++m) {
+                for (int c = 0; c < cM; ++c) {
+                    double t = TM[m * cM + c];
+                    if (t == 0.0) continue;
+                    for (int n = 0; n < nN; ++n) temp[c * nN + n] += t * Dfunc[m * nN + n];
+                }
+            }
+            Dblock.assign(cM * cN, 0.0);
+            double Dmax = 0.0;
+            for (int c = 0; c < cM; ++c) {
+                for (int n = 0; n < nN; ++n) {
+                    double t = temp[c * nN + n];
+                    if (t == 0.0) continue;
+                    for (int d = 0; d < cN; ++d) Dblock[c * cN + d] += t * TN[n * cN + d];
+                }
+                for (int d = 0; d < cN; ++d) Dmax = std::max(Dmax, std::fabs(Dblock[c * cN + d]));
+            }
+            if (Dmax == 0.0) continue;
+
+            // => Primitive pairs, screened by |D|max * 2 pi / gamma * K_AB |c1 c2| <= //
+            const double* A = s1.center();
+            const double* B = s2.center();
+            double AB2 = (A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) +
+                         (A[2] - B[2]) * (A[2] - B[2]);
+
+            size_t prim_start = prims_.size();
+            for (int p1 = 0; p1 < s1.nprimitive(); ++p1) {
+                double a1 = s1.exp(p1);
+                double c1 = s1.coef(p1);
+                for (int p2 = 0; p2 < s2.nprimitive(); ++p2) {
+                    double a2 = s2.exp(p2);
+                    double c2 = s2.coef(p2);
+                    double gamma = a1 + a2;
+                    double oog = 1.0 / gamma;
+                    double prefactor = std::exp(-a1 * a2 * AB2 * oog) * std::sqrt(M_PI * oog) * M_PI * oog * c1 * c2;
+                    double bound = std::fabs(prefactor) * 2.0 * std::sqrt(gamma / M_PI);
+                    if (Dmax * bound < cutoff_) continue;
+
+                    PrimitivePair prim;
+                    prim.gamma = gamma;
+                    prim.prefactor = prefactor;
+                    for (int k = 0; k < 3; ++k) {
+                        prim.P[k] = (a1 * A[k] + a2 * B[k]) * oog;
+                        prim.PA[k] = prim.P[k] - A[k];
+                        prim.PB[k] = prim.P[k] - B[k];
+                    }
+                    prims_.push_back(prim);
+                }
+            }
+            if (prims_.size() == prim_start) continue;
+
+            SignificantPair pair;
+            pair.am1 = s1.am();
+            pair.am2 = s2.am();
+            pair.prim_start = prim_start;
+            pair.prim_end = prims_.size();
+            pair.D_offset = Dcart_.size();
+            Dcart_.insert(Dcart_.end(), Dblock.begin(), Dblock.end());
+            pairs_.push_back(pair);
+        }
+    }
+}
+
+void ESPGridEngine::add_esp(size_t npoints, const double* x, const double* y, const double* z, double* v) const {
+    int max_am1 = bs1_->max_am();
+    int max_am2 = bs2_->max_am();
+    size_t nblocks = (npoints + block_size_ - 1) / block_size_;
+
+#pragma omp parallel
+    {
+        ObaraSaikaTwoCenterVIRecursion recur(max_am1 + 1, max_am2 + 1);
+        double*** vi = recur.vi();
+
+#pragma omp for schedule(dynamic)
+        for (size_t block = 0; block < nblocks; ++block) {
+            size_t start = block * block_size_;
+            size_t stop = std::min(npoints, start + block_size_);
+
+            for (const SignificantPair& pair : pairs_) {
+                int am1 = pair.am1;
+                int am2 = pair.am2;
+                int iym = am1 + 1;
+                int ixm = iym * iym;
+                int jym = am2 + 1;
+                int jxm = jym * jym;
+                const double* Dp = &Dcart_[pair.D_offset];
+
+                for (size_t point = start; point < stop; ++point) {
+                    double C[3] = {x[point], y[point], z[point]};
+                    double val = 0.0;
+                    for (size_t k = pair.prim_start; k < pair.prim_end; ++k) {
+                        const PrimitivePair& prim = prims_[k];
+                        double PA[3] = {prim.PA[0], prim.PA[1], prim.PA[2]};
+                        double PB[3] = {prim.PB[0], prim.PB[1], prim.PB[2]};
+                        double PC[3] = {prim.P[0] - C[0], prim.P[1] - C[1], prim.P[2] - C[2]};
+                        recur.compute(PA, PB, PC, prim.gamma, am1, am2);
+
+                        double pval = 0.0;
+                        int ao12 = 0;
+                        for (int ii = 0; ii <= am1; ii++) {
+                            int l1 = am1 - ii;
+                            for (int jj = 0; jj <= ii; jj++) {
+                                int m1 = ii - jj;
+                                int n1 = jj;
+                                int iind = l1 * ixm + m1 * iym + n1;
+                                for (int kk = 0; kk <= am2; kk++) {
+                                    int l2 = am2 - kk;
+                                    for (int ll = 0; ll <= kk; ll++) {
+                                        int m2 = kk - ll;
+                                        int n2 = ll;
+                                        int jind = l2 * jxm + m2 * jym + n2;
+                                        pval += Dp[ao12++] * vi[iind][jind][0];
+                                    }
+                                }
+                            }
+                        }
+                        val -= pval * prim.prefactor;
+                    }
+                    v[point] += val;
+                }
+            }
+        }
+    }
+}
+
+void ESPGridEngine::add_field(size_t npoints, const double* x, const double* y, const double* z, double* Ex,
+                              double* Ey, double* Ez) const {
+    int max_am1 = bs1_->max_am();
+    int max_am2 = bs2_->max_am();
+    size_t nblocks = (npoints + block_size_ - 1) / block_size_;
+
+#pragma omp parallel
+    {
+        ObaraSaikaTwoCenterElectricField recur(max_am1 + 2, max_am2 + 2);
+        double*** ex = recur.x();
+        double*** ey = recur.y();
+        double*** ez = recur.z();
+
+#pragma omp for schedule(dynamic)
+        for (size_t block = 0; block < nblocks; ++block) {
+            size_t start = block * block_size_;
+            size_t stop = std::min(npoints, start + block_size_);
+
+            for (const SignificantPair& pair : pairs_) {
+                int am1 = pair.am1;
+                int am2 = pair.am2;
+                int iym = am1 + 1;
+                int ixm = iym * iym;
+                int jym = am2 + 1;
+                int jxm = jym * jym;
+                const double* Dp = &Dcart_[pair.D_offset];
+
+                for (size_t point = start; point < stop; ++point) {
+                    double C[3] = {x[point], y[point], z[point]};
+                    double fx = 0.0;
+                    double fy = 0.0;
+                    double fz = 0.0;
+                    for (size_t k = pair.prim_start; k < pair.prim_end; ++k) {
+                        const PrimitivePair& prim = prims_[k];
+                        double PA[3] = {prim.PA[0], prim.PA[1], prim.PA[2]};
+                        double PB[3] = {prim.PB[0], prim.PB[1], prim.PB[2]};
+                        double PC[3] = {prim.P[0] - C[0], prim.P[1] - C[1], prim.P[2] - C[2]};
+                        recur.compute(PA, PB, PC, prim.gamma, am1, am2);
+
+                        double px = 0.0;
+                        double py = 0.0;
+                        double pz = 0.0;
+                        int ao12 = 0;
+                        for (int ii = 0; ii <= am1; ii++) {
+                            int l1 = am1 - ii;
+                            for (int jj = 0; jj <= ii; jj++) {
+                                int m1 = ii - jj;
+                                int n1 = jj;
+                                int iind = l1 * ixm + m1 * iym + n1;
+                                for (int kk = 0; kk <= am2; kk++) {
+                                    int l2 = am2 - kk;
+                                    for (int ll = 0; ll <= kk; ll++) {
+                                        int m2 = kk - ll;
+                                        int n2 = ll;
+                                        int jind = l2 * jxm + m2 * jym + n2;
+                                        double d = Dp[ao12++];
+                                        px += d * ex[iind][jind][0];
+                                        py += d * ey[iind][jind][0];
+                                        pz += d * ez[iind][jind][0];
+                                    }
+                                }
+                            }
+                        }
+                        fx += px * prim.prefactor;
+                        fy += py * prim.prefactor;
+                        fz += pz * prim.prefactor;
+                    }
+                    Ex[point] += fx;
+                    Ey[point] += fy;
+                    Ez[point] += fz;
+                }
+            }
+        }
+    }
+}
+
+SharedVector ESPGridEngine::compute_esp(SharedMatrix coords) const {
+    if (coords->nirrep() != 1 || coords->coldim() != 3) {
+        throw PSIEXCEPTION("ESPGridEngine: coordinates must be a plain N x 3 matrix.");
+    }
+    size_t npoints = coords->rowdim();
+    auto esp = std::make_shared<Vector>("ESP", npoints);
+    if (!npoints) return esp;
+
+    double** xyz = coords->pointer();
+    std::vector<double> x(npoints), y(npoints), z(npoints);
+    for (size_t P = 0; P < npoints; ++P) {
+        x[P] = xyz[P][0];
+        y[P] = xyz[P][1];
+        z[P] = xyz[P][2];
+    }
+    add_esp(npoints, x.data(), y.data(), z.data(), esp->pointer());
+    return esp;
+}
+
+SharedMatrix ESPGridEngine::compute_field(SharedMatrix coords) const {
+    if (coords->nirrep() != 1 || coords->coldim() != 3) {
+        throw PSIEXCEPTION("ESPGridEngine: coordinates must be a plain N x 3 matrix.");
+    }
+    size_t npoints = coords->rowdim();
+    auto field = std::make_shared<Matrix>("efield", npoints, 3);
+    if (!npoints) return field;
+
+    double** xyz = coords->pointer();
+    std::vector<double> x(npoints), y(npoints), z(npoints);
+    for (size_t P = 0; P < npoints; ++P) {
+        x[P] = xyz[P][0];
+        y[P] = xyz[P][1];
+        z[P] = xyz[P][2];
+    }
+    std::vector<double> Ex(npoints, 0.0), Ey(npoints, 0.0), Ez(npoints, 0.0);
+    add_field(npoints, x.data(), y.data(), z.data(), Ex.data(), Ey.data(), Ez.data());
+
+    double** fp = field->pointer();
+    for (size_t P = 0; P < npoints; ++P) {
+        fp[P][0] = Ex[P];
+        fp[P][1] = Ey[P];
+        fp[P][2] = Ez[P];
+    }
+    return field;
+}
+
+}  // namespace psi
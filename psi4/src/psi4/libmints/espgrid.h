@@ -0,0 +1,123 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_espgrid_h_
+#define _psi_src_lib_libmints_espgrid_h_
+
+#include <memory>
+#include <vector>
+
+#include "psi4/libmints/typedefs.h"
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class BasisSet;
+
+/*! \ingroup MINTS
+ *  \class ESPGridEngine
+ *  \brief Contracts a one-particle density with potential and field integrals over a set of points.
+ *
+ *  The density is transformed to the Cartesian shell-pair blocks once at construction and
+ *  contracted with the Obara-Saika potential/field recursion on the fly, so no AO integral matrix
+ *  is ever formed for a grid point.  Shell pairs are screened by max |D| over the pair times a
+ *  primitive bound on the potential integrals, and points are processed in blocks distributed
+ *  over threads.
+ *
+ *  The density is given in the AO basis of bs1 x bs2.  If bs1 and bs2 are the same basis set,
+ *  only the unique shell pairs are visited.  A fitted density may be passed as an naux x 1 matrix
+ *  with bs1 the auxiliary basis and bs2 BasisSet::zero_ao_basis_set().
+ *
+ *  Only the electronic contributions are computed; with a positive density the ESP is negative.
+ */
+class PSI_API ESPGridEngine {
+   protected:
+    /// Primitive-pair intermediates, invariant with respect to the grid point
+    struct PrimitivePair {
+        double gamma;
+        double P[3];
+        double PA[3];
+        double PB[3];
+        double prefactor;
+    };
+    /// A significant shell pair with its Cartesian density block
+    struct SignificantPair {
+        int am1;
+        int am2;
+        size_t prim_start;
+        size_t prim_end;
+        size_t D_offset;
+    };
+
+    std::shared_ptr<BasisSet> bs1_;
+    std::shared_ptr<BasisSet> bs2_;
+
+    /// Shell pairs that survive the density-weighted screening
+    std::vector<SignificantPair> pairs_;
+    /// Primitive pairs for all significant shell pairs
+    std::vector<PrimitivePair> prims_;
+    /// Cartesian density blocks (symmetry-folded when bs1 == bs2)
+    std::vector<double> Dcart_;
+
+    /// Screening threshold on |D| * |V| estimates
+    double cutoff_;
+    /// Number of points handed to a thread at a time
+    size_t block_size_;
+    /// Total number of shell pairs considered
+    size_t npairs_total_;
+
+    void build_pairs(SharedMatrix D);
+
+   public:
+    ESPGridEngine(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, SharedMatrix D,
+                  double cutoff = 1.0E-14);
+
+    /// Adds the electronic ESP at each of the npoints points (x, y, z, in bohr) to v
+    void add_esp(size_t npoints, const double* x, const double* y, const double* z, double* v) const;
+    /// Adds the electronic field at each of the npoints points (x, y, z, in bohr) to Ex, Ey, Ez
+    void add_field(size_t npoints, const double* x, const double* y, const double* z, double* Ex, double* Ey,
+                   double* Ez) const;
+
+    /// Electronic ESP at the points in coords (N x 3, bohr)
+    SharedVector compute_esp(SharedMatrix coords) const;
+    /// Electronic field at the points in coords (N x 3, bohr), returned as N x 3
+    SharedMatrix compute_field(SharedMatrix coords) const;
+
+    /// Number of points per thread task (default 128)
+    void set_block_size(size_t block_size) { block_size_ = (block_size ? block_size : 1); }
+    size_t block_size() const { return block_size_; }
+
+    /// Number of shell pairs kept after screening
+    size_t nsignificant_pairs() const { return pairs_.size(); }
+    /// Number of shell pairs visited before screening
+    size_t npairs_total() const { return npairs_total_; }
+};
+
+}  // namespace psi
+
+#endif
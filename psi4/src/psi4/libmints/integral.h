@@ -399,6 +399,9 @@ class PSI_API IntegralFactory {
     /// Provides ability to transform from sphericals (d=0, f=1, g=2)
     std::vector<ISphericalTransform> ispherical_transforms_;
 
+    /// Two-electron screening threshold, negative to use INTS_TOLERANCE
+    double ints_tolerance_ = -1.0;
+
    public:
     /** Initialize IntegralFactory object given a BasisSet for each center. */
     IntegralFactory(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, std::shared_ptr<BasisSet> bs3,
@@ -417,6 +420,11 @@ class PSI_API IntegralFactory {
     /// Return the basis set on center 4.
     std::shared_ptr<BasisSet> basis4() const;
 
+    /// Override INTS_TOLERANCE for the two-electron integrals of this factory (negative restores it)
+    void set_ints_tolerance(double tolerance) { ints_tolerance_ = tolerance; }
+    /// The screening threshold of the two-electron integrals of this factory
+    double ints_tolerance() const;
+
     /// Set the basis set for each center.
     virtual void set_basis(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, std::shared_ptr<BasisSet> bs3,
                            std::shared_ptr<BasisSet> bs4);
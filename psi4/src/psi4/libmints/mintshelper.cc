@@ -47,12 +47,15 @@
 #include "psi4/libpsi4util/process.h"
 #include "electricfield.h"
 
+#include <array>
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 #include <utility>
@@ -89,44 +92,56 @@ extern brianInt brianRestrictionType;
 namespace psi {
 
 /**
- * IWLWriter functor for use with SO TEIs
+ * Per-thread IWL functor for use with SO TEIs: fills a private buffer and
+ * hands each full one to the shared IWL file under a lock, so that all
+ * threads write one ordinary IWL stream
  **/
-class PSI_API IWLWriter {
+class IWLThreadWriter {
     IWL &writeto_;
+    std::mutex &lock_;
     size_t count_;
-    int &current_buffer_count_;
+    int current_buffer_count_;
 
-    Label *plabel_;
-    Value *pvalue_;
+    std::vector<Label> labels_;
+    std::vector<Value> values_;
 
    public:
-    IWLWriter(IWL &writeto) : writeto_(writeto), count_(0), current_buffer_count_(writeto_.index()) {
-        plabel_ = writeto_.labels();
-        pvalue_ = writeto_.values();
-    }
+    IWLThreadWriter(IWL &writeto, std::mutex &lock)
+        : writeto_(writeto),
+          lock_(lock),
+          count_(0),
+          current_buffer_count_(0),
+          labels_(4 * (size_t)writeto.ints_per_buffer()),
+          values_(writeto.ints_per_buffer()) {}
 
     void operator()(int i, int j, int k, int l, int, int, int, int, int, int, int, int, double value) {
         int current_label_position = 4 * current_buffer_count_;
 
         // Save the labels
-        plabel_[current_label_position++] = i;
-        plabel_[current_label_position++] = j;
-        plabel_[current_label_position++] = k;
-        plabel_[current_label_position] = l;
+        labels_[current_label_position++] = i;
+        labels_[current_label_position++] = j;
+        labels_[current_label_position++] = k;
+        labels_[current_label_position] = l;
 
         // Save the value
-        pvalue_[current_buffer_count_++] = value;
+        values_[current_buffer_count_++] = value;
 
         // Increment overall counter
         count_++;
 
-        // If our IWL buffer is full dump to disk.
-        if (current_buffer_count_ == writeto_.ints_per_buffer()) {
-            writeto_.last_buffer() = 0;
-            writeto_.buffer_count() = current_buffer_count_;
-            writeto_.put();
-            current_buffer_count_ = 0;
-        }
+        // If our buffer is full hand it to the file.
+        if (current_buffer_count_ == writeto_.ints_per_buffer()) flush();
+    }
+
+    /// Write out the (possibly partial) private buffer as one IWL buffer
+    void flush() {
+        if (current_buffer_count_ == 0) return;
+        std::lock_guard<std::mutex> guard(lock_);
+        ::memcpy((void *)writeto_.labels(), (void *)labels_.data(), 4 * current_buffer_count_ * sizeof(Label));
+        ::memcpy((void *)writeto_.values(), (void *)values_.data(), current_buffer_count_ * sizeof(Value));
+        writeto_.index() = current_buffer_count_;
+        writeto_.flush(0);
+        current_buffer_count_ = 0;
     }
 
     size_t count() const { return count_; }
@@ -290,17 +305,13 @@ void MintsHelper::integrals() {
 
     // Open the IWL buffer where we will store the integrals.
     IWL ERIOUT(psio_.get(), PSIF_SO_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Let the user know what we're doing.
     if (print_) {
         outfile->Printf("      Computing two-electron integrals...");
     }
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
-        eri->compute_shell(shellIter, writer);
-    }
+    size_t count = so_tei_to_iwl(eri, ERIOUT);
 
     // Flush out buffers.
     ERIOUT.flush(1);
@@ -314,7 +325,7 @@ void MintsHelper::integrals() {
         outfile->Printf(
             "      Computed %lu non-zero two-electron integrals.\n"
             "        Stored in file %d.\n\n",
-            writer.count(), PSIF_SO_TEI);
+            count, PSIF_SO_TEI);
     }
 }
 
@@ -322,7 +333,6 @@ void MintsHelper::integrals_erf(double w) {
     double omega = (w == -1.0 ? options_.get_double("OMEGA_ERF") : w);
 
     IWL ERIOUT(psio_.get(), PSIF_SO_ERF_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Get ERI object
     std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
@@ -332,8 +342,7 @@ void MintsHelper::integrals_erf(double w) {
     // Let the user know what we're doing.
     outfile->Printf("      Computing non-zero ERF integrals (omega = %.3f)...", omega);
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) erf->compute_shell(shellIter, writer);
+    size_t count = so_tei_to_iwl(erf, ERIOUT);
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -346,14 +355,13 @@ void MintsHelper::integrals_erf(double w) {
     outfile->Printf(
         "      Computed %lu non-zero ERF integrals.\n"
         "        Stored in file %d.\n\n",
-        writer.count(), PSIF_SO_ERF_TEI);
+        count, PSIF_SO_ERF_TEI);
 }
 
 void MintsHelper::integrals_erfc(double w) {
     double omega = (w == -1.0 ? options_.get_double("OMEGA_ERF") : w);
 
     IWL ERIOUT(psio_.get(), PSIF_SO_ERFC_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Get ERI object
     std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
@@ -364,8 +372,7 @@ void MintsHelper::integrals_erfc(double w) {
     // Let the user know what we're doing.
     outfile->Printf("      Computing non-zero ERFComplement integrals...");
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) erf->compute_shell(shellIter, writer);
+    size_t count = so_tei_to_iwl(erf, ERIOUT);
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -378,7 +385,40 @@ void MintsHelper::integrals_erfc(double w) {
     outfile->Printf(
         "      Computed %lu non-zero ERFComplement integrals.\n"
         "        Stored in file %d.\n\n",
-        writer.count(), PSIF_SO_ERFC_TEI);
+        count, PSIF_SO_ERFC_TEI);
+}
+
+size_t MintsHelper::so_tei_to_iwl(std::shared_ptr<TwoBodySOInt> ints, IWL &iwl) {
+    // Unique SO shell quartets, in iterator order
+    std::vector<std::array<int, 4>> quartets;
+    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
+    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
+        quartets.push_back({shellIter.p(), shellIter.q(), shellIter.r(), shellIter.s()});
+    }
+
+    std::mutex lock;
+    std::vector<IWLThreadWriter> writers;
+    for (int thread = 0; thread < nthread_; thread++) {
+        writers.emplace_back(iwl, lock);
+    }
+
+    // ints holds one AO integral object and SO buffer per thread
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (size_t PQRS = 0; PQRS < quartets.size(); PQRS++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const auto &quartet = quartets[PQRS];
+        ints->compute_shell(quartet[0], quartet[1], quartet[2], quartet[3], writers[thread]);
+    }
+
+    size_t count = 0;
+    for (auto &writer : writers) {
+        writer.flush();
+        count += writer.count();
+    }
+    return count;
 }
 
 void MintsHelper::one_electron_integrals() {
@@ -798,12 +838,88 @@ SharedMatrix MintsHelper::ao_helper(const std::string &label, std::shared_ptr<Tw
     auto I = std::make_shared<Matrix>(label, nbf1 * nbf2, nbf3 * nbf4);
     double **Ip = I->pointer();
 
-    for (int M = 0; M < bs1->nshell(); M++) {
-        for (int N = 0; N < bs2->nshell(); N++) {
+    // One integral object per thread
+    std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
+    tb.push_back(ints);
+    for (int thread = 1; thread < nthread_; thread++) {
+        tb.push_back(std::shared_ptr<TwoBodyAOInt>(ints->clone()));
+    }
+
+    if (bs1 == bs2 && bs1 == bs3 && bs1 == bs4) {
+        // => 8-fold symmetric case: unique, sieved shell quartets scattered to all permutations <= //
+
+        int nshell = bs1->nshell();
+        std::vector<std::pair<int, int>> shell_pairs;
+        for (int M = 0; M < nshell; M++) {
+            for (int N = 0; N <= M; N++) {
+                if (ints->shell_pair_significant(M, N)) shell_pairs.push_back(std::make_pair(M, N));
+            }
+        }
+        size_t npair = shell_pairs.size();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (size_t MN = 0; MN < npair; MN++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            int M = shell_pairs[MN].first;
+            int N = shell_pairs[MN].second;
+            int Msize = bs1->shell(M).nfunction();
+            int Nsize = bs1->shell(N).nfunction();
+            int Moff = bs1->shell(M).function_index();
+            int Noff = bs1->shell(N).function_index();
+
+            for (size_t PQ = 0; PQ <= MN; PQ++) {
+                int P = shell_pairs[PQ].first;
+                int Q = shell_pairs[PQ].second;
+                if (!tb[thread]->shell_significant(M, N, P, Q)) continue;
+                if (tb[thread]->compute_shell(M, N, P, Q) == 0) continue;
+                const double *buffer = tb[thread]->buffer();
+
+                int Psize = bs1->shell(P).nfunction();
+                int Qsize = bs1->shell(Q).nfunction();
+                int Poff = bs1->shell(P).function_index();
+                int Qoff = bs1->shell(Q).function_index();
+
+                // Every element belongs to exactly one unique quartet, so threads never collide
+                for (int m = Moff, index = 0; m < Moff + Msize; m++) {
+                    for (int n = Noff; n < Noff + Nsize; n++) {
+                        for (int p = Poff; p < Poff + Psize; p++) {
+                            for (int q = Qoff; q < Qoff + Qsize; q++, index++) {
+                                double val = buffer[index];
+                                Ip[m * nbf1 + n][p * nbf1 + q] = val;
+                                Ip[n * nbf1 + m][p * nbf1 + q] = val;
+                                Ip[m * nbf1 + n][q * nbf1 + p] = val;
+                                Ip[n * nbf1 + m][q * nbf1 + p] = val;
+                                Ip[p * nbf1 + q][m * nbf1 + n] = val;
+                                Ip[q * nbf1 + p][m * nbf1 + n] = val;
+                                Ip[p * nbf1 + q][n * nbf1 + m] = val;
+                                Ip[q * nbf1 + p][n * nbf1 + m] = val;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    } else {
+        // => Mixed basis sets: no permutational symmetry, threaded over bra shell pairs <= //
+
+        int nshell1 = bs1->nshell();
+        int nshell2 = bs2->nshell();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (int MN = 0; MN < nshell1 * nshell2; MN++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            int M = MN / nshell2;
+            int N = MN % nshell2;
             for (int P = 0; P < bs3->nshell(); P++) {
                 for (int Q = 0; Q < bs4->nshell(); Q++) {
-                    ints->compute_shell(M, N, P, Q);
-                    const double *buffer = ints->buffer();
+                    tb[thread]->compute_shell(M, N, P, Q);
+                    const double *buffer = tb[thread]->buffer();
 
                     for (int m = 0, index = 0; m < bs1->shell(M).nfunction(); m++) {
                         for (int n = 0; n < bs2->shell(N).nfunction(); n++) {
@@ -1094,6 +1210,7 @@ SharedMatrix MintsHelper::mo_eri_helper(SharedMatrix Iso, SharedMatrix C1, Share
     auto I4 = std::make_shared<Matrix>("MO ERI Tensor", nso * n1, n3 * nso);
     double **I4p = I4->pointer();
 
+#pragma omp parallel for num_threads(nthread_)
     for (int i = 0; i < n1; i++) {
         for (int j = 0; j < n3; j++) {
             for (int m = 0; m < nso; m++) {
@@ -1121,6 +1238,7 @@ SharedMatrix MintsHelper::mo_eri_helper(SharedMatrix Iso, SharedMatrix C1, Share
     auto Imo = std::make_shared<Matrix>("MO ERI Tensor", n1 * n2, n3 * n4);
     double **Imop = Imo->pointer();
 
+#pragma omp parallel for num_threads(nthread_)
     for (int i = 0; i < n1; i++) {
         for (int j = 0; j < n3; j++) {
             for (int a = 0; a < n2; a++) {
@@ -1162,6 +1280,7 @@ SharedMatrix MintsHelper::mo_eri_helper(SharedMatrix Iso, SharedMatrix Co, Share
     auto I4 = std::make_shared<Matrix>("MO ERI Tensor", nso * nocc, nocc * nso);
     double **I4p = I4->pointer();
 
+#pragma omp parallel for num_threads(nthread_)
     for (int i = 0; i < nocc; i++) {
         for (int j = 0; j < nocc; j++) {
             for (int m = 0; m < nso; m++) {
@@ -1189,6 +1308,7 @@ SharedMatrix MintsHelper::mo_eri_helper(SharedMatrix Iso, SharedMatrix Co, Share
     auto Imo = std::make_shared<Matrix>("MO ERI Tensor", nocc * nvir, nocc * nvir);
     double **Imop = Imo->pointer();
 
+#pragma omp parallel for num_threads(nthread_)
     for (int i = 0; i < nocc; i++) {
         for (int j = 0; j < nocc; j++) {
             for (int a = 0; a < nvir; a++) {
@@ -1858,6 +1978,7 @@ SharedMatrix MintsHelper::mo_transform(SharedMatrix Iso, SharedMatrix C1, Shared
     auto I4 = std::make_shared<Matrix>("MO ERI Tensor", nso * n1, n3 * nso);
     double **I4p = I4->pointer();
 
+#pragma omp parallel for num_threads(nthread_)
     for (int i = 0; i < n1; i++) {
         for (int j = 0; j < n3; j++) {
             for (int m = 0; m < nso; m++) {
@@ -1887,6 +2008,7 @@ SharedMatrix MintsHelper::mo_transform(SharedMatrix Iso, SharedMatrix C1, Shared
 
     // Currently 2143, need to transform back
     int left, right;
+#pragma omp parallel for num_threads(nthread_) private(left, right)
     for (int i = 0; i < n1; i++) {
         for (int j = 0; j < n3; j++) {
             for (int a = 0; a < n2; a++) {
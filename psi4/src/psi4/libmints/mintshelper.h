@@ -40,6 +40,8 @@ namespace psi {
 class CdSalcList;
 class CorrelationFactor;
 class TwoBodyAOInt;
+class TwoBodySOInt;
+class IWL;
 class PetiteList;
 class ThreeCenterOverlapInt;
 class OneBodyAOInt;
@@ -78,6 +80,9 @@ class PSI_API MintsHelper {
     SharedMatrix mo_eri_helper(SharedMatrix Iso, SharedMatrix Co, SharedMatrix Cv);
     // In-core O(N^5) transqt
     SharedMatrix mo_eri_helper(SharedMatrix Iso, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4);
+    /// Compute all unique SO TEIs from ints (one AO object per thread) into iwl, threaded
+    /// over shell quartets; returns the number of integrals written
+    size_t so_tei_to_iwl(std::shared_ptr<TwoBodySOInt> ints, IWL& iwl);
     /// In-core builds spin eri's
     SharedMatrix mo_spin_eri_helper(SharedMatrix Iso, int n1, int n2);
 
@@ -49,6 +49,7 @@
 #include "psi4/libmints/pointgrp.h"
 #include "psi4/libmints/electricfield.h"
 #include "psi4/libmints/electrostatic.h"
+#include "psi4/libmints/espgrid.h"
 #include "psi4/libmints/petitelist.h"
 #include "psi4/libmints/multipoles.h"
 #include "psi4/libmints/dipole.h"
@@ -1030,45 +1031,47 @@ ESPPropCalc::~ESPPropCalc() {}
 void OEProp::compute_esp_over_grid() { epc_.compute_esp_over_grid(true); }
 
 void ESPPropCalc::compute_esp_over_grid(bool print_output) {
-    std::shared_ptr<Molecule> mol = basisset_->molecule();
-
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     if (print_output) {
         outfile->Printf("\n Electrostatic potential computed on the grid and written to grid_esp.dat\n");
     }
 
+    SharedMatrix grid = read_grid("grid.dat");
+    SharedVector esp = compute_esp_over_grid_in_memory(grid);
+
+    Vvals_.assign(esp->pointer(), esp->pointer() + esp->dim());
+    FILE* gridout = fopen("grid_esp.dat", "w");
+    if (!gridout) throw PSIEXCEPTION("Unable to write to grid_esp.dat");
+    for (double V : Vvals_) {
+        fprintf(gridout, "%16.10f\n", V);
+    }
+    fclose(gridout);
+}
+
+SharedMatrix ESPPropCalc::read_grid(const std::string& filename) const {
+    std::vector<Vector3> points;
+    GridIterator griditer(filename);
+    for (griditer.first(); !griditer.last(); griditer.next()) {
+        points.push_back(griditer.gridpoints());
+    }
+
+    auto grid = std::make_shared<Matrix>("Grid", points.size(), 3);
+    double** gridp = grid->pointer();
+    for (size_t i = 0; i < points.size(); ++i) {
+        gridp[i][0] = points[i][0];
+        gridp[i][1] = points[i][1];
+        gridp[i][2] = points[i][2];
+    }
+    return grid;
+}
+
+SharedMatrix ESPPropCalc::total_density() const {
     SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
     if (same_dens_) {
         Dtot->scale(2.0);
     } else {
         Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
     }
-
-    int nbf = basisset_->nbf();
-    auto ints = std::make_shared<Matrix>("Ex integrals", nbf, nbf);
-
-    Vvals_.clear();
-    FILE* gridout = fopen("grid_esp.dat", "w");
-    if (!gridout) throw PSIEXCEPTION("Unable to write to grid_esp.dat");
-    GridIterator griditer("grid.dat");
-    for (griditer.first(); !griditer.last(); griditer.next()) {
-        Vector3 origin(griditer.gridpoints());
-        if (mol->units() == Molecule::Angstrom) origin /= pc_bohr2angstroms;
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
-        double Vnuc = 0.0;
-        int natom = mol->natom();
-        for (int i = 0; i < natom; i++) {
-            Vector3 dR = origin - mol->xyz(i);
-            double r = dR.norm();
-            if (r > 1.0E-8) Vnuc += mol->Z(i) / r;
-        }
-        Vvals_.push_back(Velec + Vnuc);
-        fprintf(gridout, "%16.10f\n", Velec + Vnuc);
-    }
-    fclose(gridout);
+    return Dtot;
 }
 
 SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_grid) const {
@@ -1080,39 +1083,33 @@ SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_gri
         throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with a dimension of N (rows) x 3 (cols)");
     }
 
-    int number_of_grid_points = input_grid->rowdim();
-    SharedVector output = std::make_shared<Vector>(number_of_grid_points);
-
     std::shared_ptr<Molecule> mol = basisset_->molecule();
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
 
-    SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
-    if (same_dens_) {
-        Dtot->scale(2.0);
-    } else {
-        Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
+    // Scale the coordinates if needed
+    auto coords = input_grid;
+    if (mol->units() == Molecule::Angstrom) {
+        coords = input_grid->clone();
+        coords->scale(1.0 / pc_bohr2angstroms);
     }
 
-    int const nbf = basisset_->nbf();
-
-    bool convert = mol->units() == Molecule::Angstrom;
+    // Electronic contribution, contracted with the density shell pair by shell pair
+    ESPGridEngine engine(basisset_, basisset_, total_density());
+    SharedVector output = engine.compute_esp(coords);
 
+    // Add the nuclear contribution.
+    int number_of_grid_points = coords->rowdim();
+    int natom = mol->natom();
+    double** xyz = coords->pointer();
+#pragma omp parallel for schedule(static)
     for (int i = 0; i < number_of_grid_points; ++i) {
-        Vector3 origin(input_grid->get(i, 0), input_grid->get(i, 1), input_grid->get(i, 2));
-        if (convert) origin /= pc_bohr2angstroms;
-        auto ints = std::make_shared<Matrix>(nbf, nbf);
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
+        Vector3 origin(xyz[i][0], xyz[i][1], xyz[i][2]);
         double Vnuc = 0.0;
-        int natom = mol->natom();
         for (int iat = 0; iat < natom; iat++) {
             Vector3 dR = origin - mol->xyz(iat);
             double r = dR.norm();
             if (r > 1.0E-8) Vnuc += mol->Z(iat) / r;
         }
-        double Vtot = Velec + Vnuc;
-        (*output)[i] = Vtot;
+        (*output)[i] += Vnuc;
     }
     return output;
 }
@@ -1120,28 +1117,13 @@ SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_gri
 void OEProp::compute_field_over_grid() { epc_.compute_field_over_grid(true); }
 
 void ESPPropCalc::compute_field_over_grid(bool print_output) {
-    std::shared_ptr<Molecule> mol = basisset_->molecule();
-
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     if (print_output) {
         outfile->Printf("\n Field computed on the grid and written to grid_field.dat\n");
     }
 
-    SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
-    if (same_dens_) {
-        Dtot->scale(2.0);
-    } else {
-        Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
-    }
-
-    std::shared_ptr<ElectricFieldInt> field_ints(dynamic_cast<ElectricFieldInt*>(wfn_->integral()->electric_field()));
-
-    int nbf = basisset_->nbf();
-    std::vector<SharedMatrix> intmats;
-    intmats.push_back(std::make_shared<Matrix>("Ex integrals", nbf, nbf));
-    intmats.push_back(std::make_shared<Matrix>("Ey integrals", nbf, nbf));
-    intmats.push_back(std::make_shared<Matrix>("Ez integrals", nbf, nbf));
+    SharedMatrix grid = read_grid("grid.dat");
+    SharedMatrix efield = compute_field_over_grid_in_memory(grid);
+    double** efieldp = efield->pointer();
 
     Exvals_.clear();
     Eyvals_.clear();
@@ -1149,21 +1131,11 @@ void ESPPropCalc::compute_field_over_grid(bool print_output) {
 
     FILE* gridout = fopen("grid_field.dat", "w");
     if (!gridout) throw PSIEXCEPTION("Unable to write to grid_field.dat");
-    GridIterator griditer("grid.dat");
-    for (griditer.first(); !griditer.last(); griditer.next()) {
-        Vector3 origin(griditer.gridpoints());
-        if (mol->units() == Molecule::Angstrom) origin /= pc_bohr2angstroms;
-        field_ints->set_origin(origin);
-        for (int m = 0; m < 3; ++m) intmats[m]->zero();
-        field_ints->compute(intmats);
-        double Ex = Dtot->vector_dot(intmats[0]);
-        double Ey = Dtot->vector_dot(intmats[1]);
-        double Ez = Dtot->vector_dot(intmats[2]);
-        Vector3 nuc = field_ints->nuclear_contribution(origin, mol);
-        Exvals_.push_back(Ex + nuc[0]);
-        Eyvals_.push_back(Ey + nuc[1]);
-        Ezvals_.push_back(Ez + nuc[2]);
-        fprintf(gridout, "%16.10f %16.10f %16.10f\n", Ex + nuc[0], Ey + nuc[1], Ez + nuc[2]);
+    for (int i = 0; i < efield->rowdim(); ++i) {
+        Exvals_.push_back(efieldp[i][0]);
+        Eyvals_.push_back(efieldp[i][1]);
+        Ezvals_.push_back(efieldp[i][2]);
+        fprintf(gridout, "%16.10f %16.10f %16.10f\n", efieldp[i][0], efieldp[i][1], efieldp[i][2]);
     }
     fclose(gridout);
 }
@@ -1179,15 +1151,6 @@ SharedMatrix ESPPropCalc::compute_field_over_grid_in_memory(SharedMatrix input_g
 
     std::shared_ptr<Molecule> mol = basisset_->molecule();
 
-    SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "CartAO", "D");
-    if (same_dens_) {
-        Dtot->scale(2.0);
-    } else {
-        Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "CartAO", "D beta"));
-    }
-
-    std::shared_ptr<ElectricFieldInt> field_ints(dynamic_cast<ElectricFieldInt*>(wfn_->integral()->electric_field()));
-
     // Scale the coordinates if needed
     auto coords = input_grid;
 
@@ -1197,20 +1160,20 @@ SharedMatrix ESPPropCalc::compute_field_over_grid_in_memory(SharedMatrix input_g
     }
 
     // Compute the electric field at all grid points.
-    int number_of_grid_points = coords->rowdim();
-
-    SharedMatrix efield = std::make_shared<Matrix>("efield", number_of_grid_points, 3);
-
-    auto field_functor = ContractOverDensityFieldFunctor(efield, Dtot);
-    field_ints->compute_with_functor(field_functor, coords);
+    ESPGridEngine engine(basisset_, basisset_, total_density());
+    SharedMatrix efield = engine.compute_field(coords);
 
     // Add the nuclear contribution.
+    int number_of_grid_points = coords->rowdim();
+    double** xyz = coords->pointer();
+    double** efieldp = efield->pointer();
+#pragma omp parallel for schedule(static)
     for (int i = 0; i < number_of_grid_points; ++i) {
-        Vector3 origin(coords->get(i, 0), coords->get(i, 1), coords->get(i, 2));
-        Vector3 nuc = field_ints->nuclear_contribution(origin, mol);
-        efield->set(i, 0, efield->get(i, 0) + nuc[0]);
-        efield->set(i, 1, efield->get(i, 1) + nuc[1]);
-        efield->set(i, 2, efield->get(i, 2) + nuc[2]);
+        Vector3 origin(xyz[i][0], xyz[i][1], xyz[i][2]);
+        Vector3 nuc = ElectricFieldInt::nuclear_contribution(origin, mol);
+        efieldp[i][0] += nuc[0];
+        efieldp[i][1] += nuc[1];
+        efieldp[i][2] += nuc[2];
     }
     return efield;
 }
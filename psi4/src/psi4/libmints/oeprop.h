@@ -359,6 +359,11 @@ class ESPPropCalc : public Prop {
     std::vector<double> Eyvals_;
     std::vector<double> Ezvals_;
 
+    /// Reads an N x 3 grid from a whitespace separated file, in the units of the molecule
+    SharedMatrix read_grid(const std::string& filename) const;
+    /// The total (alpha + beta) density in the AO basis
+    SharedMatrix total_density() const;
+
    public:
     /// Constructor
     ESPPropCalc(std::shared_ptr<Wavefunction> wfn);
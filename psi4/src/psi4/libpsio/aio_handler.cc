@@ -34,449 +34,242 @@
 #include "aiohandler.h"
 
 #include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/psi4-dec.h"
 
-#include <cstdio>
-#include <memory>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <functional>
+#include <memory>
 
 namespace psi {
 
-AIOHandler::AIOHandler(std::shared_ptr<PSIO> psio) : psio_(psio) {
-    locked_ = new std::mutex();
-    uniqueID_ = 0;
-}
+AIOHandler::AIOHandler(std::shared_ptr<PSIO> psio, size_t nthreads)
+    : psio_(psio), nthreads_(std::max(nthreads, (size_t)1)), stop_(false), uniqueID_(0) {}
 AIOHandler::~AIOHandler() {
-    synchronize();
-    delete locked_;
+    // Nothing left to report an error to
+    try {
+        synchronize();
+    } catch (...) {
+    }
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        stop_ = true;
+    }
+    work_ready_.notify_all();
+    for (auto &worker : workers_) worker.join();
 }
 void AIOHandler::synchronize() {
-    // Joining a thread twice is an error. Thus, we check whether
-    // the thread is joinable before joining. Non-joinable threads
-    // have either been joined, detached (no synchronization possible)
-    // or have been moved from, and another thread object controls its execution.
-    //    std::unique_lock<std::mutex> lock(*locked_);
-    //    lock.unlock();
-    if (thread_)
-        if (thread_->joinable()) thread_->join();
+    std::unique_lock<std::mutex> lock(lock_);
+    auto t_start = std::chrono::steady_clock::now();
+    job_done_.wait(lock, [this] { return queue_.empty() && busy_units_.empty(); });
+    std::chrono::duration<double> stall = std::chrono::steady_clock::now() - t_start;
+    stats_.stall_seconds += stall.count();
+
+    if (!errors_.empty()) {
+        std::exception_ptr error = errors_.begin()->second;
+        errors_.clear();
+        std::rethrow_exception(error);
+    }
 }
-size_t AIOHandler::read(size_t unit, const char *key, char *buffer, size_t size, psio_address start,
-                        psio_address *end) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(1);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(buffer);
-    size_.push(size);
-    start_.push(start);
-    end_.push(end);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
+size_t AIOHandler::submit_job(size_t unit, JobType type, size_t bytes, std::function<void()> work) {
+    std::unique_lock<std::mutex> lock(lock_);
+
+    Job job;
+    job.id = ++uniqueID_;
+    job.unit = unit;
+    job.type = type;
+    job.bytes = bytes;
+    job.work = std::move(work);
+    pending_[job.id] = job.done.get_future().share();
+    queue_.push_back(std::move(job));
+
+    stats_.jobs++;
+    stats_.bytes += bytes;
+    stats_.max_queue_depth = std::max(stats_.max_queue_depth, queue_.size());
+
+    // Grow the pool up to nthreads_, one worker per job in flight
+    if (workers_.size() < nthreads_ && workers_.size() < queue_.size() + busy_units_.size()) {
+        workers_.emplace_back(&AIOHandler::call_aio, this);
+    }
 
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
+    lock.unlock();
+    work_ready_.notify_one();
     return uniqueID_;
 }
+std::shared_future<void> AIOHandler::submit(size_t unit, std::function<void()> work, size_t bytes) {
+    return future(submit_job(unit, JobType::Generic, bytes, std::move(work)));
+}
+std::shared_future<void> AIOHandler::future(size_t jobid) {
+    std::unique_lock<std::mutex> lock(lock_);
+    auto it = pending_.find(jobid);
+    if (it != pending_.end()) return it->second;
+
+    // long done (or never issued)
+    std::promise<void> done;
+    done.set_value();
+    return done.get_future().share();
+}
+size_t AIOHandler::read(size_t unit, const char *key, char *buffer, size_t size, psio_address start,
+                        psio_address *end) {
+    return submit_job(unit, JobType::Read, size,
+                      [=]() { psio_->read(unit, key, buffer, size, start, end); });
+}
 size_t AIOHandler::write(size_t unit, const char *key, char *buffer, size_t size, psio_address start,
                          psio_address *end) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(2);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(buffer);
-    size_.push(size);
-    start_.push(start);
-    end_.push(end);
-    jobID_.push_back(uniqueID_);
-
-    // printf("Adding a write to the queue\n");
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // fprintf(stderr,"Starting a thread\n");
-    // thread start
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit_job(unit, JobType::Write, size,
+                      [=]() { psio_->write(unit, key, buffer, size, start, end); });
 }
 size_t AIOHandler::read_entry(size_t unit, const char *key, char *buffer, size_t size) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(3);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(buffer);
-    size_.push(size);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit_job(unit, JobType::ReadEntry, size, [=]() { psio_->read_entry(unit, key, buffer, size); });
 }
 size_t AIOHandler::write_entry(size_t unit, const char *key, char *buffer, size_t size) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(4);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(buffer);
-    size_.push(size);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit_job(unit, JobType::WriteEntry, size, [=]() { psio_->write_entry(unit, key, buffer, size); });
 }
 size_t AIOHandler::read_discont(size_t unit, const char *key, double **matrix, size_t row_length, size_t col_length,
                                 size_t col_skip, psio_address start) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(5);
-    unit_.push(unit);
-    key_.push(key);
-    matrix_.push(matrix);
-    row_length_.push(row_length);
-    col_length_.push(col_length);
-    col_skip_.push(col_skip);
-    start_.push(start);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit_job(unit, JobType::ReadDiscont, sizeof(double) * row_length * col_length, [=]() {
+        psio_address next = start;
+        for (size_t i = 0; i < row_length; i++) {
+            psio_->read(unit, key, (char *)&(matrix[i][0]), sizeof(double) * col_length, next, &next);
+            next = psio_get_address(next, sizeof(double) * col_skip);
+        }
+    });
 }
 size_t AIOHandler::write_discont(size_t unit, const char *key, double **matrix, size_t row_length, size_t col_length,
                                  size_t col_skip, psio_address start) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(6);
-    unit_.push(unit);
-    key_.push(key);
-    matrix_.push(matrix);
-    row_length_.push(row_length);
-    col_length_.push(col_length);
-    col_skip_.push(col_skip);
-    start_.push(start);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit_job(unit, JobType::WriteDiscont, sizeof(double) * row_length * col_length, [=]() {
+        psio_address next = start;
+        for (size_t i = 0; i < row_length; i++) {
+            psio_->write(unit, key, (char *)&(matrix[i][0]), sizeof(double) * col_length, next, &next);
+            next = psio_get_address(next, sizeof(double) * col_skip);
+        }
+    });
 }
 size_t AIOHandler::zero_disk(size_t unit, const char *key, size_t rows, size_t cols) {
-    std::unique_lock<std::mutex> lock(*locked_);
+    return submit_job(unit, JobType::ZeroDisk, sizeof(double) * rows * cols, [=]() {
+        double *buf = new double[cols];
+        memset(static_cast<void *>(buf), '\0', cols * sizeof(double));
 
-    ++uniqueID_;
-    job_.push(7);
-    unit_.push(unit);
-    key_.push(key);
-    row_length_.push(rows);
-    col_length_.push(cols);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
+        psio_address next_psio = PSIO_ZERO;
+        for (size_t i = 0; i < rows; i++) {
+            psio_->write(unit, key, (char *)(buf), sizeof(double) * cols, next_psio, &next_psio);
+        }
 
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+        delete[] buf;
+    });
 }
 
 size_t AIOHandler::write_iwl(size_t unit, const char *key, size_t nints, int lastbuf, char *labels, char *values,
                              size_t labsize, size_t valsize, size_t *address) {
-    std::unique_lock<std::mutex> lock(*locked_);
-    ++uniqueID_;
-    job_.push(8);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(labels);
-    buffer_.push(values);
-    size_.push(labsize);
-    size_.push(valsize);
-    nints_.push(nints);
-    lastbuf_.push(lastbuf);
-    address_.push(address);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
+    return submit_job(unit, JobType::WriteIWL, labsize + valsize + 2 * sizeof(int), [=]() {
+        // address is advanced here, jobs on a unit run in order
+        psio_address start = psio_get_address(PSIO_ZERO, *address);
+        *address += valsize + labsize + 2 * sizeof(int);
+
+        int iwl_lastbuf = lastbuf;
+        int iwl_nints = nints;
+        psio_->write(unit, key, (char *)&(iwl_lastbuf), sizeof(int), start, &start);
+        psio_->write(unit, key, (char *)&(iwl_nints), sizeof(int), start, &start);
+        psio_->write(unit, key, labels, labsize, start, &start);
+        psio_->write(unit, key, values, valsize, start, &start);
+    });
+}
 
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+std::deque<AIOHandler::Job>::iterator AIOHandler::next_job() {
+    // A busy unit blocks every later job on it, keeping per-unit order
+    return std::find_if(queue_.begin(), queue_.end(),
+                        [this](const Job &job) { return busy_units_.count(job.unit) == 0; });
 }
 
 void AIOHandler::call_aio() {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    while (job_.size() > 0) {
-        int jobtype = job_.front();
+    std::unique_lock<std::mutex> lock(lock_);
+
+    while (true) {
+        auto it = queue_.end();
+        work_ready_.wait(lock, [this, &it] {
+            it = next_job();
+            return stop_ || it != queue_.end();
+        });
+        if (it == queue_.end()) break;
+
+        Job job = std::move(*it);
+        queue_.erase(it);
+        busy_units_.insert(job.unit);
         lock.unlock();
 
-        if (jobtype == 1) {
+        try {
+            job.work();
+            job.done.set_value();
+        } catch (...) {
+            // recorded before the future is set, so a waiter woken by it can take the failure back out
+            std::exception_ptr error = std::current_exception();
             lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *buffer = buffer_.front();
-            size_t size = size_.front();
-            psio_address start = start_.front();
-            psio_address *end = end_.front();
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-            start_.pop();
-            end_.pop();
-
-            lock.unlock();
-
-            psio_->read(unit, key, buffer, size, start, end);
-        } else if (jobtype == 2) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *buffer = buffer_.front();
-            size_t size = size_.front();
-            psio_address start = start_.front();
-            psio_address *end = end_.front();
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-            start_.pop();
-            end_.pop();
-
-            // printf("Actually doing the psio_write from thread\n");
-            // printf("Unit is %d, key is %s, size is %d\n", unit, key, size);
+            errors_[job.id] = error;
             lock.unlock();
-
-            // printf("Printing number %d now\n", *((int *) buffer));
-            // std::stringstream ss;
-            // ss << thread_->get_id();
-            // fprintf(stderr,"Printing from thread %s\n", ss.str().c_str());
-            // fprintf(stderr,"Starting address is %lu, %lu\n",start.page, start.offset);
-            psio_->write(unit, key, buffer, size, start, end);
-            // fprintf(stderr,"End address is %lu, %lu\n",end->page, end->offset);
-        } else if (jobtype == 3) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *buffer = buffer_.front();
-            size_t size = size_.front();
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-
-            lock.unlock();
-
-            psio_->read_entry(unit, key, buffer, size);
-        } else if (jobtype == 4) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *buffer = buffer_.front();
-            size_t size = size_.front();
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-
-            lock.unlock();
-
-            psio_->write_entry(unit, key, buffer, size);
-        } else if (jobtype == 5) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            double **matrix = matrix_.front();
-            size_t row_length = row_length_.front();
-            size_t col_length = col_length_.front();
-            size_t col_skip = col_skip_.front();
-            psio_address start = start_.front();
-
-            unit_.pop();
-            key_.pop();
-            matrix_.pop();
-            row_length_.pop();
-            col_length_.pop();
-            col_skip_.pop();
-            start_.pop();
-
-            lock.unlock();
-
-            for (int i = 0; i < row_length; i++) {
-                psio_->read(unit, key, (char *)&(matrix[i][0]), sizeof(double) * col_length, start, &start);
-                start = psio_get_address(start, sizeof(double) * col_skip);
-            }
-        } else if (jobtype == 6) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            double **matrix = matrix_.front();
-            size_t row_length = row_length_.front();
-            size_t col_length = col_length_.front();
-            size_t col_skip = col_skip_.front();
-            psio_address start = start_.front();
-
-            unit_.pop();
-            key_.pop();
-            matrix_.pop();
-            row_length_.pop();
-            col_length_.pop();
-            col_skip_.pop();
-            start_.pop();
-
-            lock.unlock();
-
-            for (int i = 0; i < row_length; i++) {
-                psio_->write(unit, key, (char *)&(matrix[i][0]), sizeof(double) * col_length, start, &start);
-                start = psio_get_address(start, sizeof(double) * col_skip);
-            }
-        } else if (jobtype == 7) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            size_t row_length = row_length_.front();
-            size_t col_length = col_length_.front();
-
-            unit_.pop();
-            key_.pop();
-            row_length_.pop();
-            col_length_.pop();
-
-            lock.unlock();
-
-            double *buf = new double[col_length];
-            memset(static_cast<void *>(buf), '\0', col_length * sizeof(double));
-
-            psio_address next_psio = PSIO_ZERO;
-            for (int i = 0; i < row_length; i++) {
-                psio_->write(unit, key, (char *)(buf), sizeof(double) * col_length, next_psio, &next_psio);
-            }
-
-            delete[] buf;
-        } else if (jobtype == 8) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *labels = buffer_.front();
-            buffer_.pop();
-            char *values = buffer_.front();
-            size_t lab_size = size_.front();
-            size_.pop();
-            size_t val_size = size_.front();
-            int nints = nints_.front();
-            int lastbuf = lastbuf_.front();
-            size_t *address = address_.front();
-
-            psio_address start = psio_get_address(PSIO_ZERO, *address);
-            *address += val_size + lab_size + 2 * sizeof(int);
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-            nints_.pop();
-            lastbuf_.pop();
-            address_.pop();
-
-            lock.unlock();
-
-            psio_->write(unit, key, (char *)&(lastbuf), sizeof(int), start, &start);
-            psio_->write(unit, key, (char *)&(nints), sizeof(int), start, &start);
-            psio_->write(unit, key, labels, lab_size, start, &start);
-            psio_->write(unit, key, values, val_size, start, &start);
-
-        } else {
-            throw PsiException("Error in AIO: Unknown job type", __FILE__, __LINE__);
+            job.done.set_exception(error);
         }
 
         lock.lock();
-        // Only pop the job once the work is actually done and we are gonna leave the loop.
-        // This way, job_.size() == 0 indicates there is no active thread.
-        job_.pop();
-        // We also pop the jobID so that external threads may check that the job completed
-        jobID_.pop_front();
-        // Once it is popped, notify waiting threads to check again for their jobid.
-        condition_.notify_all();
+        busy_units_.erase(job.unit);
+        // Popping the ID lets waiters know the job completed
+        pending_.erase(job.id);
+        job_done_.notify_all();
+        // The unit is free again, its next job may now run
+        work_ready_.notify_all();
     }
-    // printf("End of function call_aio\n");
 }
 
 void AIOHandler::wait_for_job(size_t jobid) {
-    std::deque<size_t>::iterator it;
+    std::shared_future<void> done;
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        auto it = pending_.find(jobid);
+        if (it == pending_.end()) {
+            // already finished; hand over its failure, if any, so synchronize() won't repeat it
+            auto failed = errors_.find(jobid);
+            if (failed == errors_.end()) return;
+            std::exception_ptr error = failed->second;
+            errors_.erase(failed);
+            std::rethrow_exception(error);
+        }
+        done = it->second;
+    }
 
-    std::unique_lock<std::mutex> lock(*locked_);
-    it = std::find(jobID_.begin(), jobID_.end(), jobid);
-    bool found = it != jobID_.end();
-    while (found) {
-        condition_.wait(lock);
-        it = std::find(jobID_.begin(), jobID_.end(), jobid);
-        found = it != jobID_.end();
+    auto t_start = std::chrono::steady_clock::now();
+    done.wait();
+    std::chrono::duration<double> stall = std::chrono::steady_clock::now() - t_start;
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        stats_.stall_seconds += stall.count();
+        // the failure reaches the caller below, not synchronize()
+        errors_.erase(jobid);
     }
-    return;
+    done.get();
+}
+
+size_t AIOHandler::queue_depth() {
+    std::unique_lock<std::mutex> lock(lock_);
+    return queue_.size();
+}
+
+AIOStats AIOHandler::stats() {
+    std::unique_lock<std::mutex> lock(lock_);
+    return stats_;
+}
+
+void AIOHandler::print_stats() {
+    AIOStats current = stats();
+    outfile->Printf("  ==> AIOHandler <==\n\n");
+    outfile->Printf("    Worker threads:    %11zu\n", nthreads_);
+    outfile->Printf("    Jobs:              %11zu\n", current.jobs);
+    outfile->Printf("    Data [MiB]:        %11.1f\n", current.bytes / (1024.0 * 1024.0));
+    outfile->Printf("    Max queue depth:   %11zu\n", current.max_queue_depth);
+    outfile->Printf("    Stall time [s]:    %11.3f\n\n", current.stall_seconds);
 }
 
 }  // Namespace psi
@@ -30,9 +30,16 @@
 #define AIOHANDLER_H
 
 #include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include "config.h"
 
@@ -40,55 +47,80 @@ namespace psi {
 
 class PSIO;
 
+/// Counters accumulated over the lifetime of an AIOHandler
+struct AIOStats {
+    /// Number of jobs submitted
+    size_t jobs = 0;
+    /// Bytes requested to be read or written by those jobs
+    size_t bytes = 0;
+    /// Deepest the queue of not yet started jobs has been
+    size_t max_queue_depth = 0;
+    /// Wall time callers spent blocked in wait_for_job() and synchronize()
+    double stall_seconds = 0.0;
+};
+
 class AIOHandler {
+   public:
+    /// Kinds of job, for bookkeeping
+    enum class JobType { Read, Write, ReadEntry, WriteEntry, ReadDiscont, WriteDiscont, ZeroDisk, WriteIWL, Generic };
+
    private:
-    /// What is the job type?
-    std::queue<size_t> job_;
-    /// Unique job ID to check for job completion. Should NEVER be 0.
-    std::deque<size_t> jobID_;
-    /// Unit number argument
-    std::queue<size_t> unit_;
-    /// Entry Key (80-char) argument
-    std::queue<const char *> key_;
-    /// Memory buffer argument
-    std::queue<char *> buffer_;
-    /// Size argument
-    std::queue<size_t> size_;
-    /// Start address argument
-    std::queue<psio_address> start_;
-    /// End address pointer argument
-    std::queue<psio_address *> end_;
-    /// Matrix pointer for discontinuous I/O
-    std::queue<double **> matrix_;
-    /// Size argument for discontinuous I/O
-    std::queue<size_t> row_length_;
-    /// Size argument for discontinuous I/O
-    std::queue<size_t> col_length_;
-    /// Size argument for discontinuous I/O
-    std::queue<size_t> col_skip_;
-    /// For IWL: number of ints in the buffer
-    std::queue<int> nints_;
-    /// For IWL: is this the last buffer ?
-    std::queue<int> lastbuf_;
-    /// For IWL: pointer to current position in file
-    std::queue<size_t *> address_;
+    /// A queued unit of work. Jobs on the same unit run in submission order,
+    /// jobs on different units may run concurrently on separate workers.
+    struct Job {
+        /// Unique job ID to check for job completion. Never 0.
+        size_t id;
+        /// Unit the job touches
+        size_t unit;
+        JobType type;
+        /// Bytes moved, for the statistics
+        size_t bytes;
+        /// The I/O itself
+        std::function<void()> work;
+        /// Fulfilled (or given the exception) when work returns
+        std::promise<void> done;
+    };
+
     /// PSIO object this AIO_Handler is built on
     std::shared_ptr<PSIO> psio_;
-    /// Thread this AIO_Handler is currently running on
-    std::shared_ptr<std::thread> thread_;
+    /// Number of worker threads to run at most
+    size_t nthreads_;
+    /// Worker threads, started on demand
+    std::vector<std::thread> workers_;
+    /// Jobs waiting for a worker
+    std::deque<Job> queue_;
+    /// Units with a job currently running
+    std::set<size_t> busy_units_;
+    /// Futures of jobs queued or running, by ID
+    std::map<size_t, std::shared_future<void>> pending_;
+    /// Exceptions of failed jobs nobody has waited on, by ID. The first one is
+    /// rethrown by synchronize(); wait_for_job() takes its job's out.
+    std::map<size_t, std::exception_ptr> errors_;
     /// Lock variable
-    std::mutex *locked_;
+    std::mutex lock_;
+    /// Signals workers that a job may have become runnable
+    std::condition_variable work_ready_;
+    /// Signals waiters that a job has finished
+    std::condition_variable job_done_;
+    /// Set by the destructor to retire the workers
+    bool stop_;
     /// Latest unique job ID
     size_t uniqueID_;
-    /// condition variable to wait for a specific job to finish
-    std::condition_variable condition_;
+    AIOStats stats_;
+
+    /// Queue a job, returning its ID. Caller must not hold the lock.
+    size_t submit_job(size_t unit, JobType type, size_t bytes, std::function<void()> work);
+    /// First queued job whose unit is not busy, or queue_.end(). Caller must hold the lock.
+    std::deque<Job>::iterator next_job();
 
    public:
     /// AIO_Handlers are constructed around a synchronous PSIO object
-    AIOHandler(std::shared_ptr<PSIO> psio);
+    /// @param nthreads number of jobs (on distinct units) that may be in flight at once
+    AIOHandler(std::shared_ptr<PSIO> psio, size_t nthreads = 1);
     /// Destructor
     ~AIOHandler();
-    /// When called, synchronize will not return until all requested data has been read or written
+    /// When called, synchronize will not return until all requested data has been read or written.
+    /// Rethrows the first exception raised by a job since the last call.
     void synchronize();
     /// Asynchronous read, same as PSIO::read, but nonblocking
     size_t read(size_t unit, const char *key, char *buffer, size_t size, psio_address start, psio_address *end);
@@ -133,12 +165,29 @@ class AIOHandler {
     /// counting the number of integrals in the current buffer
     size_t write_iwl(size_t unit, const char *key, size_t nints, int lastbuf, char *labels, char *values,
                      size_t labsize, size_t valsize, size_t *address);
-    /// Generic function bound to thread internally
+
+    /// Queue arbitrary work against a unit, ordered with the other jobs on that unit
+    /// @param bytes size of the transfer, for the statistics only
+    /// @return a future that becomes ready (or carries the exception) when the work is done
+    std::shared_future<void> submit(size_t unit, std::function<void()> work, size_t bytes = 0);
+
+    /// Future for a previously returned job ID. Jobs that already finished give a ready future.
+    std::shared_future<void> future(size_t jobid);
+
+    /// Worker loop bound to each thread internally
     void call_aio();
 
     /// Function that checks if a job has been completed using the JobID.
-    /// The function only returns when the job is completed.
+    /// The function only returns when the job is completed, and rethrows
+    /// any exception the job raised.
     void wait_for_job(size_t jobid);
+
+    /// Number of jobs queued but not yet started
+    size_t queue_depth();
+    /// Snapshot of the counters
+    AIOStats stats();
+    /// Print the counters to the output file
+    void print_stats();
 };
 
 }  // namespace psi
@@ -46,6 +46,8 @@
 #include <cstdlib>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/memstore.h"
+#include "psi4/libpsio/zstore.h"
 #include "psi4/psi4-dec.h"
 namespace psi {
 
@@ -62,6 +64,28 @@ void PSIO::close(size_t unit, int keep) {
     /* Dump the current TOC back out to disk */
     tocwrite(unit);
 
+    /* Write a memory-resident unit out if it is to be kept */
+    if (memstores_[unit]) {
+        if (keep) {
+            memstores_[unit]->materialize();
+            wt_toclen(unit, this_unit->toclen);
+        }
+        memstores_[unit].reset();
+    }
+
+    /* Unpack a compressed unit into the volumes if it is to be kept. Page 0 of
+       the store holds a stale copy of the TOC length, so rewrite it afterwards. */
+    if (zstores_[unit]) {
+        if (keep) {
+            zstores_[unit]->materialize([this, unit](char *buffer, psio_address address, size_t size) {
+                rw_volumes(unit, buffer, address, size, 1);
+            });
+            wt_toclen(unit, this_unit->toclen);
+        }
+        PSIOManager::shared_object()->close_file(zstores_[unit]->path(), unit, false);
+        zstores_[unit].reset();
+    }
+
     /* Free the TOC */
     this_entry = this_unit->toc;
     for (i = 0; i < this_unit->toclen; i++) {
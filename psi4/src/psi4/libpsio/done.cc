@@ -39,6 +39,9 @@ PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 PRAGMA_WARNING_POP
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/memstore.h"
+#include "psi4/libpsio/zstore.h"
+#include "psi4/libpsio/volworker.h"
 
 #ifdef PSIO_STATS
 #include <ctime>
@@ -74,6 +77,10 @@ PSIO::~PSIO() {
     free(psio_writlen);
 #endif
 
+    volume_workers_.clear();
+    zstores_.clear();
+    memstores_.clear();
+    arena_.reset();
     free(psio_unit);
     state_ = 0;
     files_keywords_.clear();
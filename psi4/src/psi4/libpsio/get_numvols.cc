@@ -58,6 +58,19 @@ size_t PSIO::get_numvols(size_t unit) {
     abort();
 }
 
+bool PSIO::get_unit_flag(size_t unit, const char *kwd) {
+    std::string value;
+    value = filecfg_kwd("PSI", kwd, unit);
+    if (value.empty()) value = filecfg_kwd("PSI", kwd, -1);
+    if (value.empty()) value = filecfg_kwd("DEFAULT", kwd, unit);
+    if (value.empty()) value = filecfg_kwd("DEFAULT", kwd, -1);
+    return (value == "TRUE" || value == "1");
+}
+
+void PSIO::set_compression(int unit, bool compress) { filecfg_kwd("PSI", "COMPRESS", unit, (compress ? "TRUE" : "FALSE")); }
+
+void PSIO::set_memory_volume(int unit, bool memvol) { filecfg_kwd("PSI", "MEMVOL", unit, (memvol ? "TRUE" : "FALSE")); }
+
 size_t psio_get_numvols_default() {
     std::string charnum;
 
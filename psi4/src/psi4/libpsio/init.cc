@@ -36,6 +36,9 @@
 #include <sstream>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/memstore.h"
+#include "psi4/libpsio/zstore.h"
+#include "psi4/libpsio/volworker.h"
 #include "psi4/pragma.h"
 PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
@@ -58,6 +61,15 @@ PSIO::PSIO() {
     int i, j;
 
     psio_unit = (psio_ud *)malloc(sizeof(psio_ud) * PSIO_MAXUNIT);
+    for (i = 0; i < 2; i++) {
+        rw_bytes_[i].assign(PSIO_MAXUNIT, 0);
+        rw_seconds_[i].assign(PSIO_MAXUNIT, 0.0);
+    }
+    zstores_.resize(PSIO_MAXUNIT);
+    memstores_.resize(PSIO_MAXUNIT);
+    arena_.reset(new PSIOArena());
+    for (i = 1; i < PSIO_MAXVOL; i++) volume_workers_.emplace_back(new PSIOVolumeWorker());
+    memvol_cap_set_ = false;
 #ifdef PSIO_STATS
     psio_readlen = (size_t *)malloc(sizeof(size_t) * PSIO_MAXUNIT);
     psio_writlen = (size_t *)malloc(sizeof(size_t) * PSIO_MAXUNIT);
@@ -0,0 +1,179 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#ifndef _MSC_VER
+#include <sys/mman.h>
+#endif
+
+#include "psi4/libpsio/memstore.h"
+
+namespace psi {
+
+PSIOArena::PSIOArena() : cap_(0), used_(0) {}
+
+PSIOArena::~PSIOArena() { free_chunks(); }
+
+void PSIOArena::free_chunks() {
+    for (auto &chunk : chunks_) {
+#ifdef _MSC_VER
+        ::free(chunk.first);
+#else
+        if (chunk.second)
+            ::munmap(chunk.first, chunk_size_);
+        else
+            ::free(chunk.first);
+#endif
+    }
+    chunks_.clear();
+    free_.clear();
+}
+
+char *PSIOArena::allocate() {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (used_ + PSIO_PAGELEN > cap_) return nullptr;
+
+    if (free_.empty()) {
+        char *chunk = nullptr;
+        bool mapped = false;
+#ifndef _MSC_VER
+        // Explicit huge pages first, then transparent ones, then plain memory
+        void *ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        ptr = ::mmap(nullptr, chunk_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (ptr == MAP_FAILED) {
+            ptr = ::mmap(nullptr, chunk_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+            if (ptr != MAP_FAILED) ::madvise(ptr, chunk_size_, MADV_HUGEPAGE);
+#endif
+        }
+        if (ptr != MAP_FAILED) {
+            chunk = (char *)ptr;
+            mapped = true;
+        }
+#endif
+        if (chunk == nullptr) chunk = (char *)::malloc(chunk_size_);
+        if (chunk == nullptr) return nullptr;
+        chunks_.push_back(std::make_pair(chunk, mapped));
+        for (size_t off = chunk_size_; off > 0; off -= PSIO_PAGELEN) free_.push_back(chunk + off - PSIO_PAGELEN);
+    }
+
+    char *page = free_.back();
+    free_.pop_back();
+    used_ += PSIO_PAGELEN;
+    return page;
+}
+
+void PSIOArena::release(char *page) {
+    std::lock_guard<std::mutex> guard(lock_);
+    free_.push_back(page);
+    used_ -= PSIO_PAGELEN;
+    if (!used_) free_chunks();
+}
+
+PSIOMemStore::PSIOMemStore(PSIOArena *arena, size_t limit, VolumeIO volumes)
+    : arena_(arena), disk_end_(limit), volumes_(volumes), resident_(0), spilled_(0) {}
+
+PSIOMemStore::~PSIOMemStore() {
+    for (char *page : pages_)
+        if (page != nullptr) arena_->release(page);
+}
+
+void PSIOMemStore::read_disk(size_t page, char *dst) {
+    size_t first = page * PSIO_PAGELEN;
+    size_t ondisk = (first < disk_end_ ? std::min((size_t)PSIO_PAGELEN, disk_end_ - first) : 0);
+    if (ondisk) {
+        psio_address address = {page, 0};
+        volumes_(dst, address, ondisk, 0);
+    }
+    std::memset(dst + ondisk, '\0', PSIO_PAGELEN - ondisk);
+}
+
+char *PSIOMemStore::resident(size_t page) {
+    if (page < pages_.size() && pages_[page] != nullptr) return pages_[page];
+
+    char *data = arena_->allocate();
+    if (data == nullptr) return nullptr;
+    read_disk(page, data);
+    if (page >= pages_.size()) pages_.resize(std::max(page + 1, 2 * pages_.size()), nullptr);
+    pages_[page] = data;
+    resident_++;
+    return data;
+}
+
+void PSIOMemStore::rw(char *buffer, psio_address address, size_t size, int wrt) {
+    std::lock_guard<std::mutex> guard(lock_);
+    size_t page = address.page;
+    size_t offset = address.offset;
+    size_t done = 0;
+    while (done < size) {
+        size_t len = std::min((size_t)PSIO_PAGELEN - offset, size - done);
+        char *data = resident(page);
+        if (data != nullptr) {
+            if (wrt)
+                std::memcpy(data + offset, &buffer[done], len);
+            else
+                std::memcpy(&buffer[done], data + offset, len);
+        } else {
+            // arena is full, this page lives on disk
+            psio_address spill = {page, offset};
+            if (wrt) {
+                volumes_(&buffer[done], spill, len, 1);
+                disk_end_ = std::max(disk_end_, page * PSIO_PAGELEN + offset + len);
+                spilled_ += len;
+            } else {
+                size_t first = page * PSIO_PAGELEN + offset;
+                size_t ondisk = (first < disk_end_ ? std::min(len, disk_end_ - first) : 0);
+                if (ondisk) volumes_(&buffer[done], spill, ondisk, 0);
+                std::memset(&buffer[done + ondisk], '\0', len - ondisk);
+            }
+        }
+        done += len;
+        offset = 0;
+        page++;
+    }
+}
+
+void PSIOMemStore::materialize() {
+    std::lock_guard<std::mutex> guard(lock_);
+    for (size_t page = 0; page < pages_.size(); page++) {
+        if (pages_[page] == nullptr) continue;
+        psio_address address = {page, 0};
+        volumes_(pages_[page], address, PSIO_PAGELEN, 1);
+    }
+}
+
+}  // namespace psi
@@ -0,0 +1,123 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_memstore_h_
+#define _psi_src_lib_libpsio_memstore_h_
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "psi4/libpsio/config.h"
+
+namespace psi {
+
+/*!
+ * Pool of PSIO_PAGELEN pages shared by all memory-resident units.
+ *
+ * Pages are carved out of large chunks, which are requested as huge pages
+ * where the OS allows it. The pool never holds more than cap bytes of pages;
+ * once it is full, allocate() returns nullptr and the caller spills to disk.
+ * Chunks are returned to the OS when the last page is released.
+ */
+class PSIOArena {
+   public:
+    PSIOArena();
+    ~PSIOArena();
+
+    /// A free page, or nullptr if the cap has been reached
+    char *allocate();
+    /// Return a page obtained from allocate()
+    void release(char *page);
+
+    void set_cap(size_t cap) { cap_ = cap; }
+    size_t cap() const { return cap_; }
+    /// Bytes of pages currently handed out
+    size_t used() const { return used_; }
+
+   private:
+    /// Bytes per chunk, a multiple of the 2 MiB huge page size
+    static const size_t chunk_size_ = 256 * (size_t)PSIO_PAGELEN;
+
+    size_t cap_;
+    size_t used_;
+    std::vector<std::pair<char *, bool>> chunks_;
+    std::vector<char *> free_;
+    std::mutex lock_;
+
+    void free_chunks();
+};
+
+/*!
+ * RAM-resident contents of one PSIO unit.
+ *
+ * Each page of the unit lives either in the arena or, if the arena was full
+ * when the page was first touched, in the unit's disk volumes. Pages already
+ * on disk when the unit was opened are pulled into memory on first access.
+ */
+class PSIOMemStore {
+   public:
+    typedef std::function<void(char *, psio_address, size_t, int)> VolumeIO;
+
+    /// @param arena   page pool to draw from
+    /// @param limit   global byte offset up to which the disk volumes hold data
+    /// @param volumes rw on the disk volumes of the unit
+    PSIOMemStore(PSIOArena *arena, size_t limit, VolumeIO volumes);
+    /// Returns all pages to the arena
+    ~PSIOMemStore();
+
+    /// Same contract as PSIO::rw, on global addresses
+    void rw(char *buffer, psio_address address, size_t size, int wrt);
+    /// Write all resident pages to the disk volumes
+    void materialize();
+
+    /// Bytes held in memory
+    size_t resident_bytes() const { return resident_ * (size_t)PSIO_PAGELEN; }
+    /// Bytes that went to disk because the arena was full
+    size_t spilled_bytes() const { return spilled_; }
+
+   private:
+    PSIOArena *arena_;
+    /// Bytes below this global offset may be on disk
+    size_t disk_end_;
+    VolumeIO volumes_;
+    /// Resident page by page number, nullptr if on disk (or never written)
+    std::vector<char *> pages_;
+    size_t resident_;
+    size_t spilled_;
+    std::mutex lock_;
+
+    /// Fill dst with page, as far as it is on disk
+    void read_disk(size_t page, char *dst);
+    /// The resident copy of page, bringing it in if the arena has room, else nullptr
+    char *resident(size_t page);
+};
+
+}  // namespace psi
+
+#endif
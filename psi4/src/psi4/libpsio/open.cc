@@ -55,6 +55,9 @@
 #include <sstream>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/memstore.h"
+#include "psi4/libpsio/zstore.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/psi4-dec.h"
 namespace psi {
 
@@ -139,6 +142,25 @@ void PSIO::open(size_t unit, int status) {
     } else
         psio_error(unit, PSIO_ERROR_OSTAT);
 
+    /* From here on, route the unit through memory or a compressed store if
+       requested. Existing data is picked up from the volumes as it is first touched. */
+    size_t limit = sizeof(size_t);
+    psio_tocentry* last = toclast(unit);
+    if (last != nullptr) limit = last->eadd.page * PSIO_PAGELEN + last->eadd.offset;
+    if (get_unit_flag(unit, "MEMVOL")) {
+        if (!memvol_cap_set_) arena_->set_cap(Process::environment.get_memory() / 4);
+        memstores_[unit].reset(new PSIOMemStore(arena_.get(), limit,
+                                                [this, unit](char* buffer, psio_address address, size_t size, int wrt) {
+                                                    rw_volumes(unit, buffer, address, size, wrt);
+                                                }));
+    } else if (get_unit_flag(unit, "COMPRESS")) {
+        std::string zpath = std::string(this_unit->vol[0].path) + ".z";
+        PSIOManager::shared_object()->open_file(zpath, unit);
+        zstores_[unit].reset(new PSIOZStore(unit, zpath, limit, [this, unit](char* buffer, psio_address address, size_t size) {
+            rw_volumes(unit, buffer, address, size, 0);
+        }));
+    }
+
     free(name);
 }
 
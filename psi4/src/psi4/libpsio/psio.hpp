@@ -34,6 +34,8 @@
 #include <set>
 #include <queue>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "psi4/libpsio/config.h"
 
@@ -41,6 +43,10 @@ namespace psi {
 
 class PSIO;
 class PSIOManager;
+class PSIOZStore;
+class PSIOMemStore;
+class PSIOArena;
+class PSIOVolumeWorker;
 extern PSI_API std::shared_ptr<PSIO> _default_psio_lib_;
 extern PSI_API std::shared_ptr<PSIOManager> _default_psio_manager_;
 
@@ -211,7 +217,9 @@ public:
        PSIO understands the following keywords: "name" (specifies the prefix for the filename,
        i.e. if name is set to "psi" then unit 35 will be named "psi.35"), "nvolume" (number of files over which
        to stripe this unit, cannot be greater than PSIO_MAXVOL), "volumeX", where X is a positive integer less than or equal to
-       the value of "nvolume".
+       the value of "nvolume", "compress" (if "true", data written while the unit is open is kept compressed in a
+       sidecar file and only written out to the volumes when the unit is closed and kept), "memvol" (if "true", the
+       unit is held in memory while open and only spills pages to the volumes once the memory volume cap is reached).
        */
     void filecfg_kwd(const char* kwdgrp, const char* kwd, int unit,
                      const char* kwdval);
@@ -289,6 +297,20 @@ public:
     void rw(size_t unit, char *buffer, psio_address address, size_t size,
             int wrt);
 
+    /// Bytes moved through rw() for a unit since the library was created (wrt selects writes)
+    size_t rw_bytes(size_t unit, bool wrt);
+    /// Wall time in seconds spent in rw() for a unit since the library was created (wrt selects writes)
+    double rw_seconds(size_t unit, bool wrt);
+    /// Print the per-unit rw() volume and achieved bandwidth to the output file
+    void print_rw_stats();
+    /// Keep unit compressed while it is open (takes effect the next time the unit is opened). Shorthand for the "compress" keyword.
+    void set_compression(int unit, bool compress);
+    /// Hold unit in memory while it is open (takes effect the next time the unit is opened). Shorthand for the "memvol" keyword.
+    void set_memory_volume(int unit, bool memvol);
+    /// Total bytes all memory volumes may hold before spilling to disk. Defaults to a quarter of the memory setting.
+    void set_memory_volume_cap(size_t bytes);
+    size_t get_memory_volume_cap();
+
     /// Delete all TOC entries after the given key. If a blank key is given, the entire TOC will be wiped.
     void tocclean(size_t unit, const char *key);
     /// Print the table of contents for the given unit
@@ -353,6 +375,25 @@ private:
     size_t *psio_writlen;
 #endif
 
+    /// rw() traffic per unit, index 0 for reads and 1 for writes
+    std::vector<size_t> rw_bytes_[2];
+    std::vector<double> rw_seconds_[2];
+    std::mutex rw_stats_lock_;
+
+    /// Compressed stores of the open units that have the "compress" keyword set
+    std::vector<std::unique_ptr<PSIOZStore>> zstores_;
+    /// Threads serving volumes 1 .. PSIO_MAXVOL - 1 of striped requests; volume 0 is done by the caller
+    std::vector<std::unique_ptr<PSIOVolumeWorker>> volume_workers_;
+    /// rw() on the volumes of unit, bypassing any compressed store
+    void rw_volumes(size_t unit, char *buffer, psio_address address, size_t size, int wrt);
+    /// RAM-resident units that have the "memvol" keyword set, sharing arena_
+    std::vector<std::unique_ptr<PSIOMemStore>> memstores_;
+    std::unique_ptr<PSIOArena> arena_;
+    /// whether the arena cap was set explicitly, rather than following the memory setting
+    bool memvol_cap_set_;
+    /// whether boolean keyword kwd ("compress", "memvol") is set for unit
+    bool get_unit_flag(size_t unit, const char *kwd);
+
     /// Library state variable
     int state_;
     /// return the number of volumes over which unit will be striped
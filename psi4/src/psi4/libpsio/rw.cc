@@ -31,98 +31,238 @@
  \ingroup PSIO
  */
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
 #include <cstdio>
+#include <future>
+#include <vector>
 #ifdef _MSC_VER
 #include <io.h>
 #define SYSTEM_READ ::_read
 #define SYSTEM_WRITE ::_write
+#define SYSTEM_LSEEK ::_lseeki64
 #else
+#include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
-#define SYSTEM_READ ::read
-#define SYSTEM_WRITE ::write
 #endif
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/memstore.h"
+#include "psi4/libpsio/zstore.h"
+#include "psi4/libpsio/volworker.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/psi4-dec.h"
 
+/* Most iovecs handed to a single preadv()/pwritev() call */
+#ifdef IOV_MAX
+#define PSIO_IOV_MAX IOV_MAX
+#else
+#define PSIO_IOV_MAX 16
+#endif
+
 namespace psi {
 
-void PSIO::rw(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
-    int errcod;
-    size_t i;
-    size_t errcod_uli;
-    size_t page, offset;
-    size_t buf_offset;
-    size_t this_page, this_page_max, this_page_total;
-    size_t first_vol, this_vol, numvols;
-    size_t bytes_left, num_full_pages;
-    psio_ud *this_unit;
-
-    this_unit = &(psio_unit[unit]);
-    numvols = this_unit->numvols;
-    page = address.page;
-    offset = address.offset;
-
-    /* Seek all volumes to correct starting positions */
-    first_vol = page % numvols;
-    errcod = psio_volseek(&(this_unit->vol[first_vol]), page, offset, numvols);
-    if (errcod == -1) psio_error(unit, PSIO_ERROR_LSEEK);
-    for (i = 1, this_page = page + 1; i < numvols; i++, this_page++) {
-        this_vol = this_page % numvols;
-        errcod = psio_volseek(&(this_unit->vol[this_vol]), this_page, (size_t)0, numvols);
-        if (errcod == -1) psio_error(unit, PSIO_ERROR_LSEEK);
+namespace {
+
+/* The part of a request that lands on one volume. Consecutive pages of a
+ * volume are adjacent in its file, so this is a single contiguous file region
+ * gathered from (scattered to) every numvols-th page of the caller's buffer. */
+struct psio_extent {
+    int stream = -1;
+    size_t file_offset = 0;
+#ifdef _MSC_VER
+    std::vector<std::pair<char *, size_t>> iov;
+#else
+    std::vector<struct iovec> iov;
+#endif
+};
+
+/* Move one extent, resuming after short transfers. Returns false on failure. */
+bool psio_transfer_extent(psio_extent &ext, int wrt) {
+#ifdef _MSC_VER
+    if (SYSTEM_LSEEK(ext.stream, (__int64)ext.file_offset, SEEK_SET) == -1) return false;
+    for (auto &chunk : ext.iov) {
+        size_t done = 0;
+        while (done < chunk.second) {
+            int len = (int)std::min(chunk.second - done, (size_t)INT_MAX);
+            int got = (wrt ? SYSTEM_WRITE(ext.stream, chunk.first + done, len)
+                           : SYSTEM_READ(ext.stream, chunk.first + done, len));
+            if (got <= 0) return false;
+            done += got;
+        }
     }
+    return true;
+#else
+    size_t first = 0;
+    off_t pos = (off_t)ext.file_offset;
+    while (first < ext.iov.size()) {
+        int count = (int)std::min(ext.iov.size() - first, (size_t)PSIO_IOV_MAX);
+        ssize_t done = (wrt ? ::pwritev(ext.stream, &ext.iov[first], count, pos)
+                            : ::preadv(ext.stream, &ext.iov[first], count, pos));
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return false;
+        pos += done;
 
-    /* Number of bytes left on the first page */
-    this_page_max = PSIO_PAGELEN - offset;
+        /* skip the completed iovecs and trim a partially completed one */
+        size_t left = (size_t)done;
+        while (first < ext.iov.size() && left >= ext.iov[first].iov_len) {
+            left -= ext.iov[first].iov_len;
+            first++;
+        }
+        if (left) {
+            ext.iov[first].iov_base = (char *)ext.iov[first].iov_base + left;
+            ext.iov[first].iov_len -= left;
+        }
+    }
+    return true;
+#endif
+}
+
+}  // namespace
 
-    /* If we have enough room on this page, use it */
-    if (size <= this_page_max)
-        this_page_total = size;
+void PSIO::rw(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
+    auto t_start = std::chrono::steady_clock::now();
+
+    if (memstores_[unit])
+        memstores_[unit]->rw(buffer, address, size, wrt);
+    else if (zstores_[unit])
+        zstores_[unit]->rw(buffer, address, size, wrt);
     else
-        this_page_total = this_page_max;
-    buf_offset = 0;
-    if (wrt) {
-        errcod_uli = SYSTEM_WRITE(this_unit->vol[first_vol].stream, &(buffer[buf_offset]), this_page_total);
-        if (errcod_uli != this_page_total) psio_error(unit, PSIO_ERROR_WRITE);
-    } else {
-        errcod_uli = SYSTEM_READ(this_unit->vol[first_vol].stream, &(buffer[buf_offset]), this_page_total);
-        if (errcod_uli != this_page_total) psio_error(unit, PSIO_ERROR_READ);
-    }
+        rw_volumes(unit, buffer, address, size, wrt);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t_start;
+    std::lock_guard<std::mutex> lock(rw_stats_lock_);
+    rw_bytes_[wrt ? 1 : 0][unit] += size;
+    rw_seconds_[wrt ? 1 : 0][unit] += elapsed.count();
+}
 
-    /* Total number of bytes remaining to be read/written */
-    bytes_left = size - this_page_total;
-
-    /* Read/Write all the full pages */
-    num_full_pages = bytes_left / PSIO_PAGELEN;
-    buf_offset += this_page_total;
-    for (i = 0, this_page = page + 1; i < num_full_pages; i++, this_page++) {
-        this_vol = this_page % numvols;
-        this_page_total = PSIO_PAGELEN;
-        if (wrt) {
-            errcod_uli = SYSTEM_WRITE(this_unit->vol[this_vol].stream, &(buffer[buf_offset]), this_page_total);
-            if (errcod_uli != this_page_total) psio_error(unit, PSIO_ERROR_WRITE);
+void PSIO::rw_volumes(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
+    psio_ud *this_unit = &(psio_unit[unit]);
+    size_t numvols = this_unit->numvols;
+
+    /* Split the request into one extent per volume, coalescing pages that
+       are also adjacent in the buffer (always the case for a single volume) */
+    std::vector<psio_extent> extents(numvols);
+    size_t this_page = address.page;
+    size_t page_offset = address.offset;
+    size_t buf_offset = 0;
+    size_t bytes_left = size;
+    while (bytes_left) {
+        size_t this_page_total = std::min(PSIO_PAGELEN - page_offset, bytes_left);
+        psio_extent &ext = extents[this_page % numvols];
+        char *chunk = &(buffer[buf_offset]);
+        if (ext.iov.empty()) {
+            ext.stream = this_unit->vol[this_page % numvols].stream;
+            ext.file_offset = (this_page / numvols) * PSIO_PAGELEN + page_offset;
+        }
+#ifdef _MSC_VER
+        if (!ext.iov.empty() && ext.iov.back().first + ext.iov.back().second == chunk)
+            ext.iov.back().second += this_page_total;
+        else
+            ext.iov.push_back(std::make_pair(chunk, this_page_total));
+#else
+        if (!ext.iov.empty() && (char *)ext.iov.back().iov_base + ext.iov.back().iov_len == chunk) {
+            ext.iov.back().iov_len += this_page_total;
         } else {
-            errcod_uli = SYSTEM_READ(this_unit->vol[this_vol].stream, &(buffer[buf_offset]), this_page_total);
-            if (errcod_uli != this_page_total) psio_error(unit, PSIO_ERROR_READ);
+            struct iovec vec;
+            vec.iov_base = chunk;
+            vec.iov_len = this_page_total;
+            ext.iov.push_back(vec);
         }
+#endif
         buf_offset += this_page_total;
+        bytes_left -= this_page_total;
+        page_offset = 0;
+        this_page++;
     }
 
-    /* Read/Write the final partial page */
-    bytes_left -= num_full_pages * PSIO_PAGELEN;
-    this_vol = this_page % numvols;
-    if (bytes_left) {
-        if (wrt) {
-            errcod_uli = SYSTEM_WRITE(this_unit->vol[this_vol].stream, &(buffer[buf_offset]), bytes_left);
-            if (errcod_uli != bytes_left) psio_error(unit, PSIO_ERROR_WRITE);
-        } else {
-            errcod_uli = SYSTEM_READ(this_unit->vol[this_vol].stream, &(buffer[buf_offset]), bytes_left);
-            if (errcod_uli != bytes_left) psio_error(unit, PSIO_ERROR_READ);
+    /* Drive the volumes concurrently: the calling thread takes the first one,
+       the persistent worker of each further volume the others */
+    std::vector<size_t> active;
+    for (size_t vol = 0; vol < numvols; vol++)
+        if (!extents[vol].iov.empty()) active.push_back(vol);
+
+    bool success = true;
+    if (active.size() > 1) {
+        std::vector<std::future<bool>> pending;
+        for (size_t i = 1; i < active.size(); i++) {
+            psio_extent *ext = &extents[active[i]];
+            pending.push_back(volume_workers_[active[i] - 1]->submit(
+                [ext, wrt]() { return psio_transfer_extent(*ext, wrt); }));
         }
+        success = psio_transfer_extent(extents[active[0]], wrt);
+        for (auto &job : pending) success = job.get() && success;
+    } else if (active.size() == 1) {
+        success = psio_transfer_extent(extents[active[0]], wrt);
     }
+    if (!success) psio_error(unit, (wrt ? PSIO_ERROR_WRITE : PSIO_ERROR_READ));
+}
+
+size_t PSIO::rw_bytes(size_t unit, bool wrt) {
+    std::lock_guard<std::mutex> lock(rw_stats_lock_);
+    return rw_bytes_[wrt ? 1 : 0][unit];
 }
 
+double PSIO::rw_seconds(size_t unit, bool wrt) {
+    std::lock_guard<std::mutex> lock(rw_stats_lock_);
+    return rw_seconds_[wrt ? 1 : 0][unit];
+}
+
+void PSIO::print_rw_stats() {
+    std::lock_guard<std::mutex> lock(rw_stats_lock_);
+    outfile->Printf("\n  ==> PSIO Throughput <==\n\n");
+    outfile->Printf("    Unit    Read [MiB]   Read [MiB/s]   Write [MiB]  Write [MiB/s]\n");
+    outfile->Printf("    -------------------------------------------------------------\n");
+    const double MiB = 1024.0 * 1024.0;
+    for (size_t unit = 0; unit < PSIO_MAXUNIT; unit++) {
+        if (!rw_bytes_[0][unit] && !rw_bytes_[1][unit]) continue;
+        double rd = rw_bytes_[0][unit] / MiB;
+        double wt = rw_bytes_[1][unit] / MiB;
+        double rd_bw = (rw_seconds_[0][unit] > 0.0 ? rd / rw_seconds_[0][unit] : 0.0);
+        double wt_bw = (rw_seconds_[1][unit] > 0.0 ? wt / rw_seconds_[1][unit] : 0.0);
+        outfile->Printf("    %4zu  %12.1f  %13.1f  %12.1f  %13.1f\n", unit, rd, rd_bw, wt, wt_bw);
+    }
+    outfile->Printf("    -------------------------------------------------------------\n\n");
+
+    bool header = false;
+    for (size_t unit = 0; unit < PSIO_MAXUNIT; unit++) {
+        if (!zstores_[unit] || !zstores_[unit]->raw_bytes()) continue;
+        if (!header) {
+            outfile->Printf("    Unit     Raw [MiB]  Stored [MiB]   Ratio\n");
+            outfile->Printf("    --------------------------------------\n");
+            header = true;
+        }
+        double raw = zstores_[unit]->raw_bytes() / MiB;
+        double stored = zstores_[unit]->stored_bytes() / MiB;
+        outfile->Printf("    %4zu  %12.1f  %12.1f  %6.2f\n", unit, raw, stored, (stored > 0.0 ? raw / stored : 0.0));
+    }
+    if (header) outfile->Printf("    --------------------------------------\n\n");
+
+    header = false;
+    for (size_t unit = 0; unit < PSIO_MAXUNIT; unit++) {
+        if (!memstores_[unit]) continue;
+        if (!header) {
+            outfile->Printf("    Memory volumes (cap %.1f MiB)\n", arena_->cap() / MiB);
+            outfile->Printf("    Unit  Resident [MiB]  Spilled [MiB]\n");
+            outfile->Printf("    ----------------------------------\n");
+            header = true;
+        }
+        outfile->Printf("    %4zu  %14.1f  %13.1f\n", unit, memstores_[unit]->resident_bytes() / MiB,
+                        memstores_[unit]->spilled_bytes() / MiB);
+    }
+    if (header) outfile->Printf("    ----------------------------------\n\n");
+}
+
+void PSIO::set_memory_volume_cap(size_t bytes) {
+    arena_->set_cap(bytes);
+    memvol_cap_set_ = true;
+}
+
+size_t PSIO::get_memory_volume_cap() { return arena_->cap(); }
+
 /*!
  ** PSIO_RW(): Central function for all reads and writes on a PSIO unit.
  **
@@ -0,0 +1,74 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include "psi4/libpsio/volworker.h"
+
+namespace psi {
+
+PSIOVolumeWorker::PSIOVolumeWorker() : stop_(false) {}
+
+PSIOVolumeWorker::~PSIOVolumeWorker() {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+std::future<bool> PSIOVolumeWorker::submit(std::function<bool()> job) {
+    std::packaged_task<bool()> task(std::move(job));
+    std::future<bool> result = task.get_future();
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        queue_.push_back(std::move(task));
+        if (!thread_.joinable()) thread_ = std::thread(&PSIOVolumeWorker::run, this);
+    }
+    wake_.notify_one();
+    return result;
+}
+
+void PSIOVolumeWorker::run() {
+    std::unique_lock<std::mutex> guard(lock_);
+    while (true) {
+        wake_.wait(guard, [this]() { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        std::packaged_task<bool()> task = std::move(queue_.front());
+        queue_.pop_front();
+        guard.unlock();
+        task();
+        guard.lock();
+    }
+}
+
+}  // namespace psi
@@ -0,0 +1,68 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_volworker_h_
+#define _psi_src_lib_libpsio_volworker_h_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace psi {
+
+/*!
+ * Persistent thread that moves the part of striped requests landing on one
+ * volume. PSIO owns one per volume beyond the first. The thread is started by
+ * the first job, so units on a single volume never pay for it, and it is
+ * joined when the PSIO object is destroyed.
+ */
+class PSIOVolumeWorker {
+   public:
+    PSIOVolumeWorker();
+    /// Finishes the queued jobs and joins the thread
+    ~PSIOVolumeWorker();
+
+    /// Queue job; the future holds whether it succeeded
+    std::future<bool> submit(std::function<bool()> job);
+
+   private:
+    std::mutex lock_;
+    std::condition_variable wake_;
+    std::deque<std::packaged_task<bool()>> queue_;
+    bool stop_;
+    std::thread thread_;
+
+    void run();
+};
+
+}  // namespace psi
+
+#endif
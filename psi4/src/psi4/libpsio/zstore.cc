@@ -0,0 +1,283 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#ifdef _MSC_VER
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/zstore.h"
+
+namespace psi {
+
+namespace {
+
+/* Positioned IO on the sidecar, looping over short transfers */
+bool zstore_transfer(int fd, char *buffer, size_t size, size_t offset, bool wrt) {
+#ifdef _MSC_VER
+    if (::_lseeki64(fd, (__int64)offset, SEEK_SET) == -1) return false;
+#endif
+    size_t done = 0;
+    while (done < size) {
+#ifdef _MSC_VER
+        int len = (int)std::min(size - done, (size_t)(1 << 30));
+        int got = (wrt ? ::_write(fd, buffer + done, len) : ::_read(fd, buffer + done, len));
+#else
+        ssize_t got = (wrt ? ::pwrite(fd, buffer + done, size - done, (off_t)(offset + done))
+                           : ::pread(fd, buffer + done, size - done, (off_t)(offset + done)));
+        if (got < 0 && errno == EINTR) continue;
+#endif
+        if (got <= 0) return false;
+        done += got;
+    }
+    return true;
+}
+
+}  // namespace
+
+size_t psio_zcompress(const char *in, size_t n, char *out, size_t cap, std::vector<char> &scratch) {
+    /* Shuffle: byte k of every 8-byte word goes to plane k, tail bytes last */
+    scratch.resize(n);
+    size_t nword = n / 8;
+    for (size_t k = 0; k < 8; k++)
+        for (size_t w = 0; w < nword; w++) scratch[k * nword + w] = in[w * 8 + k];
+    std::memcpy(&scratch[8 * nword], &in[8 * nword], n - 8 * nword);
+    const char *s = scratch.data();
+
+    /* PackBits: c < 128 is a literal of c + 1 bytes, c >= 128 a run of c - 125 copies */
+    size_t i = 0, o = 0;
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < 130 && s[i + run] == s[i]) run++;
+        if (run >= 3) {
+            if (o + 2 > cap) return 0;
+            out[o++] = (char)(0x80 | (run - 3));
+            out[o++] = s[i];
+            i += run;
+        } else {
+            size_t start = i, len = 0;
+            while (i < n && len < 128) {
+                if (i + 2 < n && s[i] == s[i + 1] && s[i] == s[i + 2]) break;
+                i++;
+                len++;
+            }
+            if (o + 1 + len > cap) return 0;
+            out[o++] = (char)(len - 1);
+            std::memcpy(&out[o], &s[start], len);
+            o += len;
+        }
+    }
+    return o;
+}
+
+void psio_zdecompress(const char *in, size_t csize, char *out, size_t n, std::vector<char> &scratch) {
+    scratch.resize(n);
+    char *s = scratch.data();
+    size_t i = 0, o = 0;
+    while (i < csize && o < n) {
+        unsigned char c = (unsigned char)in[i++];
+        if (c & 0x80) {
+            size_t run = std::min((size_t)(c & 0x7f) + 3, n - o);
+            std::memset(&s[o], in[i++], run);
+            o += run;
+        } else {
+            size_t len = std::min((size_t)c + 1, n - o);
+            std::memcpy(&s[o], &in[i], len);
+            i += (size_t)c + 1;
+            o += len;
+        }
+    }
+
+    size_t nword = n / 8;
+    for (size_t k = 0; k < 8; k++)
+        for (size_t w = 0; w < nword; w++) out[w * 8 + k] = s[k * nword + w];
+    std::memcpy(&out[8 * nword], &s[8 * nword], n - 8 * nword);
+}
+
+PSIOZStore::PSIOZStore(size_t unit, const std::string &path, size_t limit, PageIO fallback)
+    : unit_(unit),
+      path_(path),
+      end_(0),
+      limit_(limit),
+      fallback_(fallback),
+      cache_(PSIO_PAGELEN),
+      cache_page_(0),
+      cache_valid_(false),
+      cache_dirty_(false),
+      packed_(PSIO_PAGELEN) {
+#ifdef _MSC_VER
+    fd_ = ::_open(path_.c_str(), _O_BINARY | _O_CREAT | _O_RDWR | _O_TRUNC, _S_IREAD | _S_IWRITE);
+#else
+    fd_ = ::open(path_.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+#endif
+    if (fd_ == -1) psio_error(unit_, PSIO_ERROR_OPEN);
+}
+
+PSIOZStore::~PSIOZStore() {
+#ifdef _MSC_VER
+    ::_close(fd_);
+    ::_unlink(path_.c_str());
+#else
+    ::close(fd_);
+    ::unlink(path_.c_str());
+#endif
+}
+
+void PSIOZStore::decode(size_t page, char *dst) {
+    auto it = index_.find(page);
+    if (it == index_.end()) {
+        // not stored yet, whatever the plain volumes hold
+        std::memset(dst, '\0', PSIO_PAGELEN);
+        size_t first = page * PSIO_PAGELEN;
+        if (first < limit_) {
+            psio_address address = {page, 0};
+            fallback_(dst, address, std::min((size_t)PSIO_PAGELEN, limit_ - first));
+        }
+        return;
+    }
+
+    const Extent &ext = it->second;
+    if (ext.csize == PSIO_PAGELEN) {
+        if (!zstore_transfer(fd_, dst, PSIO_PAGELEN, ext.offset, false)) psio_error(unit_, PSIO_ERROR_READ);
+    } else {
+        if (!zstore_transfer(fd_, packed_.data(), ext.csize, ext.offset, false)) psio_error(unit_, PSIO_ERROR_READ);
+        psio_zdecompress(packed_.data(), ext.csize, dst, PSIO_PAGELEN, scratch_);
+    }
+}
+
+void PSIOZStore::encode(size_t page, const char *src) {
+    size_t csize = psio_zcompress(src, PSIO_PAGELEN, packed_.data(), PSIO_PAGELEN - 1, scratch_);
+    const char *data = packed_.data();
+    if (!csize) {
+        // incompressible, keep it as is
+        csize = PSIO_PAGELEN;
+        data = src;
+    }
+
+    auto it = index_.find(page);
+    if (it == index_.end() || it->second.capacity < csize) {
+        // new slot, rounded up so that slightly larger rewrites still fit
+        if (it != index_.end()) free_.insert(std::make_pair(it->second.capacity, it->second.offset));
+        Extent ext;
+        ext.capacity = std::min((size_t)PSIO_PAGELEN, ((csize + 511) / 512) * 512);
+        ext.offset = allocate(ext.capacity);
+        index_[page] = ext;
+        it = index_.find(page);
+    }
+    it->second.csize = csize;
+
+    if (!zstore_transfer(fd_, const_cast<char *>(data), csize, it->second.offset, true))
+        psio_error(unit_, PSIO_ERROR_WRITE);
+}
+
+size_t PSIOZStore::allocate(size_t capacity) {
+    // smallest free extent that fits; the rest of it stays free
+    auto it = free_.lower_bound(capacity);
+    if (it == free_.end()) {
+        size_t offset = end_;
+        end_ += capacity;
+        return offset;
+    }
+    size_t offset = it->second;
+    size_t left = it->first - capacity;
+    free_.erase(it);
+    if (left) free_.insert(std::make_pair(left, offset + capacity));
+    return offset;
+}
+
+void PSIOZStore::flush() {
+    if (cache_valid_ && cache_dirty_) encode(cache_page_, cache_.data());
+    cache_dirty_ = false;
+}
+
+void PSIOZStore::load(size_t page) {
+    if (cache_valid_ && cache_page_ == page) return;
+    flush();
+    decode(page, cache_.data());
+    cache_page_ = page;
+    cache_valid_ = true;
+}
+
+void PSIOZStore::rw(char *buffer, psio_address address, size_t size, int wrt) {
+    std::lock_guard<std::mutex> guard(lock_);
+    size_t page = address.page;
+    size_t offset = address.offset;
+    size_t done = 0;
+    while (done < size) {
+        size_t len = std::min((size_t)PSIO_PAGELEN - offset, size - done);
+        bool cached = cache_valid_ && cache_page_ == page;
+        if (len == PSIO_PAGELEN && !cached) {
+            // whole pages skip the cache
+            if (wrt)
+                encode(page, &buffer[done]);
+            else
+                decode(page, &buffer[done]);
+        } else if (len == PSIO_PAGELEN && wrt) {
+            std::memcpy(cache_.data(), &buffer[done], len);
+            cache_dirty_ = true;
+        } else {
+            load(page);
+            if (wrt) {
+                std::memcpy(&cache_[offset], &buffer[done], len);
+                cache_dirty_ = true;
+            } else {
+                std::memcpy(&buffer[done], &cache_[offset], len);
+            }
+        }
+        done += len;
+        offset = 0;
+        page++;
+    }
+}
+
+void PSIOZStore::materialize(PageIO sink) {
+    std::lock_guard<std::mutex> guard(lock_);
+    flush();
+    std::vector<char> page_data(PSIO_PAGELEN);
+    for (const auto &kv : index_) {
+        decode(kv.first, page_data.data());
+        psio_address address = {kv.first, 0};
+        sink(page_data.data(), address, PSIO_PAGELEN);
+    }
+}
+
+}  // namespace psi
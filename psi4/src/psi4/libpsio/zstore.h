@@ -0,0 +1,128 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_zstore_h_
+#define _psi_src_lib_libpsio_zstore_h_
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "psi4/libpsio/config.h"
+
+namespace psi {
+
+/// Lossless codec for PSIO pages: an 8-byte shuffle (so the sign/exponent
+/// bytes of doubles sit together) followed by PackBits-style run-length
+/// coding. Returns the compressed size, or 0 if it would not fit in cap.
+size_t psio_zcompress(const char *in, size_t n, char *out, size_t cap, std::vector<char> &scratch);
+/// Inverse of psio_zcompress, out must hold n bytes
+void psio_zdecompress(const char *in, size_t csize, char *out, size_t n, std::vector<char> &scratch);
+
+/*!
+ * Compressed backing store for one PSIO unit.
+ *
+ * The unit's global address space is cut into PSIO_PAGELEN blocks, each
+ * compressed on its own into a sidecar file next to the first volume. An
+ * in-memory index maps page numbers to compressed extents, so any sub-range
+ * can be read or rewritten by (de)compressing only the pages it touches. A
+ * page that outgrows its extent moves, and the extent it leaves is reused by
+ * later pages, so repeated rewrites do not grow the sidecar file. The
+ * page last touched is cached uncompressed, absorbing runs of small accesses.
+ * Pages never written through the store are read from the plain volumes.
+ */
+class PSIOZStore {
+   public:
+    typedef std::function<void(char *, psio_address, size_t)> PageIO;
+
+    /// @param unit     unit number, for error reporting
+    /// @param path     sidecar file to create
+    /// @param limit    global byte offset up to which the plain volumes hold data
+    /// @param fallback reads plain volume data for pages not yet in the store
+    PSIOZStore(size_t unit, const std::string &path, size_t limit, PageIO fallback);
+    /// Closes and removes the sidecar file
+    ~PSIOZStore();
+
+    /// Same contract as PSIO::rw, on global addresses
+    void rw(char *buffer, psio_address address, size_t size, int wrt);
+    /// Write back the cached page, if modified
+    void flush();
+    /// Hand every stored page, uncompressed, to sink (e.g. to write it to the plain volumes)
+    void materialize(PageIO sink);
+
+    const std::string &path() const { return path_; }
+    /// Uncompressed bytes held in the store
+    size_t raw_bytes() const { return index_.size() * (size_t)PSIO_PAGELEN; }
+    /// Size of the sidecar file, including extents freed for reuse
+    size_t stored_bytes() const { return end_; }
+
+   private:
+    struct Extent {
+        /// Offset in the sidecar file
+        size_t offset;
+        /// Bytes reserved at offset, reused when a rewrite fits
+        size_t capacity;
+        /// Bytes in use, PSIO_PAGELEN if stored uncompressed
+        size_t csize;
+    };
+
+    size_t unit_;
+    std::string path_;
+    int fd_;
+    /// Append position (and size) of the sidecar file
+    size_t end_;
+    /// Extents given up by pages that outgrew them, offset by capacity
+    std::multimap<size_t, size_t> free_;
+    size_t limit_;
+    PageIO fallback_;
+    std::map<size_t, Extent> index_;
+    /// Serializes rw() calls, e.g. from the AIO workers
+    std::mutex lock_;
+
+    std::vector<char> cache_;
+    size_t cache_page_;
+    bool cache_valid_;
+    bool cache_dirty_;
+    std::vector<char> packed_;
+    std::vector<char> scratch_;
+
+    /// Uncompressed contents of page into dst
+    void decode(size_t page, char *dst);
+    /// Compress src and record it as the contents of page
+    void encode(size_t page, const char *src);
+    /// Offset of a free extent of exactly capacity bytes, reusing freed space before growing the file
+    size_t allocate(size_t capacity);
+    /// Make page the cached page
+    void load(size_t page);
+};
+
+}  // namespace psi
+
+#endif
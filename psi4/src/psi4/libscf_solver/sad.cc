@@ -38,8 +38,20 @@
 #include <cstdio>
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
+#include <unistd.h>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <vector>
 #include <utility>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
 
 #include "psi4/psifiles.h"
 #include "psi4/libciomr/libciomr.h"
@@ -81,6 +93,35 @@ static bool SAD_use_fitting(const Options& opt) {
     throw PSIEXCEPTION("SAD_SCF_TYPE " + opt.get_str("SAD_SCF_TYPE") + " not implemented.\n");
 }
 
+// 64-bit FNV-1a. Unlike std::hash, stable across builds, so it can name files in the SAD cache.
+static uint64_t SAD_hash(const std::string& str) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : str) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Everything about a basis set that affects an atomic UHF: shell structure, exponents, contraction
+// coefficients and ECPs. Geometry is deliberately left out, the atomic density does not depend on it.
+static void SAD_basis_key(std::ostringstream& key, std::shared_ptr<BasisSet> bas) {
+    key << std::hexfloat;
+    key << bas->nshell() << " " << bas->nbf() << " " << bas->n_ecp_core() << " " << bas->n_ecp_shell() << "\n";
+    for (int Q = 0; Q < bas->nshell(); Q++) {
+        const GaussianShell& shell = bas->shell(Q);
+        key << shell.am() << (shell.is_pure() ? "p" : "c") << shell.nprimitive();
+        for (int K = 0; K < shell.nprimitive(); K++) key << " " << shell.exp(K) << " " << shell.original_coef(K);
+        key << "\n";
+    }
+    for (int Q = 0; Q < bas->n_ecp_shell(); Q++) {
+        const GaussianShell& shell = bas->ecp_shell(Q);
+        key << "ecp " << shell.am() << " " << shell.nprimitive();
+        for (int K = 0; K < shell.nprimitive(); K++) key << " " << shell.exp(K) << " " << shell.coef(K);
+        key << "\n";
+    }
+}
+
 SADGuess::SADGuess(std::shared_ptr<BasisSet> basis, std::vector<std::shared_ptr<BasisSet>> atomic_bases,
                    Options& options)
     : basis_(basis), atomic_bases_(atomic_bases), options_(options) {
@@ -96,6 +137,7 @@ void SADGuess::common_init() {
 
     print_ = options_.get_int("SAD_PRINT");
     debug_ = options_.get_int("DEBUG");
+    cache_dir_ = options_.get_str("SAD_CACHE_DIR");
     if (options_["SOCC"].size() > 0 || options_["DOCC"].size() > 0)
         PSIEXCEPTION("SAD guess not implemented for user-specified SOCCs and/or DOCCs yet");
 }
@@ -240,14 +282,19 @@ void SADGuess::run_atomic_calculations(SharedMatrix& DAO, SharedMatrix& HuckelC,
     // Atomic orbital energies for Huckel
     std::vector<SharedVector> atomic_Ehu(nunique);
 
-    if (print_ > 1) outfile->Printf("\n  Performing Atomic UHF Computations:\n");
-    for (int uniA = 0; uniA < nunique; uniA++) {
+    // Occupations of each unique atom, and the cache key of its density
+    std::vector<SharedVector> atomic_occ_a(nunique);
+    std::vector<SharedVector> atomic_occ_b(nunique);
+    std::vector<std::string> atomic_key(nunique);
+
+    // Sets up the occupations and result matrices of a unique atom; returns false for ghosts
+    auto setup_atom = [&](int uniA) {
         int index = atomic_indices[uniA];
         int nbf = atomic_bases_[index]->nbf();
         int Z = molecule_->Z(index);
         if (nelec[index] == 0) {
             // No electrons on atom!
-            continue;
+            return false;
         }
 
         if (print_ > 1) {
@@ -325,16 +372,71 @@ void SADGuess::run_atomic_calculations(SharedMatrix& DAO, SharedMatrix& HuckelC,
         atomic_D[uniA] = std::make_shared<Matrix>("Atomic D_AO", nbf, nbf);
         atomic_Chu[uniA] = std::make_shared<Matrix>("Atomic Huckel C", nbf, nhu);
         atomic_Ehu[uniA] = std::make_shared<Vector>("Atomic Huckel E", nhu);
+        atomic_occ_a[uniA] = occ_a;
+        atomic_occ_b[uniA] = occ_b;
+        if (!cache_dir_.empty()) atomic_key[uniA] = atomic_cache_key(index, occ_a, occ_b);
+        return true;
+    };
+
+    // Runs (or loads from the SAD cache) the atomic UHF of a unique atom
+    auto solve_atom = [&](int uniA) {
+        int index = atomic_indices[uniA];
+        if (!cache_dir_.empty() &&
+            load_atomic_density(atomic_key[uniA], atomic_D[uniA], atomic_Chu[uniA], atomic_Ehu[uniA])) {
+            if (print_ > 1) outfile->Printf("  Atomic density loaded from the SAD cache.\n");
+            return;
+        }
 
         if (SAD_use_fitting(options_)) {
-            get_uhf_atomic_density(atomic_bases_[index], atomic_fit_bases_[index], occ_a, occ_b, atomic_D[uniA],
-                                   atomic_Chu[uniA], atomic_Ehu[uniA]);
+            get_uhf_atomic_density(atomic_bases_[index], atomic_fit_bases_[index], atomic_occ_a[uniA],
+                                   atomic_occ_b[uniA], atomic_D[uniA], atomic_Chu[uniA], atomic_Ehu[uniA]);
         } else {
             std::shared_ptr<BasisSet> zbas = BasisSet::zero_ao_basis_set();
-            get_uhf_atomic_density(atomic_bases_[index], zbas, occ_a, occ_b, atomic_D[uniA], atomic_Chu[uniA],
-                                   atomic_Ehu[uniA]);
+            get_uhf_atomic_density(atomic_bases_[index], zbas, atomic_occ_a[uniA], atomic_occ_b[uniA],
+                                   atomic_D[uniA], atomic_Chu[uniA], atomic_Ehu[uniA]);
         }
+        if (!cache_dir_.empty())
+            save_atomic_density(atomic_key[uniA], atomic_D[uniA], atomic_Chu[uniA], atomic_Ehu[uniA]);
         if (print_ > 1) outfile->Printf("Finished UHF Computation!\n");
+    };
+
+    if (print_ > 1) outfile->Printf("\n  Performing Atomic UHF Computations:\n");
+    // Concurrent atoms need a fitted JK, which builds all its integrals in initialize(); DirectJK builds
+    // integrals on every compute().  The JK timers are serial, so the callers of this function must have
+    // the timers skipped (see compute_guess() and huckel_guess()).
+    int nthread = 1;
+#ifdef _OPENMP
+    if (SAD_use_fitting(options_)) nthread = std::min(Process::environment.get_n_threads(), nunique);
+#endif
+    if (nthread < 2 || print_ > 1) {
+        // Serial, with the atomic outputs in order
+        for (int uniA = 0; uniA < nunique; uniA++)
+            if (setup_atom(uniA)) solve_atom(uniA);
+    } else {
+        // The atomic UHFs are independent, run one per thread with single-threaded JK and BLAS
+        std::vector<int> todo;
+        for (int uniA = 0; uniA < nunique; uniA++)
+            if (setup_atom(uniA)) todo.push_back(uniA);
+        std::vector<std::exception_ptr> errors(todo.size());
+
+#ifdef USING_LAPACK_MKL
+        int old_threads = mkl_get_max_threads();
+        mkl_set_num_threads(1);
+#endif
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthread)
+        for (size_t k = 0; k < todo.size(); k++) {
+            try {
+                solve_atom(todo[k]);
+            } catch (...) {
+                errors[k] = std::current_exception();
+            }
+        }
+#ifdef USING_LAPACK_MKL
+        mkl_set_num_threads(old_threads);
+#endif
+
+        for (auto& error : errors)
+            if (error) std::rethrow_exception(error);
     }
     if (print_) outfile->Printf("\n");
 
@@ -521,6 +623,8 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         if (options_["DF_INTS_NUM_THREADS"].has_changed())
             dfjk->set_df_ints_num_threads(options_.get_int("DF_INTS_NUM_THREADS"));
         dfjk->dfh()->set_print_lvl(0);
+        // JK object primary libint2::Engine used to construct Schwarz externally, so need to zero precision for SAD
+        dfjk->dfh()->set_ints_tolerance(0.0);
         jk = std::unique_ptr<JK>(dfjk);
     } else {
         DirectJK* directjk(new DirectJK(bas));
@@ -529,19 +633,21 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         jk = std::unique_ptr<JK>(directjk);
     }
 
-    // JK object primary libint2::Engine used to construct Schwarz externally, so need to zero precision for SAD scope
-    std::string ints_tolerance_key = "INTS_TOLERANCE";
-    auto ints_tolerance_value = Process::environment.options.get_double(ints_tolerance_key);
-    auto ints_tolerance_changed = Process::environment.options.use_local(ints_tolerance_key).has_changed();
-    Process::environment.options.set_double("SCF", ints_tolerance_key, 0.0);
+    // When several atoms are solved concurrently each JK gets one thread and a share of the memory
+    int nconcurrent = 1;
+#ifdef _OPENMP
+    if (omp_in_parallel()) {
+        nconcurrent = omp_get_num_threads();
+        jk->set_omp_nthread(1);
+    }
+#endif
 
-    jk->set_memory((size_t)(0.5 * (Process::environment.get_memory() / 8L)));
+    jk->set_memory((size_t)(0.5 * (Process::environment.get_memory() / 8L) / nconcurrent));
+    // Engine construction touches libint2's static setup, keep it to one thread at a time
+#pragma omp critical(sad_jk_init)
     jk->initialize();
     if (print_ > 1) jk->print_header();
 
-    Process::environment.options.set_double("SCF", ints_tolerance_key, ints_tolerance_value);
-    if (!ints_tolerance_changed) Process::environment.options.use_local(ints_tolerance_key).dechanged();
-
     // These are static so lets just grab them now
     std::vector<SharedMatrix>& jkC = jk->C_left();
     jkC.push_back(Ca_occ);
@@ -623,6 +729,7 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         }
 
         if (iteration > sad_maxiter) {
+#pragma omp critical(sad_print)
             outfile->Printf(
                 "\n WARNING: Atomic UHF is not converging! Try casting from a smaller basis or call Rob at CCMST.\n");
             break;
@@ -645,6 +752,96 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         Eoccp[i] = Ep[i];
     }
 }
+std::string SADGuess::atomic_cache_key(int atom, SharedVector occ_a, SharedVector occ_b) const {
+    std::ostringstream key;
+    key << std::hexfloat;
+    key << "Z " << molecule_->Z(atom) << "\n";
+    key << "occ_a";
+    for (int i = 0; i < occ_a->dim(); i++) key << " " << occ_a->get(i);
+    key << "\nocc_b";
+    for (int i = 0; i < occ_b->dim(); i++) key << " " << occ_b->get(i);
+    key << "\n";
+    key << "SAD_SCF_TYPE " << options_.get_str("SAD_SCF_TYPE") << "\n";
+    key << "SAD_E_CONVERGENCE " << options_.get_double("SAD_E_CONVERGENCE") << "\n";
+    key << "SAD_D_CONVERGENCE " << options_.get_double("SAD_D_CONVERGENCE") << "\n";
+    key << "SAD_MAXITER " << options_.get_int("SAD_MAXITER") << "\n";
+    key << "DIIS_RMS_ERROR " << options_.get_bool("DIIS_RMS_ERROR") << "\n";
+    key << "basis\n";
+    SAD_basis_key(key, atomic_bases_[atom]);
+    if (SAD_use_fitting(options_)) {
+        key << "fit basis\n";
+        SAD_basis_key(key, atomic_fit_bases_[atom]);
+    }
+    return key.str();
+}
+
+// A SAD cache file holds the full key (to guard against hash collisions), then the dimensions and contents of the
+// atomic density and Huckel orbitals. Files are written under a temporary name and renamed into place, so concurrent
+// jobs sharing a cache directory never see a partial file.
+bool SADGuess::load_atomic_density(const std::string& key, SharedMatrix D, SharedMatrix Chuckel,
+                                   SharedVector Ehuckel) const {
+    std::ostringstream fname;
+    fname << cache_dir_ << "/sad." << std::hex << std::setw(16) << std::setfill('0') << SAD_hash(key) << ".bin";
+    std::ifstream fin(fname.str(), std::ios::binary);
+    if (!fin) return false;
+
+    size_t keylen = 0;
+    fin.read(reinterpret_cast<char*>(&keylen), sizeof(size_t));
+    if (!fin || keylen != key.size()) return false;
+    std::string filekey(keylen, '\0');
+    fin.read(&filekey[0], keylen);
+    if (!fin || filekey != key) return false;
+
+    int nbf = 0, nhu = 0;
+    fin.read(reinterpret_cast<char*>(&nbf), sizeof(int));
+    fin.read(reinterpret_cast<char*>(&nhu), sizeof(int));
+    if (!fin || nbf != D->rowdim() || nhu != Chuckel->coldim()) return false;
+
+    auto Dtemp = std::make_shared<Matrix>("Atomic D_AO", nbf, nbf);
+    auto Ctemp = std::make_shared<Matrix>("Atomic Huckel C", nbf, nhu);
+    auto Etemp = std::make_shared<Vector>("Atomic Huckel E", nhu);
+    if (nbf) fin.read(reinterpret_cast<char*>(Dtemp->pointer()[0]), sizeof(double) * nbf * nbf);
+    if (nbf && nhu) fin.read(reinterpret_cast<char*>(Ctemp->pointer()[0]), sizeof(double) * nbf * nhu);
+    if (nhu) fin.read(reinterpret_cast<char*>(Etemp->pointer()), sizeof(double) * nhu);
+    if (!fin) return false;
+
+    D->copy(Dtemp);
+    Chuckel->copy(Ctemp);
+    Ehuckel->copy(*Etemp);
+    return true;
+}
+void SADGuess::save_atomic_density(const std::string& key, SharedMatrix D, SharedMatrix Chuckel,
+                                   SharedVector Ehuckel) const {
+    std::ostringstream fname;
+    fname << cache_dir_ << "/sad." << std::hex << std::setw(16) << std::setfill('0') << SAD_hash(key) << ".bin";
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+    std::ostringstream tname;
+    tname << fname.str() << ".tmp." << getpid() << "." << thread;
+
+    std::ofstream fout(tname.str(), std::ios::binary);
+    if (!fout) {
+#pragma omp critical(sad_print)
+        outfile->Printf("  SAD: Unable to write atomic density cache file %s.\n", tname.str().c_str());
+        return;
+    }
+
+    size_t keylen = key.size();
+    int nbf = D->rowdim();
+    int nhu = Chuckel->coldim();
+    fout.write(reinterpret_cast<const char*>(&keylen), sizeof(size_t));
+    fout.write(key.data(), keylen);
+    fout.write(reinterpret_cast<const char*>(&nbf), sizeof(int));
+    fout.write(reinterpret_cast<const char*>(&nhu), sizeof(int));
+    if (nbf) fout.write(reinterpret_cast<const char*>(D->pointer()[0]), sizeof(double) * nbf * nbf);
+    if (nbf && nhu) fout.write(reinterpret_cast<const char*>(Chuckel->pointer()[0]), sizeof(double) * nbf * nhu);
+    if (nhu) fout.write(reinterpret_cast<const char*>(Ehuckel->pointer()), sizeof(double) * nhu);
+    fout.close();
+
+    if (!fout || std::rename(tname.str().c_str(), fname.str().c_str())) std::remove(tname.str().c_str());
+}
 void SADGuess::form_gradient(SharedMatrix grad, SharedMatrix F, SharedMatrix D, SharedMatrix S, SharedMatrix X) {
     int nbf = X->rowdim();
     auto Scratch1 = std::make_shared<Matrix>("Scratch1", nbf, nbf);
@@ -712,7 +909,9 @@ SharedMatrix SADGuess::huckel_guess() {
     // Huckel matrices
     SharedMatrix Chu;
     SharedVector Ehu;
+    start_skip_timers();
     run_atomic_calculations(DAO, Chu, Ehu);
+    stop_skip_timers();
 
     IntegralFactory integral(basis_, basis_, basis_, basis_);
     MatrixFactory mat;
@@ -49,6 +49,9 @@ class SADGuess {
 
     Options& options_;
 
+    /// Directory of the on-disk atomic density cache, empty if disabled
+    std::string cache_dir_;
+
     SharedMatrix Da_;
     SharedMatrix Db_;
     SharedMatrix Ca_;
@@ -64,6 +67,10 @@ class SADGuess {
     void form_C_and_D(SharedMatrix X, SharedMatrix F, SharedMatrix C, SharedVector E, SharedMatrix Cocc,
                       SharedVector occ, SharedMatrix D);
 
+    std::string atomic_cache_key(int atom, SharedVector occ_a, SharedVector occ_b) const;
+    bool load_atomic_density(const std::string& key, SharedMatrix D, SharedMatrix Chuckel, SharedVector Ehuckel) const;
+    void save_atomic_density(const std::string& key, SharedMatrix D, SharedMatrix Chuckel, SharedVector Ehuckel) const;
+
     void form_D();
     void form_C();
 
@@ -1926,19 +1926,47 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response() {
         }
     }
 
+    // => Dipole derivatives (for IR intensities) <= //
+    MintsHelper mints(basisset_);
+    auto ao_dipole = mints.ao_dipole();
+    auto Ca = Ca_subset("AO");
+    auto Caocc = Ca_subset("AO", "OCC");
+    Matrix mu_x("mu X", nmo_, nocc);
+    Matrix mu_y("mu Y", nmo_, nocc);
+    Matrix mu_z("mu Z", nmo_, nocc);
+    mu_x.transform(Ca, ao_dipole[0], Caocc);
+    mu_y.transform(Ca, ao_dipole[1], Caocc);
+    mu_z.transform(Ca, ao_dipole[2], Caocc);
+    // Start by computing the skeleton derivatives
+    auto dipole_gradient = mints.dipole_grad(Da_subset("AO"));
+    // Account for alpha and beta orbitals
+    dipole_gradient->scale(2);
+    dipole_gradient->add(DipoleInt::nuclear_gradient_contribution(molecule_));
+    double** pdip_grad = dipole_gradient->pointer();
+
     // => CPHF (Uai) <= //
     {
         rhf_wfn_->set_jk(jk);
 
         psio_address next_Bai = PSIO_ZERO;
-        psio_address next_Uai = PSIO_ZERO;
+        psio_address next_Spi = PSIO_ZERO;
+        psio_address next_Upi = PSIO_ZERO;
 
         auto T = std::make_shared<Matrix>("T", nvir, nocc);
         double** Tp = T->pointer();
+        auto Upi = std::make_shared<Matrix>("U", nmo, nocc);
+        double** Upqp = Upi->pointer();
 
-        for (int A = 0; A < 3 * natom; A += max_A) {
-            int nA = max_A;
-            if (A + max_A >= 3 * natom) {
+        // Each perturbation in the solver holds five (occ x vir) CG vectors plus its share of one
+        // packed JK call (C_right, J, K) and, for DFT, the Dx/Vx pair handed to compute_Vx
+        size_t per_cphf = (functional_->needs_xc() ? 5L : 3L) * nso * nso + 1L * nocc * nso + 5L * nocc * nvir;
+        size_t max_cphf = (mem / 2L) / per_cphf;
+        max_cphf = (max_cphf > 3 * natom ? 3 * natom : max_cphf);
+        max_cphf = (max_cphf < 1 ? 1 : max_cphf);
+
+        for (int A = 0; A < 3 * natom; A += max_cphf) {
+            int nA = max_cphf;
+            if (A + max_cphf >= 3 * natom) {
                 nA = 3 * natom - A;
             }
 
@@ -1966,61 +1994,33 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response() {
 #ifdef USING_BrianQC
     brianCPHFLeftSideFlag = false;
 #endif
-            // Result in x
+            if (!rhf_wfn_->cphf_converged()) {
+                outfile->Printf("    Warning: CPHF did not converge for perturbations %d through %d.\n\n", A,
+                                A + nA - 1);
+            }
+
+            // Result in x; the occupied block of U is fixed by the overlap derivative, so the
+            // full Upi goes straight to disk without staging Uai
             for (int a = 0; a < nA; a++) {
-                std::stringstream ss;
-                ss << "Perturbation " << a + A;
-                u_matrices[a]->scale(-1);
+                psio_->read(PSIF_HESS, "Sij^A", (char*)Upqp[0], static_cast<size_t>(nocc) * nocc * sizeof(double),
+                            next_Spi, &next_Spi);
+                C_DSCAL(nocc * (size_t)nocc, -0.5, Upqp[0], 1);
                 double** Xp = u_matrices[a]->pointer();
                 for (int i = 0; i < nocc; i++) {
-                    C_DCOPY(nvir, Xp[i], 1, &Tp[0][i], nocc);
+                    for (int p = 0; p < nvir; p++) {
+                        Upqp[nocc + p][i] = -Xp[i][p];
+                    }
                 }
-                psio_->write(PSIF_HESS, "Uai^A", (char*)Tp[0], static_cast<size_t>(nvir) * nocc * sizeof(double),
-                             next_Uai, &next_Uai);
+                u_matrices[a].reset();
+                psio_->write(PSIF_HESS, "Upi^A", (char*)Upqp[0], static_cast<size_t>(nmo) * nocc * sizeof(double),
+                             next_Upi, &next_Upi);
+                pdip_grad[A + a][0] += 4 * mu_x.vector_dot(Upi);
+                pdip_grad[A + a][1] += 4 * mu_y.vector_dot(Upi);
+                pdip_grad[A + a][2] += 4 * mu_z.vector_dot(Upi);
             }
         }
     }
 
-    // => Dipole derivatives (for IR intensities) <= //
-    MintsHelper mints(basisset_);
-    auto ao_dipole = mints.ao_dipole();
-    auto Ca = Ca_subset("AO");
-    auto Caocc = Ca_subset("AO", "OCC");
-    Matrix mu_x("mu X", nmo_, nocc);
-    Matrix mu_y("mu Y", nmo_, nocc);
-    Matrix mu_z("mu Z", nmo_, nocc);
-    mu_x.transform(Ca, ao_dipole[0], Caocc);
-    mu_y.transform(Ca, ao_dipole[1], Caocc);
-    mu_z.transform(Ca, ao_dipole[2], Caocc);
-    // Start by computing the skeleton derivatives
-    auto dipole_gradient = mints.dipole_grad(Da_subset("AO"));
-    // Account for alpha and beta orbitals
-    dipole_gradient->scale(2);
-    dipole_gradient->add(DipoleInt::nuclear_gradient_contribution(molecule_));
-    double** pdip_grad = dipole_gradient->pointer();
-
-    // => Upi <= //
-    {
-        auto Upi = std::make_shared<Matrix>("U", nmo, nocc);
-        double** Upqp = Upi->pointer();
-
-        psio_address next_Spi = PSIO_ZERO;
-        psio_address next_Uai = PSIO_ZERO;
-        psio_address next_Upi = PSIO_ZERO;
-
-        for (int A = 0; A < 3 * natom; A++) {
-            psio_->read(PSIF_HESS, "Sij^A", (char*)Upqp[0], static_cast<size_t>(nocc) * nocc * sizeof(double), next_Spi,
-                        &next_Spi);
-            C_DSCAL(nocc * (size_t)nocc, -0.5, Upqp[0], 1);
-            psio_->read(PSIF_HESS, "Uai^A", (char*)Upqp[nocc], static_cast<size_t>(nvir) * nocc * sizeof(double),
-                        next_Uai, &next_Uai);
-            psio_->write(PSIF_HESS, "Upi^A", (char*)Upqp[0], static_cast<size_t>(nmo) * nocc * sizeof(double), next_Upi,
-                         &next_Upi);
-            pdip_grad[A][0] += 4 * mu_x.vector_dot(Upi);
-            pdip_grad[A][1] += 4 * mu_y.vector_dot(Upi);
-            pdip_grad[A][2] += 4 * mu_z.vector_dot(Upi);
-        }
-    }
     rhf_wfn_->set_array_variable("SCF DIPOLE GRADIENT", dipole_gradient);
     rhf_wfn_->set_array_variable("CURRENT DIPOLE GRADIENT", dipole_gradient);
 
@@ -2307,8 +2307,12 @@ std::shared_ptr<Matrix> USCFDeriv::hessian_response()
     JK_deriv2(jk,mem, Ca, Ca_occ, Cb, Cb_occ, nso, naocc, nbocc, navir, true);
     JK_deriv2(jk,mem, Cb, Cb_occ, Ca, Ca_occ, nso, nbocc, naocc, nbvir, false);
 
-    VXC_deriv(Ca, Ca_occ, nso, naocc, navir, true);
-    VXC_deriv(Cb, Cb_occ, nso, nbocc, nbvir, false);
+    // Both spins' XC Fock derivatives come out of a single pass over the grid
+    std::vector<SharedMatrix> Vxc_matrices;
+    if (functional_->needs_xc()) Vxc_matrices = potential_->compute_fock_derivatives();
+    VXC_deriv(Ca, Ca_occ, Vxc_matrices, nso, naocc, navir, true);
+    VXC_deriv(Cb, Cb_occ, Vxc_matrices, nso, nbocc, nbvir, false);
+    Vxc_matrices.clear();
 
     assemble_Fock(naocc, navir,true);
     assemble_Fock(nbocc, nbvir,false);
@@ -2322,15 +2326,15 @@ std::shared_ptr<Matrix> USCFDeriv::hessian_response()
     {
         uhf_wfn_->set_jk(jk);
 
-        // using naocc here
-        size_t per_A = 3L * nso * nso + 1L * naocc * nso;
+        // Each perturbation carries an alpha and a beta equation, each with five (occ x vir) CG
+        // vectors and its share of the packed JK call, plus the Dx/Vx pair for DFT; using naocc here
+        size_t per_A = 2L * ((functional_->needs_xc() ? 5L : 3L) * nso * nso + 1L * naocc * nso + 5L * naocc * navir);
         size_t max_A = (mem / 2L) / per_A;
         max_A = (max_A > 3 * natom ? 3 * natom : max_A);
+        max_A = (max_A < 1 ? 1 : max_A);
 
         psio_address next_Baia = PSIO_ZERO;
-        psio_address next_Uaia = PSIO_ZERO;
         psio_address next_Baib = PSIO_ZERO;
-        psio_address next_Uaib = PSIO_ZERO;
 
         auto Ta = std::make_shared<Matrix>("Ta",navir,naocc);
         auto Tb = std::make_shared<Matrix>("Tb",nbvir,nbocc);
@@ -2379,37 +2383,18 @@ std::shared_ptr<Matrix> USCFDeriv::hessian_response()
 #ifdef USING_BrianQC
     brianCPHFLeftSideFlag = false;
 #endif
-            // Result in x
-            // Write Uas to disk
-            for (int a = 0; a < nA; a++) {
-                std::stringstream ss;
-                ss << "Perturbation " << a + A;
-                u_matrices[2*a]->scale(-1);
-                double** Xp = u_matrices[2*a]->pointer();
-                for (int i = 0; i < naocc; i++) {
-                    C_DCOPY(navir,Xp[i],1,&Tap[0][i],naocc);
-                }
-                psio_->write(PSIF_HESS,"Uai^A_a",(char*)Tap[0], static_cast<size_t> (navir) * naocc * sizeof(double),next_Uaia,&next_Uaia);
-            }
-            // Write Ubs to disk
-            for (int a = 0; a < nA; a++) {
-                std::stringstream ss;
-                ss << "Perturbation " << a + A;
-                u_matrices[2*a+1]->scale(-1);
-                double** Xp = u_matrices[2*a+1]->pointer();
-                // U matrices stored A/B
-                for (int i = 0; i < nbocc; i++) {
-                    C_DCOPY(nbvir,Xp[i],1,&Tbp[0][i],nbocc);
-                }
-                psio_->write(PSIF_HESS,"Uai^A_b",(char*)Tbp[0], static_cast<size_t> (nbvir) * nbocc * sizeof(double),next_Uaib,&next_Uaib);
+            if (!uhf_wfn_->cphf_converged()) {
+                outfile->Printf("    Warning: CPHF did not converge for perturbations %d through %d.\n\n", A,
+                                A + nA - 1);
             }
+
+            // Result in x
+            // U matrices come back stored A/B; write the full Upi for this batch
+            assemble_U(u_matrices, A, nA, naocc, navir, true);
+            assemble_U(u_matrices, A, nA, nbocc, nbvir, false);
         }
     }
 
-
-    assemble_U(naocc, navir, true);
-    assemble_U(nbocc, nbvir, false);
-
     assemble_Q(jk, Ca, Ca_occ, Cb, Cb_occ, nso, naocc, nbocc, navir, true);
     assemble_Q(jk, Cb, Cb_occ, Ca, Ca_occ, nso, nbocc, naocc, nbvir, false);
     jk.reset();
@@ -3984,11 +3969,14 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
         // Just pass C1 quantities in; this object doesn't respect symmetry anyway
         L.push_back(C1occ);
         R.push_back(std::make_shared<Matrix>("R",nso,n1occ));
-        Dx.push_back(std::make_shared<Matrix>("Dx", nso,nso));
-        Vx.push_back(std::make_shared<Matrix>("Vx", nso,nso));
-
         L.push_back(C2occ);
         R.push_back(std::make_shared<Matrix>("R",nso,n2occ));
+        if(functional_->needs_xc()) {
+            for (int s = 0; s < 2; s++) {
+                Dx.push_back(std::make_shared<Matrix>("Dx", nso,nso));
+                Vx.push_back(std::make_shared<Matrix>("Vx", nso,nso));
+            }
+        }
     }
 
     jk->print_header();
@@ -4000,21 +3988,31 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
             nA = 3 * natom - A;
             L.resize(2*nA);
             R.resize(2*nA);
+            Dx.resize(2*nA);
+            Vx.resize(2*nA);
         }
         for (int a = 0; a < nA; a++) {
             psio_address next_Sij= psio_get_address(PSIO_ZERO,(A + a) * (size_t) n1occ * n1occ * sizeof(double));
             psio_->read(PSIF_HESS,Sij_1,(char*)Sij1p[0], static_cast<size_t> (n1occ)*n1occ*sizeof(double),next_Sij, &next_Sij);
             C_DGEMM('N','N',nso,n1occ,n1occ,1.0,C1op[0],n1occ,Sij1p[0],n1occ,0.0,R[2*a]->pointer()[0],n1occ);
-            Dx[a] = linalg::doublet(L[2*a], R[2*a], false, true);
-            // Symmetrize the pseudodensity
-            Dx[a]->add(Dx[a]->transpose());
-            Dx[a]->scale(0.5);
         }
         for (int a = 0; a < nA; a++) {
             psio_address next_Sij= psio_get_address(PSIO_ZERO,(A + a) * (size_t) n2occ * n2occ * sizeof(double));
             psio_->read(PSIF_HESS,Sij_2,(char*)Sij2p[0], static_cast<size_t> (n2occ)*n2occ*sizeof(double),next_Sij, &next_Sij);
             C_DGEMM('N','N',nso,n2occ,n2occ,1.0,C2op[0],n2occ,Sij2p[0],n2occ,0.0,R[2*a+1]->pointer()[0],n2occ);
         }
+        if(functional_->needs_xc()) {
+            // The pseudodensities for UKS Vx are ordered alpha, beta within each perturbation
+            for (int a = 0; a < nA; a++) {
+                Dx[alpha ? 2*a : 2*a+1] = linalg::doublet(L[2*a], R[2*a], false, true);
+                Dx[alpha ? 2*a+1 : 2*a] = linalg::doublet(L[2*a+1], R[2*a+1], false, true);
+            }
+            for (int i = 0; i < 2*nA; i++) {
+                // Symmetrize the pseudodensity
+                Dx[i]->add(Dx[i]->transpose());
+                Dx[i]->scale(0.5);
+            }
+        }
 
         jk->compute();
         if(functional_->needs_xc()) {
@@ -4034,9 +4032,10 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
 
             if(functional_->needs_xc()) {
                 // Symmetrize the result, just to be safe
-                C_DGEMM('N','N',nso,n1occ,nso, 0.5,Vx[2*a]->pointer()[0],nso,C1op[0],n1occ,0.0,Tp[0],n1occ);
-                C_DGEMM('T','N',nso,n1occ,nso, 0.5,Vx[2*a]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
-                C_DGEMM('T','N',nmo,n1occ,nso,-2.0,C1p[0],nmo,Tp[0],n1occ,1.0,Up[0],n1occ);
+                double** Vx1p = Vx[alpha ? 2*a : 2*a+1]->pointer();
+                C_DGEMM('N','N',nso,n1occ,nso, 0.5,Vx1p[0],nso,C1op[0],n1occ,0.0,Tp[0],n1occ);
+                C_DGEMM('T','N',nso,n1occ,nso, 0.5,Vx1p[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
+                C_DGEMM('T','N',nmo,n1occ,nso,-1.0,C1p[0],nmo,Tp[0],n1occ,1.0,Up[0],n1occ);
             }
 
             // Subtract the K term from G
@@ -4054,6 +4053,7 @@ void USCFDeriv::JK_deriv2(std::shared_ptr<JK> jk, int mem,
 
 void USCFDeriv::VXC_deriv(std::shared_ptr<Matrix> C, 
                           std::shared_ptr<Matrix> Cocc,
+                          const std::vector<SharedMatrix>& Vxc_matrices,
                           int nso, int nocc, int nvir, bool alpha)
 {
     // => XC Gradient <= //
@@ -4076,12 +4076,11 @@ void USCFDeriv::VXC_deriv(std::shared_ptr<Matrix> C,
         for (int A = 0; A < 3 * natom; A++)
             psio_->write(PSIF_HESS,VXCpi_str,(char*)Up[0], static_cast<size_t> (nmo)*nocc*sizeof(double),next_VXCpi,&next_VXCpi);
 
-        // For now we just compute all 3N matrices in one go.  If this becomes to burdensome
-        // in terms of memory we can reevaluate and implement a batching mechanism instead.
-        auto Vxc_matrices = potential_->compute_fock_derivatives();
+        // The alpha derivatives come first, followed by the beta ones
+        int offset = alpha ? 0 : 3 * natom;
         for(int a =0; a < 3*natom; ++a){
             // Transform from SO basis to pi
-            C_DGEMM('N','N',nso,nocc,nso,1.0,Vxc_matrices[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
+            C_DGEMM('N','N',nso,nocc,nso,1.0,Vxc_matrices[offset + a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
             C_DGEMM('T','N',nmo,nocc,nso,1.0,Cp[0],nmo,Tp[0],nocc,0.0,Up[0],nocc);
             next_VXCpi = psio_get_address(PSIO_ZERO,a * (size_t) nmo * nocc * sizeof(double));
 
@@ -4169,26 +4168,32 @@ void USCFDeriv::assemble_B(std::shared_ptr<Vector> eocc, int nocc, int nvir, boo
 }
 
 
-void USCFDeriv::assemble_U(int nocc, int nvir, bool alpha)
+void USCFDeriv::assemble_U(std::vector<SharedMatrix>& u_matrices, int A, int nA, int nocc, int nvir, bool alpha)
 {
     // => Upi <= //
+    // The occupied block is fixed by the overlap derivative, so the CPHF solution for
+    // perturbations A..A+nA-1 completes Upi without staging Uai on disk
     size_t nmo = nocc + nvir;
-    int natom = molecule_->natom();
     auto Upi = std::make_shared<Matrix>("U",nmo,nocc);
     double** Upqp = Upi->pointer();
 
-    psio_address next_Spi = PSIO_ZERO;
-    psio_address next_Uai = PSIO_ZERO;
-    psio_address next_Upi = PSIO_ZERO;
-
     auto S_str   = (alpha)? "Sij^A_a" : "Sij^A_b";
-    auto Uai_str = (alpha)? "Uai^A_a" : "Uai^A_b";
     auto Upi_str = (alpha)? "Upi^A_a" : "Upi^A_b";
 
-    for (int A = 0; A < 3*natom; A++) {
+    psio_address next_Spi = psio_get_address(PSIO_ZERO,A * (size_t) nocc * nocc * sizeof(double));
+    psio_address next_Upi = psio_get_address(PSIO_ZERO,A * (size_t) nmo * nocc * sizeof(double));
+
+    for (int a = 0; a < nA; a++) {
         psio_->read(PSIF_HESS,S_str,(char*)Upqp[0], static_cast<size_t> (nocc) * nocc * sizeof(double),next_Spi,&next_Spi);
         C_DSCAL(nocc * (size_t) nocc,-0.5, Upqp[0], 1);
-        psio_->read(PSIF_HESS,Uai_str,(char*)Upqp[nocc], static_cast<size_t> (nvir) * nocc * sizeof(double),next_Uai,&next_Uai);
+        SharedMatrix& U = u_matrices[alpha ? 2*a : 2*a+1];
+        double** Xp = U->pointer();
+        for (int i = 0; i < nocc; i++) {
+            for (int p = 0; p < nvir; p++) {
+                Upqp[nocc + p][i] = -Xp[i][p];
+            }
+        }
+        U.reset();
         psio_->write(PSIF_HESS,Upi_str,(char*)Upqp[0], static_cast<size_t> (nmo) * nocc * sizeof(double),next_Upi,&next_Upi);
     }
 }
@@ -4224,10 +4229,14 @@ void USCFDeriv::assemble_Q(std::shared_ptr<JK> jk,
     for (int a = 0; a < max_A; a++) {
         L.push_back(C1occ);
         R.push_back(std::make_shared<Matrix>("R",nso,n1occ));
-        Dx.push_back(std::make_shared<Matrix>("Dx", nso,nso));
-        Vx.push_back(std::make_shared<Matrix>("Vx", nso,nso));
         L.push_back(C2occ);
         R.push_back(std::make_shared<Matrix>("R",nso,n2occ));
+        if(functional_->needs_xc()) {
+            for (int s = 0; s < 2; s++) {
+                Dx.push_back(std::make_shared<Matrix>("Dx", nso,nso));
+                Vx.push_back(std::make_shared<Matrix>("Vx", nso,nso));
+            }
+        }
     }
 
     auto U1pi = std::make_shared<Matrix>("Upi",nmo,n1occ);
@@ -4249,21 +4258,31 @@ void USCFDeriv::assemble_Q(std::shared_ptr<JK> jk,
             nA = 3 * natom - A;
             L.resize(2*nA);
             R.resize(2*nA);
+            Dx.resize(2*nA);
+            Vx.resize(2*nA);
         }
         for (int a = 0; a < nA; a++) {
             psio_address next_Upi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * n1occ * sizeof(double));
             psio_->read(PSIF_HESS,Ustr_1,(char*)U1pip[0], static_cast<size_t> (nmo)*n1occ*sizeof(double),next_Upi,&next_Upi);
             C_DGEMM('N','N',nso,n1occ,nmo,1.0,C1p[0],nmo,U1pip[0],n1occ,0.0,R[2*a]->pointer()[0],n1occ);
-            Dx[a] = linalg::doublet(L[2*a], R[2*a], false, true);
-            // Symmetrize the pseudodensity
-            Dx[a]->add(Dx[a]->transpose());
-            Dx[a]->scale(0.5);
         }
         for (int a = 0; a < nA; a++) {
             psio_address next_Upi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * n2occ * sizeof(double));
             psio_->read(PSIF_HESS,Ustr_2,(char*)U2pip[0], static_cast<size_t> (nmo)*n2occ*sizeof(double),next_Upi,&next_Upi);
             C_DGEMM('N','N',nso,n2occ,nmo,1.0,C2p[0],nmo,U2pip[0],n2occ,0.0,R[2*a+1]->pointer()[0],n2occ);
         }
+        if(functional_->needs_xc()) {
+            // The pseudodensities for UKS Vx are ordered alpha, beta within each perturbation
+            for (int a = 0; a < nA; a++) {
+                Dx[alpha ? 2*a : 2*a+1] = linalg::doublet(L[2*a], R[2*a], false, true);
+                Dx[alpha ? 2*a+1 : 2*a] = linalg::doublet(L[2*a+1], R[2*a+1], false, true);
+            }
+            for (int i = 0; i < 2*nA; i++) {
+                // Symmetrize the pseudodensity
+                Dx[i]->add(Dx[i]->transpose());
+                Dx[i]->scale(0.5);
+            }
+        }
 
         jk->compute();
         if(functional_->needs_xc()) {
@@ -4280,8 +4299,9 @@ void USCFDeriv::assemble_Q(std::shared_ptr<JK> jk,
             }
             if(functional_->needs_xc()) {
                 // Symmetrize the result, just to be safe
-                C_DGEMM('N','N',nso,n1occ,nso, 2.0,Vx[2*a]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
-                C_DGEMM('T','N',nso,n1occ,nso, 2.0,Vx[2*a]->pointer()[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
+                double** Vx1p = Vx[alpha ? 2*a : 2*a+1]->pointer();
+                C_DGEMM('N','N',nso,n1occ,nso, 1.0,Vx1p[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
+                C_DGEMM('T','N',nso,n1occ,nso, 1.0,Vx1p[0],nso,C1op[0],n1occ,1.0,Tp[0],n1occ);
             }
             C_DGEMM('T','N',nmo,n1occ,nso,1.0,C1p[0],nmo,Tp[0],n1occ,0.0,Up[0],n1occ);
             psio_address next_Qpi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * n1occ * sizeof(double));
@@ -105,12 +105,13 @@ protected:
 
     void VXC_deriv(std::shared_ptr<Matrix> C, 
                    std::shared_ptr<Matrix> Cocc,
+                   const std::vector<SharedMatrix>& Vxc_matrices,
                    int nso, int nocc, int nvir, bool alpha);
 
     void assemble_Fock(int nocc, int nvir, bool alpha);
 
     void assemble_B(std::shared_ptr<Vector> eocc, int nocc, int nvir, bool alpha);
-    void assemble_U(int nocc, int nvir, bool alpha);
+    void assemble_U(std::vector<SharedMatrix>& u_matrices, int A, int nA, int nocc, int nvir, bool alpha);
     void assemble_Q(std::shared_ptr<JK> jk,
                     std::shared_ptr<Matrix> C1, 
                     std::shared_ptr<Matrix> C1occ,
@@ -164,6 +164,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     options.add_str_i("WRITER_FILE_LABEL", "");
     /*- The density fitting basis to use in coupled cluster computations. -*/
     options.add_str("DF_BASIS_CC", "");
+    /*- Storage backend for the disk tensors of the DFHelper density-fitting
+    library (used by, e.g., DF-MCSCF, FISAPT, and DF-EP2). ``MMAP`` maps each
+    file into memory instead of going through buffered streams; it is not
+    available on Windows. !expert -*/
+    options.add_str("DFHELPER_IO_BACKEND", "STDIO", "STDIO MMAP");
     /*- Assume external fields are arranged so that they have symmetry. It is up to the user to know what to do here.
        The code does NOT help you out in any way! !expert -*/
     options.add_bool("EXTERNAL_POTENTIAL_SYMMETRY", false);
@@ -178,7 +183,7 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- What algorithm to use for the SCF computation. See Table :ref:`SCF
     Convergence & Algorithm <table:conv_scf>` for default algorithm for
     different calculation types. -*/
-    options.add_str("SCF_TYPE", "PK", "DIRECT DF MEM_DF DISK_DF PK OUT_OF_CORE CD GTFOCK");
+    options.add_str("SCF_TYPE", "PK", "DIRECT DF MEM_DF DISK_DF PK OUT_OF_CORE CD GTFOCK COSX");
     /*- Algorithm to use for MP2 computation.
     See :ref:`Cross-module Redundancies <table:managedmethods>` for details. -*/
     options.add_str("MP2_TYPE", "DF", "DF CONV CD");
@@ -692,6 +697,14 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         possible if |detci__num_roots| = 1.) !expert -*/
         options.add_bool("NO_DFILE", false);
 
+        /*- Do keep the Davidson subspace vectors (C, sigma, D and H(diag))
+        in core rather than reading and writing them through disk every
+        iteration? The vectors share an arena sized for |detci__max_num_vecs|
+        C and sigma vectors, capped at half of the memory given to Psi4.
+        Once it is full, the least recently used (oldest) vectors are written to
+        disk. -*/
+        options.add_bool("CI_INCORE_VECS", false);
+
         /*- SUBSECTION General-Order Perturbation Theory -*/
 
         /*- Do compute the MPn series out to
@@ -1304,6 +1317,13 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("PK_NO_INCORE", false);
         /*- All densities are considered non symmetric, debug only. !expert -*/
         options.add_bool("PK_ALL_NONSYM", false);
+        /*- Do compress the in-core PK supermatrices once they are formed? Rows are cut into
+        blocks and blocks made only of integrals dropped by the Schwarz sieve are not stored. !expert -*/
+        options.add_bool("PK_INCORE_SPARSE", false);
+        /*- With |scf__pk_incore_sparse|, blocks of the PK supermatrices whose integrals are all
+        smaller in magnitude than this value are stored in single precision. Zero keeps
+        everything in double precision. !expert -*/
+        options.add_double("PK_SINGLE_THRESHOLD", 0.0);
         /*- Max memory per buf for PK algo REORDER, for debug and tuning -*/
         options.add_int("MAX_MEM_BUF", 0);
         /*- Tolerance for Cholesky decomposition of the ERI tensor -*/
@@ -1521,6 +1541,37 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         /*- Bump function max radius -*/
         options.add_double("DF_BUMP_R1", 0.0);
 
+        /*- SUBSECTION DirectJK Algorithm -*/
+
+        /*- Do build J/K incrementally from the change in the density between SCF iterations with
+        |globals__scf_type| ``DIRECT``? Also enables density-weighted screening of shell quartets. -*/
+        options.add_bool("INCFOCK", false);
+        /*- Frequency with which a full J/K build is performed in place of an incremental one, to
+        bound the accumulation of screening errors. -*/
+        options.add_int("INCFOCK_FULL_FOCK_EVERY", 10);
+        /*- Do build K with the LinK algorithm for |globals__scf_type| ``DIRECT``? Shell pairs are
+        pre-sorted by their Schwarz bounds and the ket loops terminate early on density-weighted
+        bounds, so the cost of K grows nearly linearly for systems with a sizable gap. J is then
+        built from its own quartet list. Only pays off for large molecules. -*/
+        options.add_bool("LINK", false);
+        /*- Screening threshold on the density-weighted shell quartet bounds in LinK. Defaults to
+        |scf__ints_tolerance|. -*/
+        options.add_double("LINK_INTS_TOLERANCE", 1.0E-12);
+
+        /*- SUBSECTION COSX Algorithm -*/
+
+        /*- Number of radial points in the seminumerical exchange grid for |globals__scf_type| ``COSX``. -*/
+        options.add_int("COSX_RADIAL_POINTS", 25);
+        /*- Number of spherical points in the seminumerical exchange grid for |globals__scf_type| ``COSX``
+        (a Lebedev order). -*/
+        options.add_int("COSX_SPHERICAL_POINTS", 50);
+        /*- Screening threshold for the grid-point potential integrals and the exchange intermediates
+        in |globals__scf_type| ``COSX``. -*/
+        options.add_double("COSX_INTS_TOLERANCE", 1.0E-11);
+        /*- Do apply overlap fitting to the seminumerical exchange matrix to remove the bulk of the
+        grid error in |globals__scf_type| ``COSX``? -*/
+        options.add_bool("COSX_OVERLAP_FITTING", true);
+
         /*- SUBSECTION SAD Guess Algorithm -*/
 
         /*- The amount of SAD information to print to the output !expert -*/
@@ -1541,6 +1592,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("SAD_SPIN_AVERAGE", true);
         /*- SAD guess density decomposition threshold !expert -*/
         options.add_double("SAD_CHOL_TOLERANCE", 1E-7);
+        /*- Directory of an on-disk cache of SAD atomic densities, shared between calculations. Atomic
+        UHF results are keyed by element, occupations, atomic (and fitting) basis and the SAD options,
+        so repeated jobs with the same elements and basis read them instead of recomputing them.
+        The cache is disabled when empty. !expert -*/
+        options.add_str_i("SAD_CACHE_DIR", "");
 
         /*- SUBSECTION DFT -*/
 
@@ -1578,6 +1634,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DFT_BS_RADIUS_ALPHA", 1.0);
         /*- DFT basis cutoff. -*/
         options.add_double("DFT_BASIS_TOLERANCE", 1.0E-12);
+        /*- Storage of the basis function derivatives in the DFT collocation cache. ``SINGLE`` keeps them in single
+        precision and ``SPARSE`` drops the functions below |scf__dft_basis_tolerance| on a block, so that more blocks fit
+        in the same memory. Basis function values are always kept in full. !expert -*/
+        options.add_str("DFT_COLLOCATION_CACHE_STORAGE", "FULL", "FULL SINGLE SPARSE");
         /*- grid weight cutoff. Disable with -1.0. !expert -*/
         options.add_double("DFT_WEIGHTS_TOLERANCE", 1.0E-15);
         /*- density cutoff for LibXC. A negative value turns the feature off and LibXC defaults are used. !expert -*/
@@ -1614,6 +1674,9 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("DFT_VV10_RADIAL_POINTS", 50);
         /*- Rho cutoff for VV10 NL integration. !expert -*/
         options.add_double("DFT_VV10_RHO_CUTOFF", 1.e-8);
+        /*- Screening threshold on the bounded VV10 kernel between a block of grid points and a distant
+        tile of NL points. Tiles below the threshold are skipped. Set to 0 to disable. !expert -*/
+        options.add_double("DFT_VV10_KERNEL_CUTOFF", 1.e-14);
         /*- Define VV10 parameter b -*/
         options.add_double("DFT_VV10_B", 0.0);
         /*- Define VV10 parameter C -*/
@@ -2280,8 +2343,13 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         cache used by the libdpd codes. A value of ``LOW`` selects a "low priority"
         scheme in which the deletion of items from the cache is based on
         pre-programmed priorities. A value of LRU selects a "least recently used"
-        scheme in which the oldest item in the cache will be the first one deleted. -*/
-        options.add_str("CACHETYPE", "LOW", "LOW LRU");
+        scheme in which the oldest item in the cache will be the first one deleted.
+        A value of ``ADAPTIVE`` scores each item by its measured reload time and
+        access frequency and deletes the lowest-scoring item first; it also prints
+        per-buffer hit/miss statistics and writes an access trace
+        (``<prefix>.dpdtrace``) that seeds the scores of a subsequent run of the
+        same calculation. -*/
+        options.add_str("CACHETYPE", "LOW", "LOW LRU ADAPTIVE");
         /*- Number of threads -*/
         options.add_int("CC_NUM_THREADS", 1);
         /*- Do use DIIS extrapolation to accelerate convergence? -*/
@@ -3091,10 +3159,35 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
             The low memory algorithm is faster in general and has been turned
             on by default starting September 2020. -*/
         options.add_bool("TRIPLES_LOW_MEMORY", true);
+        /*- File in which the energy of each completed (T) task is recorded.
+            The method is appended to the name (``.ccsd``, ``.qcisd``, or
+            ``.mp4``). If the file already holds tasks from the same computation
+            (same dimensions, SCF energy, and correlation energy), those tasks
+            are skipped, so an interrupted (T) can be restarted. If empty, no
+            checkpoint is written. !expert -*/
+        options.add_str_i("TRIPLES_CHECKPOINT_FILE", "");
+        /*- Number of tasks into which the (T) loop is divided. The default
+            (0) uses 100 tasks per process. !expert -*/
+        options.add_int("TRIPLES_NTASKS", 0);
+        /*- Number of independent processes sharing the (T) correction through
+            TRIPLES_CHECKPOINT_FILE. Each process runs the full job up to (T),
+            computes its own tasks, and then takes over tasks not yet completed
+            by the others. !expert -*/
+        options.add_int("TRIPLES_NPROC", 1);
+        /*- Index (0 to TRIPLES_NPROC - 1) of this process among those sharing
+            the (T) correction. !expert -*/
+        options.add_int("TRIPLES_PROC", 0);
         /*- Do compute triples contribution? !expert -*/
         options.add_bool("COMPUTE_TRIPLES", true);
         /*- Do compute MP4 triples contribution? !expert -*/
         options.add_bool("COMPUTE_MP4_TRIPLES", false);
+        /*- The algorithm to use for the $(ac|bd)$ particle-particle ladder
+        in conventional QCISD/CCSD/CEPA. If AO_BASIS is ``NONE``, the sorted
+        MO-basis integrals are read from disk every iteration; if AO_BASIS is
+        ``DIRECT``, the amplitudes are back-transformed to the AO basis and
+        contracted with screened AO integrals computed on the fly, so the
+        $v^4$ integral file is never written. -*/
+        options.add_str("AO_BASIS", "NONE", "NONE DIRECT");
         /*- Do use MP2 NOs to truncate virtual space for QCISD/CCSD and (T)? -*/
         options.add_bool("NAT_ORBS", false);
         /*- Cutoff for occupation of MP2 virtual NOs in FNO-QCISD/CCSD(T).